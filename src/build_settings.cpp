@@ -10,6 +10,8 @@
 
 #define DEFAULT_MAX_ERROR_COLLECTOR_COUNT (36)
 #define DEFAULT_DID_YOU_MEAN_LIMIT (10)
+// NOTE: a rough upper bound of the memory a thread uses when generating an LLVM module
+#define THREAD_COUNT_AUTO_MEM_BYTES_PER_THREAD (1024ll*1024ll*1024ll)
 
 enum TargetOsKind : u16 {
 	TargetOs_Invalid,
@@ -528,6 +530,8 @@ struct BuildContext {
 	bool   show_unused;
 	bool   show_unused_with_location;
 	bool   show_more_timings;
+	bool   show_thread_pool_stats;
+	bool   show_memory;
 	bool   show_defineables;
 	String export_defineables_file;
 	bool   ignore_unused_defineables;
@@ -577,9 +581,15 @@ struct BuildContext {
 
 	bool   use_single_module;
 	bool   use_separate_modules;
+	bool   release_emitted_packages;
 	LTOKind lto_kind;
 	bool   module_per_file;
 	bool   cached;
+	bool   cached_content_hash;
+	bool   cached_objects;
+	bool   cached_packages;
+	bool   cached_ast;
+	bool   watch;
 	BuildCacheData build_cache_data;
 
 	bool internal_no_inline;
@@ -587,6 +597,9 @@ struct BuildContext {
 	bool internal_weak_monomorphization;
 	bool internal_ignore_llvm_verification;
 	bool internal_llvm_no_sroa;
+	bool internal_no_token_stream;
+	bool internal_defer_proc_bodies;
+	bool internal_no_file_prefetch;
 
 	bool   enable_rvo;
 
@@ -596,7 +609,7 @@ struct BuildContext {
 
 	int    did_you_mean_limit;
 
-	bool   copy_file_contents;
+	FileLoadMode file_load_mode;
 
 	bool   no_rtti;
 
@@ -631,6 +644,7 @@ struct BuildContext {
 
 	gbAffinity affinity;
 	isize      thread_count;
+	bool       thread_count_auto_mem; // caps `thread_count` by the available memory
 
 	PtrMap<char const *, ExactValue> defined_values;
 
@@ -1681,13 +1695,14 @@ gb_internal bool has_asm_extension(String const &path) {
 gb_internal char *token_pos_to_string(TokenPos const &pos) {
 	gbString s = gb_string_make_reserve(temporary_allocator(), 128);
 	String file = get_file_path_string(pos.file_id);
+	TokenLineColumn lc = token_pos_line_column(pos);
 	switch (build_context.ODIN_ERROR_POS_STYLE) {
 	default: /*fallthrough*/
 	case ErrorPosStyle_Default:
-		s = gb_string_append_fmt(s, "%.*s(%d:%d)", LIT(file), pos.line, pos.column);
+		s = gb_string_append_fmt(s, "%.*s(%d:%d)", LIT(file), lc.line, lc.column);
 		break;
 	case ErrorPosStyle_Unix:
-		s = gb_string_append_fmt(s, "%.*s:%d:%d:", LIT(file), pos.line, pos.column);
+		s = gb_string_append_fmt(s, "%.*s:%d:%d:", LIT(file), lc.line, lc.column);
 		break;
 	}
 	return s;
@@ -1742,12 +1757,224 @@ gb_internal void init_build_context_error_pos_style() {
 	}
 }
 
+#if defined(GB_SYSTEM_LINUX)
+#include <sched.h>
+
+gb_internal bool linux_read_first_line(char const *path, char *buf, int len) {
+	// NOTE: the files within /proc and /sys report a size of zero so they cannot be read with gb_file_read_contents
+	FILE *f = fopen(path, "r");
+	if (f == nullptr) {
+		return false;
+	}
+	bool ok = fgets(buf, len, f) != nullptr;
+	fclose(f);
+	return ok;
+}
+
+// NOTE: Returns the smallest value `read` gives for the cgroup of this process or any of its ancestors,
+// as the limits of an ancestor also apply; a negative value from `read` means no limit
+gb_internal i64 linux_cgroup_min(char const *v1_controller, i64 (*read)(char const *dir, bool is_v2)) {
+	FILE *f = fopen("/proc/self/cgroup", "r");
+	if (f == nullptr) {
+		return -1;
+	}
+
+	char root[64] = {};
+	char dir[1024] = {};
+	bool is_v2 = false;
+	char line[1024];
+	while (fgets(line, gb_size_of(line), f) != nullptr) {
+		// NOTE: each line is "hierarchy-id:controller-list:path", where cgroup v2 has an empty controller list
+		char *controllers = strchr(line, ':');
+		char *path = controllers ? strchr(controllers+1, ':') : nullptr;
+		if (path == nullptr) {
+			continue;
+		}
+		*controllers++ = 0;
+		*path++ = 0;
+		path[strcspn(path, "\n")] = 0;
+
+		bool match = false;
+		if (controllers[0] == 0) {
+			match = true;
+			is_v2 = true;
+			gb_snprintf(root, gb_size_of(root), "/sys/fs/cgroup");
+		} else {
+			for (char *c = controllers; c != nullptr; ) {
+				char *next = strchr(c, ',');
+				isize len = next ? next-c : gb_strlen(c);
+				if (len == gb_strlen(v1_controller) && gb_strncmp(c, v1_controller, len) == 0) {
+					match = true;
+					break;
+				}
+				c = next ? next+1 : nullptr;
+			}
+			if (match) {
+				is_v2 = false;
+				gb_snprintf(root, gb_size_of(root), "/sys/fs/cgroup/%s", v1_controller);
+			}
+		}
+		if (match) {
+			gb_snprintf(dir, gb_size_of(dir), "%s%s", root, path);
+			if (!is_v2) {
+				break; // NOTE: prefer the v1 controller on a hybrid system, as that is the one which applies
+			}
+		}
+	}
+	fclose(f);
+
+	if (dir[0] == 0) {
+		return -1;
+	}
+
+	// NOTE: without a cgroup namespace the path is that of the host, which is not mounted within a container,
+	// so the walk reaches the root of the hierarchy which is then the cgroup of the container
+	isize root_len = gb_strlen(root);
+	i64 result = -1;
+	for (;;) {
+		i64 value = read(dir, is_v2);
+		if (value >= 0 && (result < 0 || value < result)) {
+			result = value;
+		}
+		isize len = gb_strlen(dir);
+		if (len <= root_len) {
+			break;
+		}
+		while (len > root_len && dir[len-1] != '/') {
+			len--;
+		}
+		dir[gb_max(len-1, root_len)] = 0;
+	}
+	return result;
+}
+
+// NOTE: The number of CPUs the cgroup CPU quota allows for, or -1 when there is no quota
+gb_internal i64 linux_cgroup_cpu_limit(void) {
+	return linux_cgroup_min("cpu", [](char const *dir, bool is_v2) -> i64 {
+		char path[1100];
+		char line[128];
+		long long quota = -1;
+		long long period = 0;
+		if (is_v2) {
+			// NOTE: "$MAX $PERIOD", where $MAX is "max" without a quota
+			gb_snprintf(path, gb_size_of(path), "%s/cpu.max", dir);
+			if (!linux_read_first_line(path, line, gb_size_of(line)) || sscanf(line, "%lld %lld", &quota, &period) != 2) {
+				return -1;
+			}
+		} else {
+			gb_snprintf(path, gb_size_of(path), "%s/cpu.cfs_quota_us", dir);
+			if (!linux_read_first_line(path, line, gb_size_of(line)) || sscanf(line, "%lld", &quota) != 1) {
+				return -1;
+			}
+			gb_snprintf(path, gb_size_of(path), "%s/cpu.cfs_period_us", dir);
+			if (!linux_read_first_line(path, line, gb_size_of(line)) || sscanf(line, "%lld", &period) != 1) {
+				return -1;
+			}
+		}
+		if (quota <= 0 || period <= 0) {
+			return -1;
+		}
+		return gb_max(cast(i64)((quota + period - 1) / period), 1);
+	});
+}
+
+// NOTE: The memory which the cgroup memory limit still allows for, or -1 when there is no limit
+gb_internal i64 linux_cgroup_memory_available(void) {
+	return linux_cgroup_min("memory", [](char const *dir, bool is_v2) -> i64 {
+		char path[1100];
+		char line[128];
+		long long limit = -1;
+		long long usage = 0;
+		gb_snprintf(path, gb_size_of(path), "%s/%s", dir, is_v2 ? "memory.max" : "memory.limit_in_bytes");
+		if (!linux_read_first_line(path, line, gb_size_of(line)) || sscanf(line, "%lld", &limit) != 1) {
+			return -1; // NOTE: also "max" for cgroup v2
+		}
+		gb_snprintf(path, gb_size_of(path), "%s/%s", dir, is_v2 ? "memory.current" : "memory.usage_in_bytes");
+		if (linux_read_first_line(path, line, gb_size_of(line))) {
+			sscanf(line, "%lld", &usage);
+		}
+		return gb_max(cast(i64)(limit - usage), 0);
+	});
+}
+#endif
+
+// NOTE: The number of threads to use by default, which respects the CPU affinity mask and (on Linux) the cgroup
+// CPU quota, as the CPU count of a container is that of the host
+gb_internal isize default_thread_count(gbAffinity *affinity) {
+	isize count = affinity->thread_count;
+#if defined(GB_SYSTEM_LINUX)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	if (sched_getaffinity(0, gb_size_of(set), &set) == 0) {
+		isize allowed = CPU_COUNT(&set);
+		if (allowed > 0) {
+			count = gb_min(count, allowed);
+		}
+	}
+	i64 quota = linux_cgroup_cpu_limit();
+	if (quota > 0) {
+		count = gb_min(count, cast(isize)quota);
+	}
+#elif defined(GB_SYSTEM_WINDOWS)
+	DWORD_PTR process_mask = 0;
+	DWORD_PTR system_mask = 0;
+	if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask) && process_mask != 0) {
+		isize allowed = 0;
+		for (DWORD_PTR mask = process_mask; mask != 0; mask &= mask-1) {
+			allowed += 1;
+		}
+		// NOTE: the mask only covers the processor group of the process
+		if (allowed < count) {
+			count = allowed;
+		}
+	}
+#endif
+	return gb_max(count, 1);
+}
+
+// NOTE: The physical memory which is available for the compiler to use, or -1 when it is unknown
+gb_internal i64 available_memory_for_threads(void) {
+	i64 available = -1;
+#if defined(GB_SYSTEM_LINUX)
+	FILE *f = fopen("/proc/meminfo", "r");
+	if (f != nullptr) {
+		char line[256];
+		while (fgets(line, gb_size_of(line), f) != nullptr) {
+			long long kib = 0;
+			if (sscanf(line, "MemAvailable: %lld kB", &kib) == 1) {
+				available = cast(i64)kib * 1024;
+				break;
+			}
+		}
+		fclose(f);
+	}
+	i64 cgroup_available = linux_cgroup_memory_available();
+	if (cgroup_available >= 0 && (available < 0 || cgroup_available < available)) {
+		available = cgroup_available;
+	}
+#elif defined(GB_SYSTEM_WINDOWS)
+	MEMORYSTATUSEX status = {};
+	status.dwLength = gb_size_of(status);
+	if (GlobalMemoryStatusEx(&status)) {
+		available = cast(i64)status.ullAvailPhys;
+	}
+#endif
+	return available;
+}
+
 gb_internal void init_build_context(TargetMetrics *cross_target, Subtarget subtarget) {
 	BuildContext *bc = &build_context;
 
 	gb_affinity_init(&bc->affinity);
 	if (bc->thread_count == 0) {
-		bc->thread_count = gb_max(bc->affinity.thread_count, 1);
+		bc->thread_count = default_thread_count(&bc->affinity);
+	}
+	if (bc->thread_count_auto_mem) {
+		i64 available = available_memory_for_threads();
+		if (available >= 0) {
+			isize count = cast(isize)gb_max(available / THREAD_COUNT_AUTO_MEM_BYTES_PER_THREAD, 1);
+			bc->thread_count = gb_min(bc->thread_count, count);
+		}
 	}
 
 	bc->ODIN_VENDOR  = str_lit("odin");
@@ -1758,8 +1985,6 @@ gb_internal void init_build_context(TargetMetrics *cross_target, Subtarget subta
 		bc->max_error_count = DEFAULT_MAX_ERROR_COLLECTOR_COUNT;
 	}
 
-	bc->copy_file_contents = true;
-
 	TargetMetrics *metrics = nullptr;
 
 	#if defined(GB_ARCH_64_BIT)
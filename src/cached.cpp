@@ -121,6 +121,22 @@ gb_internal bool check_if_exists_directory_otherwise_create(String const &str) {
 	return false;
 #endif
 }
+
+// NOTE: The caches are kept next to the output, or within the working directory for a command without one
+// (e.g. `check`), rather than within the sources which may be read-only, under version control, or shared
+gb_internal String build_cache_base_dir(void) {
+	String dir = build_context.build_paths[BuildPath_Output].basename;
+	if (dir.len == 0) {
+		dir = get_working_directory(permanent_allocator());
+		if (dir.len == 0) {
+			return {};
+		}
+	}
+	dir = concatenate_strings(permanent_allocator(), dir, str_lit("/.odin-cache"));
+	(void)check_if_exists_directory_otherwise_create(dir);
+	return dir;
+}
+
 gb_internal bool try_copy_executable_cache_internal(bool to_cache) {
 	String exe_name = path_to_string(heap_allocator(), build_context.build_paths[BuildPath_Output]);
 	defer (gb_free(heap_allocator(), exe_name.text));
@@ -257,6 +273,37 @@ Array<String> cache_gather_envs() {
 	return envs;
 }
 
+struct CacheFileHash {
+	String path;
+	u64    hash;
+};
+
+gb_internal WORKER_TASK_PROC(cache_hash_file_worker_proc) {
+	CacheFileHash *fh = cast(CacheFileHash *)data;
+
+	char const *path_c = alloc_cstring(heap_allocator(), fh->path);
+	defer (gb_free(heap_allocator(), cast(void *)path_c));
+
+	gbFileContents fc = gb_file_read_contents(heap_allocator(), false, path_c);
+	defer (gb_file_free_contents(&fc));
+
+	fh->hash = gb_murmur64(fc.data, fc.size);
+	return 0;
+}
+
+// NOTE: Hashes the contents of every file rather than relying on the last write time,
+// which does not survive a fresh checkout or a `touch`
+gb_internal Array<CacheFileHash> cache_hash_files(Array<String> const &files) {
+	auto hashes = array_make<CacheFileHash>(heap_allocator(), files.count);
+	for_array(i, files) {
+		hashes[i].path = files[i];
+		hashes[i].hash = 0;
+		thread_pool_add_task(cache_hash_file_worker_proc, &hashes[i]);
+	}
+	thread_pool_wait();
+	return hashes;
+}
+
 // returns false if different, true if it is the same
 gb_internal bool try_cached_build(Checker *c, Array<String> const &args) {
 	TEMPORARY_ALLOCATOR_GUARD();
@@ -266,6 +313,11 @@ gb_internal bool try_cached_build(Checker *c, Array<String> const &args) {
 	defer (array_free(&envs));
 
 	u64 crc = 0;
+	if (build_context.cached_content_hash) {
+		// NOTE: keep the content hashed manifests separate from the timestamp based ones
+		String mode = str_lit("content-hash");
+		crc = crc64_with_seed(mode.text, mode.len, crc);
+	}
 	for (String const &path : files) {
 		crc = crc64_with_seed(path.text, path.len, crc);
 	}
@@ -318,6 +370,9 @@ gb_internal bool try_cached_build(Checker *c, Array<String> const &args) {
 
 		isize file_count = 0;
 
+		auto expected_hashes = array_make<u64>(heap_allocator(), 0, files.count);
+		defer (array_free(&expected_hashes));
+
 		for (; it.pos < data.len; file_count++) {
 			String line = string_split_iterator(&it, '\n');
 			if (line.len == 0) {
@@ -341,6 +396,11 @@ gb_internal bool try_cached_build(Checker *c, Array<String> const &args) {
 				return false;
 			}
 
+			if (build_context.cached_content_hash) {
+				array_add(&expected_hashes, u64_from_string(timestamp_str));
+				continue;
+			}
+
 			u64 timestamp = exact_value_to_u64(exact_value_integer_from_string(timestamp_str));
 			gbFileTime last_write_time = gb_file_last_write_time(alloc_cstring(temporary_allocator(), path_str));
 			if (last_write_time != timestamp) {
@@ -351,6 +411,18 @@ gb_internal bool try_cached_build(Checker *c, Array<String> const &args) {
 		if (file_count != files.count) {
 			return false;
 		}
+
+		if (build_context.cached_content_hash) {
+			auto hashes = cache_hash_files(files);
+			defer (array_free(&hashes));
+
+			for_array(i, hashes) {
+				if (hashes[i].hash != expected_hashes[i]) {
+					debugf("Cache: content hash changed for %.*s\n", LIT(hashes[i].path));
+					return false;
+				}
+			}
+		}
 	}
 	{
 		LoadedFile loaded_file = {};
@@ -383,6 +455,11 @@ gb_internal bool try_cached_build(Checker *c, Array<String> const &args) {
 				return false;
 			}
 		}
+
+		// NOTE: an argument added since the last build must also miss
+		if (args_count != args.count) {
+			return false;
+		}
 	}
 	{
 		LoadedFile loaded_file = {};
@@ -415,6 +492,10 @@ gb_internal bool try_cached_build(Checker *c, Array<String> const &args) {
 				return false;
 			}
 		}
+
+		if (env_count != envs.count) {
+			return false;
+		}
 	}
 
 	return try_copy_executable_from_cache();
@@ -436,9 +517,18 @@ void write_cached_build(Checker *c, Array<String> const &args) {
 		defer (gb_file_close(&f));
 		gb_file_open_mode(&f, gbFileMode_Write, path_c);
 
-		for (String const &path : files) {
-			gbFileTime ft = gb_file_last_write_time(alloc_cstring(temporary_allocator(), path));
-			gb_fprintf(&f, "%llu %.*s\n", cast(unsigned long long)ft, LIT(path));
+		if (build_context.cached_content_hash) {
+			auto hashes = cache_hash_files(files);
+			defer (array_free(&hashes));
+
+			for (CacheFileHash const &fh : hashes) {
+				gb_fprintf(&f, "0x%016llx %.*s\n", cast(unsigned long long)fh.hash, LIT(fh.path));
+			}
+		} else {
+			for (String const &path : files) {
+				gbFileTime ft = gb_file_last_write_time(alloc_cstring(temporary_allocator(), path));
+				gb_fprintf(&f, "%llu %.*s\n", cast(unsigned long long)ft, LIT(path));
+			}
 		}
 	}
 	{
@@ -472,3 +562,216 @@ void write_cached_build(Checker *c, Array<String> const &args) {
 	}
 }
 
+
+gb_internal String package_summary_dir(void) {
+	String dir = build_cache_base_dir();
+	if (dir.len == 0) {
+		return {};
+	}
+	dir = concatenate_strings(permanent_allocator(), dir, str_lit("/packages"));
+	(void)check_if_exists_directory_otherwise_create(dir);
+	return dir;
+}
+
+gb_internal String package_summary_path(String const &summary_dir, AstPackage *pkg) {
+	gbString name = gb_string_make_reserve(temporary_allocator(), 32);
+	name = gb_string_append_fmt(name, "/%016llx.summary", cast(unsigned long long)fnv64a(pkg->fullpath.text, pkg->fullpath.len));
+	return concatenate_strings(temporary_allocator(), summary_dir, make_string_c(name));
+}
+
+gb_global char const *PACKAGE_SUMMARY_HEADER = "odin-package-summary 2";
+
+// NOTE: Whilst set, the package summaries are kept in memory (keyed by the full path of the package) rather
+// than within `.odin-cache`, e.g. by the sessions of `odin server` which check the same packages repeatedly
+gb_global bool              package_summaries_in_memory;
+gb_global StringMap<String> package_summaries;
+
+// NOTE: Hashes the source of every package along with everything else which can change how it is
+// checked. Packages which use #load and friends depend on files outside of the package and are never cached.
+gb_internal void load_package_summaries(Checker *c, Array<String> const &args) {
+	TEMPORARY_ALLOCATOR_GUARD();
+	Parser *p = c->parser;
+
+	u64 options_hash = 0;
+	{
+		gbString s = gb_string_make(temporary_allocator(), "");
+		s = gb_string_append_fmt(s, "%.*s\n", LIT(ODIN_VERSION));
+	#ifdef GIT_SHA
+		s = gb_string_append_fmt(s, "%s\n", GIT_SHA);
+	#endif
+		for (String const &arg : args) {
+			s = gb_string_append_fmt(s, "%.*s\n", LIT(arg));
+		}
+		options_hash = gb_murmur64(s, gb_string_length(s));
+	}
+
+	auto files = array_make<String>(heap_allocator(), 0, p->packages.count);
+	defer (array_free(&files));
+	for (AstPackage *pkg : p->packages) {
+		for (AstFile *f : pkg->files) {
+			array_add(&files, f->fullpath);
+		}
+	}
+	auto hashes = cache_hash_files(files);
+	defer (array_free(&hashes));
+
+	String summary_dir = {};
+	if (!package_summaries_in_memory) {
+		summary_dir = package_summary_dir();
+	}
+
+	isize file_index = 0;
+	for (AstPackage *pkg : p->packages) {
+		// NOTE: the files are hashed in an order independent way as they are parsed in parallel
+		u64 source_hash = options_hash;
+		bool cacheable = pkg->kind != Package_Builtin;
+		for (AstFile *f : pkg->files) {
+			CacheFileHash const &fh = hashes[file_index++];
+			source_hash += gb_murmur64_seed(fh.path.text, fh.path.len, fh.hash);
+			if (f->seen_load_directive_count.load() != 0) {
+				cacheable = false;
+			}
+		}
+		if (!cacheable || source_hash == 0) {
+			continue;
+		}
+		pkg->summary_source_hash = source_hash;
+
+		String data = {};
+		if (package_summaries_in_memory) {
+			String *summary = string_map_get(&package_summaries, pkg->fullpath);
+			if (summary == nullptr) {
+				continue;
+			}
+			data = *summary;
+		} else {
+			if (summary_dir.len == 0) {
+				continue;
+			}
+			String path = package_summary_path(summary_dir, pkg);
+			LoadedFile loaded_file = {};
+			LoadedFileError file_err = load_file_32(alloc_cstring(temporary_allocator(), path), &loaded_file, true);
+			if (file_err != LoadedFile_None) {
+				continue;
+			}
+			data = {cast(u8 *)loaded_file.data, loaded_file.size};
+		}
+
+		String_Iterator it = {data, 0};
+
+		if (string_split_iterator(&it, '\n') != make_string_c(PACKAGE_SUMMARY_HEADER)) {
+			continue;
+		}
+		String source_line = string_split_iterator(&it, '\n');
+		if (!string_starts_with(source_line, str_lit("source ")) ||
+		    u64_from_string(substring(source_line, 7, source_line.len)) != source_hash) {
+			debugf("Package Summary: source changed for %.*s\n", LIT(pkg->fullpath));
+			continue;
+		}
+
+		auto deps = array_make<AstPackageSummaryDep>(heap_allocator(), 0, 16);
+		auto uses = array_make<String>(heap_allocator(), 0, 16);
+		bool ok = false;
+		while (it.pos < data.len) {
+			String line = string_split_iterator(&it, '\n');
+			if (string_starts_with(line, str_lit("interface "))) {
+				ok = true;
+				break;
+			}
+			if (string_starts_with(line, str_lit("uses "))) {
+				array_add(&uses, copy_string(permanent_allocator(), substring(line, 5, line.len)));
+				continue;
+			}
+			if (!string_starts_with(line, str_lit("dep "))) {
+				break;
+			}
+			line = substring(line, 4, line.len);
+			isize sep = string_index_byte(line, ' ');
+			if (sep < 0) {
+				break;
+			}
+			AstPackageSummaryDep dep = {};
+			dep.interface_hash = u64_from_string(substring(line, 0, sep));
+			dep.fullpath = copy_string(permanent_allocator(), substring(line, sep+1, line.len));
+			array_add(&deps, dep);
+		}
+		if (!ok) {
+			array_free(&deps);
+			array_free(&uses);
+			continue;
+		}
+
+		pkg->summary_cached_deps = deps;
+		pkg->summary_cached_uses = uses;
+		pkg->summary_loaded = true;
+	}
+}
+
+// NOTE: Only called once a check has completed without any errors or warnings
+gb_internal void write_package_summaries(Checker *c) {
+	TEMPORARY_ALLOCATOR_GUARD();
+	Parser *p = c->parser;
+
+	String summary_dir = {};
+	if (!package_summaries_in_memory) {
+		summary_dir = package_summary_dir();
+	}
+
+	for (AstPackage *pkg : p->packages) {
+		if (pkg->summary_source_hash == 0 || pkg->summary_valid) {
+			continue;
+		}
+		auto deps = check_package_summary_deps(c, pkg);
+		defer (array_free(&deps));
+
+		bool cacheable = true;
+		for (AstPackage *dep : deps) {
+			if (dep->summary_source_hash == 0) {
+				cacheable = false;
+				break;
+			}
+		}
+		if (!cacheable) {
+			continue;
+		}
+
+		gbString s = gb_string_make_reserve(heap_allocator(), 256 + pkg->summary_interface.len);
+		defer (gb_string_free(s));
+		s = gb_string_append_fmt(s, "%s\n", PACKAGE_SUMMARY_HEADER);
+		s = gb_string_append_fmt(s, "source 0x%016llx\n", cast(unsigned long long)pkg->summary_source_hash);
+		for (AstPackage *dep : deps) {
+			s = gb_string_append_fmt(s, "dep 0x%016llx %.*s\n", cast(unsigned long long)dep->summary_interface_hash, LIT(dep->fullpath));
+		}
+		if (!check_package_summary_uses(&s, pkg, deps)) {
+			continue;
+		}
+		s = gb_string_append_fmt(s, "interface 0x%016llx\n", cast(unsigned long long)pkg->summary_interface_hash);
+		s = gb_string_append_length(s, pkg->summary_interface.text, pkg->summary_interface.len);
+
+		if (package_summaries_in_memory) {
+			debugf("Package Summary: keeping %.*s\n", LIT(pkg->fullpath));
+			String *prev = string_map_get(&package_summaries, pkg->fullpath);
+			if (prev != nullptr) {
+				gb_free(heap_allocator(), prev->text);
+			}
+			string_map_set(&package_summaries, pkg->fullpath, copy_string(heap_allocator(), make_string(cast(u8 *)s, gb_string_length(s))));
+			continue;
+		}
+
+		if (summary_dir.len == 0) {
+			continue;
+		}
+		String path = package_summary_path(summary_dir, pkg);
+		char const *path_c = alloc_cstring(temporary_allocator(), path);
+		gb_file_remove(path_c);
+
+		debugf("Package Summary: updating %s\n", path_c);
+
+		gbFile f = {};
+		if (gb_file_open_mode(&f, gbFileMode_Write, path_c) != gbFileError_None) {
+			continue;
+		}
+		defer (gb_file_close(&f));
+		gb_file_write(&f, s, gb_string_length(s));
+	}
+}
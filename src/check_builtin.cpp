@@ -256,7 +256,7 @@ void add_objc_proc_type(CheckerContext *c, Ast *call, Type *return_type, Slice<T
 	try_to_add_package_dependency(c, "runtime", "objc_msgSend_stret");
 
 	Slice<Ast *> args = call->CallExpr.args;
-	if (args.count > 0 && args[0]->tav.objc_super_target) {
+	if (args.count > 0 && args[0]->tav().objc_super_target) {
 		try_to_add_package_dependency(c, "runtime", "objc_msgSendSuper2");
 		try_to_add_package_dependency(c, "runtime", "objc_msgSendSuper2_stret");
 	}
@@ -720,7 +720,7 @@ gb_internal bool check_builtin_objc_procedure(CheckerContext *c, Operand *operan
 
 		// NOTE(harold) Track original type before transforming it to the superclass.
 		//              This is needed because objc_msgSendSuper2 must start its search on the subclass, not the superclass.
-		call->tav.objc_super_target = obj_type;
+		call->tav_mut().objc_super_target = obj_type;
 
 		// The superclass type must be known at compile time. We require this so that the selector method expressions
 		// methods are resolved to the superclass's methods instead of the subclass's.
@@ -2068,13 +2068,14 @@ gb_internal bool cache_load_file_directive(CheckerContext *c, Ast *call, String
 				// Nothing to do.
 				break;
 			case LoadFileTier_Contents: {
-				isize file_size = cast(isize)gb_file_size(&f);
-				if (file_size > 0) {
-					u8 *ptr = permanent_alloc_array<u8>(file_size+1);
-					gb_file_read_at(&f, ptr, file_size, 0);
-					ptr[file_size] = '\0';
-					data.text = ptr;
-					data.len = file_size;
+				// NOTE: unlike the sources, the `#load`-ed files are not limited to 2 GiB
+				LoadedFile loaded_file = {};
+				LoadedFileError load_err = load_file(c_str, &loaded_file, build_context.file_load_mode, I64_MAX);
+				if (load_err == LoadedFile_None) {
+					data.text = cast(u8 *)loaded_file.data;
+					data.len  = loaded_file.size;
+				} else if (load_err != LoadedFile_Empty) {
+					file_error = gbFileError_Invalid;
 				}
 				break;
 			}
@@ -5385,7 +5386,7 @@ gb_internal bool check_builtin_procedure(CheckerContext *c, Operand *operand, As
 		isize count_needed = 0;
 
 		for (Ast *arg : ce->args) {
-			ExactValue value = arg->tav.value;
+			ExactValue value = arg->tav().value;
 			GB_ASSERT(value.kind == ExactValue_Compound);
 			ast_node(cl, CompoundLit, value.value_compound);
 			count_needed += cl->elems.count;
@@ -5395,7 +5396,7 @@ gb_internal bool check_builtin_procedure(CheckerContext *c, Operand *operand, As
 		array_init(&new_elems, permanent_allocator(), 0, count_needed);
 
 		for (Ast *arg : ce->args) {
-			ExactValue value = arg->tav.value;
+			ExactValue value = arg->tav().value;
 			GB_ASSERT(value.kind == ExactValue_Compound);
 			ast_node(cl, CompoundLit, value.value_compound);
 			array_add_elems(&new_elems, cl->elems.data, cl->elems.count);
@@ -8290,7 +8291,7 @@ gb_internal bool check_builtin_procedure(CheckerContext *c, Operand *operand, As
 				return false;
 			}
 
-			TypeAndValue tav = proc->tav;
+			TypeAndValue tav = proc->tav();
 
 
 			operand->type       = e->type;
@@ -256,10 +256,10 @@ gb_internal bool check_try_override_const_decl(CheckerContext *ctx, Entity *e, E
 			if (we->cond == nullptr) {
 				return false;
 			}
-			if (we->cond->tav.value.kind != ExactValue_Bool) {
+			if (we->cond->tav().value.kind != ExactValue_Bool) {
 				return false;
 			}
-			init = we->cond->tav.value.value_bool ? we->x : we->y;
+			init = we->cond->tav().value.value_bool ? we->x : we->y;
 			goto retry_proc_lit;
 		} if (init->kind == Ast_ProcLit) {
 			// NOTE(bill, 2024-07-04): Override as a procedure entity because this could be within a `when` statement
@@ -1819,7 +1819,7 @@ gb_internal void check_global_variable_decl(CheckerContext *ctx, Entity *e, Ast
 				elem = unparen_expr(elem);
 
 				Entity *e = entity_of_node(elem);
-				if (elem->tav.mode != Addressing_Constant && e == nullptr && elem->kind != Ast_ProcLit) {
+				if (elem->tav().mode != Addressing_Constant && e == nullptr && elem->kind != Ast_ProcLit) {
 					Token tok = ast_token(elem);
 					TokenPos pos = tok.pos;
 					gbString s = type_to_string(type_of_expr(elem));
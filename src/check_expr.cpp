@@ -372,6 +372,65 @@ gb_internal void check_scope_decls(CheckerContext *c, Slice<Ast *> const &nodes,
 	}
 }
 
+// NOTE: Lock-free; the structural comparison is only done for the instantiations with the same hash
+gb_internal Entity *gen_procs_find(GenProcsData *gen_procs, Type *proc_type, u64 hash) {
+	GenProcsTable *table = gen_procs->table.load(std::memory_order_acquire);
+	if (table == nullptr) {
+		return nullptr;
+	}
+	isize mask = table->capacity-1;
+	for (isize i = cast(isize)(hash & cast(u64)mask); /**/; i = (i+1) & mask) {
+		Entity *other = table->procs[i].load(std::memory_order_acquire);
+		if (other == nullptr) {
+			return nullptr;
+		}
+		if (table->hashes[i].load(std::memory_order_relaxed) == hash &&
+		    are_types_identical(base_type(other->type), proc_type)) {
+			return other;
+		}
+	}
+}
+
+gb_internal void gen_procs_table_insert(GenProcsTable *table, Entity *entity, u64 hash) {
+	isize mask = table->capacity-1;
+	isize i = cast(isize)(hash & cast(u64)mask);
+	while (table->procs[i].load(std::memory_order_relaxed) != nullptr) {
+		i = (i+1) & mask;
+	}
+	table->hashes[i].store(hash, std::memory_order_relaxed);
+	table->procs[i].store(entity, std::memory_order_release);
+}
+
+// NOTE: The caller must hold `gen_procs->mutex` exclusively
+gb_internal void gen_procs_add(GenProcsData *gen_procs, Entity *entity, u64 hash) {
+	array_add(&gen_procs->procs, entity);
+
+	GenProcsTable *table = gen_procs->table.load(std::memory_order_relaxed);
+	if (table == nullptr || gen_procs->procs.count*2 > table->capacity) {
+		// NOTE: the previous table is never freed, as it may still be being searched
+		GenProcsTable *new_table = permanent_alloc_item<GenProcsTable>();
+		new_table->capacity = table ? table->capacity*2 : 16;
+		new_table->hashes = permanent_alloc_array<std::atomic<u64>>(new_table->capacity);
+		new_table->procs  = permanent_alloc_array<std::atomic<Entity *>>(new_table->capacity);
+		for (isize i = 0; i < new_table->capacity; i++) {
+			new_table->hashes[i].store(0, std::memory_order_relaxed);
+			new_table->procs[i].store(nullptr, std::memory_order_relaxed);
+		}
+		if (table != nullptr) {
+			for (isize i = 0; i < table->capacity; i++) {
+				Entity *other = table->procs[i].load(std::memory_order_relaxed);
+				if (other != nullptr) {
+					gen_procs_table_insert(new_table, other, table->hashes[i].load(std::memory_order_relaxed));
+				}
+			}
+		}
+		gen_procs_table_insert(new_table, entity, hash);
+		gen_procs->table.store(new_table, std::memory_order_release);
+		return;
+	}
+	gen_procs_table_insert(table, entity, hash);
+}
+
 gb_internal bool find_or_generate_polymorphic_procedure(CheckerContext *old_c, Entity *base_entity, Type *type,
                                                         Array<Operand> const *param_operands, Ast *poly_def_node, PolyProcData *poly_proc_data) {
 	///////////////////////////////////////////////////////////////////////////////
@@ -481,23 +540,15 @@ gb_internal bool find_or_generate_polymorphic_procedure(CheckerContext *old_c, E
 	mutex_lock(&base_entity->Procedure.gen_procs_mutex); // @entity-mutex
 	gen_procs = base_entity->Procedure.gen_procs;
 	if (gen_procs) {
-		rw_mutex_shared_lock(&gen_procs->mutex); // @local-mutex
-
 		mutex_unlock(&base_entity->Procedure.gen_procs_mutex); // @entity-mutex
 
-		for (Entity *other : gen_procs->procs) {
-			Type *pt = base_type(other->type);
-			if (are_types_identical(pt, final_proc_type)) {
-				rw_mutex_shared_unlock(&gen_procs->mutex); // @local-mutex
-
-				if (poly_proc_data) {
-					poly_proc_data->gen_entity = other;
-				}
-				return true;
+		Entity *other = gen_procs_find(gen_procs, final_proc_type, type_hash_canonical_type_uncached(final_proc_type));
+		if (other != nullptr) {
+			if (poly_proc_data) {
+				poly_proc_data->gen_entity = other;
 			}
+			return true;
 		}
-
-		rw_mutex_shared_unlock(&gen_procs->mutex); // @local-mutex
 	} else {
 		gen_procs = permanent_alloc_item<GenProcsData>();
 		gen_procs->procs.allocator = heap_allocator();
@@ -506,6 +557,8 @@ gb_internal bool find_or_generate_polymorphic_procedure(CheckerContext *old_c, E
 	}
 
 
+	// NOTE: hashed before the properties below are copied over, as is every later type to be looked up
+	u64 proc_type_hash = 0;
 	{
 		// LEAK NOTE(bill): This is technically a memory leak as it has to generate the type twice
 		bool prev_no_polymorphic_errors = nctx.no_polymorphic_errors;
@@ -524,35 +577,31 @@ gb_internal bool find_or_generate_polymorphic_procedure(CheckerContext *old_c, E
 			return false;
 		}
 
-		rw_mutex_shared_lock(&gen_procs->mutex); // @local-mutex
-		for (Entity *other : gen_procs->procs) {
-			Type *pt = base_type(other->type);
-			if (are_types_identical(pt, final_proc_type)) {
-				rw_mutex_shared_unlock(&gen_procs->mutex); // @local-mutex
-
-				if (poly_proc_data) {
-					poly_proc_data->gen_entity = other;
-				}
-
-				DeclInfo *decl = other->decl_info;
-				if (decl->proc_checked_state != ProcCheckedState_Checked) {
-					ProcInfo *proc_info = permanent_alloc_item<ProcInfo>();
-					proc_info->file  = other->file;
-					proc_info->token = other->token;
-					proc_info->decl  = decl;
-					proc_info->type  = other->type;
-					proc_info->body  = decl->proc_lit->ProcLit.body;
-					proc_info->tags  = other->Procedure.tags;;
-					proc_info->generated_from_polymorphic = true;
-					proc_info->poly_def_node = poly_def_node;
+		// NOTE: the type has been checked again in place, so it is hashed again
+		proc_type_hash = type_hash_canonical_type_uncached(final_proc_type);
+		Entity *other = gen_procs_find(gen_procs, final_proc_type, proc_type_hash);
+		if (other != nullptr) {
+			if (poly_proc_data) {
+				poly_proc_data->gen_entity = other;
+			}
 
-					check_procedure_later(nctx.checker, proc_info);
-				}
+			DeclInfo *decl = other->decl_info;
+			if (decl->proc_checked_state != ProcCheckedState_Checked) {
+				ProcInfo *proc_info = permanent_alloc_item<ProcInfo>();
+				proc_info->file  = other->file;
+				proc_info->token = other->token;
+				proc_info->decl  = decl;
+				proc_info->type  = other->type;
+				proc_info->body  = decl->proc_lit->ProcLit.body;
+				proc_info->tags  = other->Procedure.tags;;
+				proc_info->generated_from_polymorphic = true;
+				proc_info->poly_def_node = poly_def_node;
 
-				return true;
+				check_procedure_later(nctx.checker, proc_info);
 			}
+
+			return true;
 		}
-		rw_mutex_shared_unlock(&gen_procs->mutex); // @local-mutex
 	}
 
 
@@ -627,7 +676,7 @@ gb_internal bool find_or_generate_polymorphic_procedure(CheckerContext *old_c, E
 	}
 
 	rw_mutex_lock(&gen_procs->mutex); // @local-mutex
-		array_add(&gen_procs->procs, entity);
+		gen_procs_add(gen_procs, entity, proc_type_hash);
 	rw_mutex_unlock(&gen_procs->mutex); // @local-mutex
 
 	ProcInfo *proc_info = permanent_alloc_item<ProcInfo>();
@@ -2803,7 +2852,7 @@ gb_internal bool check_is_not_addressable(CheckerContext *c, Operand *o) {
 			return true;
 		}
 		ast_node(ta, TypeAssertion, expr);
-		TypeAndValue tv = ta->expr->tav;
+		TypeAndValue tv = ta->expr->tav();
 		if (is_type_pointer(tv.type)) {
 			return false;
 		}
@@ -4814,9 +4863,9 @@ gb_internal Operand make_operand_from_node(Ast *node) {
 	GB_ASSERT(node != nullptr);
 	Operand x = {};
 	x.expr  = node;
-	x.mode  = node->tav.mode;
-	x.type  = node->tav.type;
-	x.value = node->tav.value;
+	x.mode  = node->tav().mode;
+	x.type  = node->tav().type;
+	x.value = node->tav().value;
 	return x;
 }
 
@@ -4826,8 +4875,8 @@ gb_internal void update_untyped_expr_type(CheckerContext *c, Ast *e, Type *type,
 	ExprInfo *old = check_get_expr_info(c, e);
 	if (old == nullptr) {
 		if (type != nullptr && type != t_invalid) {
-			if (e->tav.type == nullptr || e->tav.type == t_invalid) {
-				add_type_and_value(c, e, e->tav.mode, type ? type : e->tav.type, e->tav.value);
+			if (e->tav().type == nullptr || e->tav().type == t_invalid) {
+				add_type_and_value(c, e, e->tav().mode, type ? type : e->tav().type, e->tav().value);
 				if (e->kind == Ast_TernaryIfExpr) {
 					update_untyped_expr_type(c, e->TernaryIfExpr.x, type, final);
 					update_untyped_expr_type(c, e->TernaryIfExpr.y, type, final);
@@ -5483,11 +5532,11 @@ gb_internal ExactValue get_constant_field_single(CheckerContext *c, ExactValue v
 		}
 
 		if (cl->elems[0]->kind == Ast_FieldValue) {
-			if (is_type_raw_union(node->tav.type)) {
+			if (is_type_raw_union(node->tav().type)) {
 				if (success_) *success_ = false;
 				if (finish_) *finish_ = true;
 				return empty_exact_value;
-			} else if (is_type_struct(node->tav.type)) {
+			} else if (is_type_struct(node->tav().type)) {
 				bool found = false;
 				for (Ast *elem : cl->elems) {
 					if (elem->kind != Ast_FieldValue) {
@@ -5495,10 +5544,10 @@ gb_internal ExactValue get_constant_field_single(CheckerContext *c, ExactValue v
 					}
 					ast_node(fv, FieldValue, elem);
 					auto name = fv->field->Ident.interned;
-					Selection sub_sel = lookup_field(node->tav.type, name, false);
+					Selection sub_sel = lookup_field(node->tav().type, name, false);
 					if (sub_sel.index.count > 0 &&
 					    sub_sel.index[0] == index) {
-						value = fv->value->tav.value;
+						value = fv->value->tav().value;
 						found = true;
 						break;
 					}
@@ -5507,7 +5556,7 @@ gb_internal ExactValue get_constant_field_single(CheckerContext *c, ExactValue v
 					// Use the zero value if it is not found
 					value = {};
 				}
-			} else if (is_type_array(node->tav.type) || is_type_enumerated_array(node->tav.type)) {
+			} else if (is_type_array(node->tav().type) || is_type_enumerated_array(node->tav().type)) {
 				for (Ast *elem : cl->elems) {
 					if (elem->kind != Ast_FieldValue) {
 						continue;
@@ -5515,8 +5564,8 @@ gb_internal ExactValue get_constant_field_single(CheckerContext *c, ExactValue v
 					ast_node(fv, FieldValue, elem);
 					if (is_ast_range(fv->field)) {
 						ast_node(ie, BinaryExpr, fv->field);
-						TypeAndValue lo_tav = ie->left->tav;
-						TypeAndValue hi_tav = ie->right->tav;
+						TypeAndValue lo_tav = ie->left->tav();
+						TypeAndValue hi_tav = ie->right->tav();
 						GB_ASSERT(lo_tav.mode == Addressing_Constant);
 						GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -5526,28 +5575,28 @@ gb_internal ExactValue get_constant_field_single(CheckerContext *c, ExactValue v
 
 						i64 corrected_index = index;
 
-						if (is_type_enumerated_array(node->tav.type)) {
-							Type *bt = base_type(node->tav.type);
+						if (is_type_enumerated_array(node->tav().type)) {
+							Type *bt = base_type(node->tav().type);
 							GB_ASSERT(bt->kind == Type_EnumeratedArray);
 							corrected_index = index + exact_value_to_i64(*bt->EnumeratedArray.min_value);
 						}
 						if (op != Token_RangeHalf) {
 							if (lo <= corrected_index && corrected_index <= hi) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = fv->value->tav();
 								if (success_) *success_ = true;
 								if (finish_) *finish_ = false;
 								return tav.value;
 							}
 						} else {
 							if (lo <= corrected_index && corrected_index < hi) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = fv->value->tav();
 								if (success_) *success_ = true;
 								if (finish_) *finish_ = false;
 								return tav.value;
 							}
 						}
 					} else {
-						TypeAndValue index_tav = fv->field->tav;
+						TypeAndValue index_tav = fv->field->tav();
 						if (index_tav.mode != Addressing_Constant) {
 							if (success_) *success_ = false;
 							if (finish_) *finish_ = true;
@@ -5555,15 +5604,15 @@ gb_internal ExactValue get_constant_field_single(CheckerContext *c, ExactValue v
 						}
 						GB_ASSERT(index_tav.mode == Addressing_Constant);
 						ExactValue index_value = index_tav.value;
-						if (is_type_enumerated_array(node->tav.type)) {
-							Type *bt = base_type(node->tav.type);
+						if (is_type_enumerated_array(node->tav().type)) {
+							Type *bt = base_type(node->tav().type);
 							GB_ASSERT(bt->kind == Type_EnumeratedArray);
 							index_value = exact_value_sub(index_value, *bt->EnumeratedArray.min_value);
 						}
 
 						i64 field_index = exact_value_to_i64(index_value);
 						if (index == field_index) {
-							TypeAndValue tav = fv->value->tav;
+							TypeAndValue tav = fv->value->tav();
 							if (success_) *success_ = true;
 							if (finish_) *finish_ = false;
 							return tav.value;
@@ -5585,7 +5634,7 @@ gb_internal ExactValue get_constant_field_single(CheckerContext *c, ExactValue v
 				return value;
 			}
 
-			TypeAndValue tav = cl->elems[index]->tav;
+			TypeAndValue tav = cl->elems[index]->tav();
 			if (tav.mode == Addressing_Constant) {
 				if (success_) *success_ = true;
 				if (finish_) *finish_ = false;
@@ -5751,13 +5800,13 @@ gb_internal Entity *check_entity_from_ident_or_selector(CheckerContext *c, Ast *
 		if (we->cond == nullptr) {
 			return nullptr;
 		}
-		if (we->cond->tav.mode != Addressing_Constant) {
+		if (we->cond->tav().mode != Addressing_Constant) {
 			return nullptr;
 		}
-		if (we->cond->tav.value.kind != ExactValue_Bool) {
+		if (we->cond->tav().value.kind != ExactValue_Bool) {
 			return nullptr;
 		}
-		if (we->cond->tav.value.value_bool) {
+		if (we->cond->tav().value.value_bool) {
 			return check_entity_from_ident_or_selector(c, we->x, ident_only);
 		} else {
 			Entity *e = check_entity_from_ident_or_selector(c, we->y, ident_only);
@@ -6633,7 +6682,7 @@ gb_internal CallArgumentError check_call_arguments_internal(CheckerContext *c, A
 	isize param_count = 0;
 	isize param_count_excluding_defaults = get_procedure_param_count_excluding_defaults(proc_type, &param_count);
 	bool variadic = pt->variadic;
-	bool vari_expand = (ce->ellipsis.pos.line != 0);
+	bool vari_expand = token_pos_is_valid(ce->ellipsis.pos);
 	i64 score = 0;
 	bool show_error = show_error_mode == CallArgumentErrorMode::ShowErrors;
 
@@ -7029,8 +7078,8 @@ gb_internal CallArgumentError check_call_arguments_internal(CheckerContext *c, A
 
 
 		Ast *proc_lit = nullptr;
-		if (ce->proc->tav.value.kind == ExactValue_Procedure) {
-			Ast *vp = unparen_expr(ce->proc->tav.value.value_procedure);
+		if (ce->proc->tav().value.kind == ExactValue_Procedure) {
+			Ast *vp = unparen_expr(ce->proc->tav().value.value_procedure);
 			if (vp && vp->kind == Ast_ProcLit) {
 				proc_lit = vp;
 			}
@@ -8188,7 +8237,7 @@ gb_internal CallArgumentError check_polymorphic_record_type(CheckerContext *c, O
 				check_expr_or_type(c, &operands[i], fv->value);
 			}
 
-			bool vari_expand = (ce->ellipsis.pos.line != 0);
+			bool vari_expand = token_pos_is_valid(ce->ellipsis.pos);
 			if (vari_expand) {
 				error(ce->ellipsis, "Invalid use of '..' in a polymorphic type call'");
 			}
@@ -8672,9 +8721,9 @@ gb_internal void check_objc_call_expr(CheckerContext *c, Operand *operand, Ast *
 				ast_node(se, SelectorExpr, ce->proc);
 
 				// NOTE(harold): These should have already been checked, right?
-				GB_ASSERT(se->expr->tav.mode == Addressing_Type && se->expr->tav.type->kind == Type_Named);
+				GB_ASSERT(se->expr->tav().mode == Addressing_Type && se->expr->tav().type->kind == Type_Named);
 
-				return_type = alloc_type_pointer(se->expr->tav.type);
+				return_type = alloc_type_pointer(se->expr->tav().type);
 			} else {
 				return_type = proc_entity->Procedure.objc_class->type;
 			}
@@ -8686,17 +8735,17 @@ gb_internal void check_objc_call_expr(CheckerContext *c, Operand *operand, Ast *
 		GB_ASSERT(ce->args.count > 0);
 		GB_ASSERT(is_type_objc_ptr_to_object(params[0]->type));
 
-		if (ce->args[0]->tav.objc_super_target) {
+		if (ce->args[0]->tav().objc_super_target) {
 			self_type = t_objc_super_ptr;
 		} else {
-			self_type = ce->args[0]->tav.type;
+			self_type = ce->args[0]->tav().type;
 		}
 
 		if (is_return_instancetype) {
 			// NOTE(harold): These should have already been checked, right?
-			GB_ASSERT(ce->args[0]->tav.type && ce->args[0]->tav.type->kind == Type_Pointer && ce->args[0]->tav.type->Pointer.elem->kind == Type_Named);
+			GB_ASSERT(ce->args[0]->tav().type && ce->args[0]->tav().type->kind == Type_Pointer && ce->args[0]->tav().type->Pointer.elem->kind == Type_Named);
 
-			return_type = ce->args[0]->tav.type;
+			return_type = ce->args[0]->tav().type;
 		}
 	}
 
@@ -9513,7 +9562,7 @@ gb_internal void check_matrix_index_expr(CheckerContext *c, Operand *o, Ast *nod
 	i64 column_index = 0;
 	bool row_ok = check_index_value(c, t, false, ie->row_index, row_count, &row_index, nullptr);
 	bool column_ok = check_index_value(c, t, false, ie->column_index, column_count, &column_index, nullptr);
-	if (is_const && (ie->row_index->tav.mode != Addressing_Constant || ie->column_index->tav.mode != Addressing_Constant)) {
+	if (is_const && (ie->row_index->tav().mode != Addressing_Constant || ie->column_index->tav().mode != Addressing_Constant)) {
 		error(o->expr, "Cannot index constant matrix with non-constant indices '%s'", expr_to_string(node));
 	}
 
@@ -9689,7 +9738,7 @@ gb_internal ExprKind check_basic_directive_expr(CheckerContext *c, Operand *o, A
 		o->type = t_untyped_string;
 		o->value = exact_value_string(path);
 	} else if (name == "line") {
-		i32 line = bd->token.pos.line;
+		i32 line = token_pos_line_column(bd->token.pos).line;
 		switch (build_context.source_code_location_info) {
 		case SourceCodeLocationInfo_Normal:
 			break;
@@ -11510,7 +11559,7 @@ gb_internal ExprKind check_compound_literal(CheckerContext *c, Operand *o, Ast *
 			for (Ast *e : cl->elems) {
 				GB_ASSERT(e->kind != Ast_FieldValue);
 
-				TypeAndValue tav = e->tav;
+				TypeAndValue tav = e->tav();
 				if (tav.mode != Addressing_Constant) {
 					continue;
 				}
@@ -11724,9 +11773,9 @@ gb_internal ExprKind check_selector_call_expr(CheckerContext *c, Operand *o, Ast
 	if (se->modified_call) {
 		// Prevent double evaluation
 		o->expr  = node;
-		o->type  = node->tav.type;
-		o->value = node->tav.value;
-		o->mode  = node->tav.mode;
+		o->type  = node->tav().type;
+		o->value = node->tav().value;
+		o->mode  = node->tav().mode;
 		return Expr_Expr;
 	}
 
@@ -11789,9 +11838,9 @@ gb_internal ExprKind check_selector_call_expr(CheckerContext *c, Operand *o, Ast
 		}
 
 		Operand y = {};
-		y.mode = first_arg->tav.mode;
-		y.type = first_arg->tav.type;
-		y.value = first_arg->tav.value;
+		y.mode = first_arg->tav().mode;
+		y.type = first_arg->tav().type;
+		y.value = first_arg->tav().value;
 
 		if (check_is_assignable_to(c, &y, first_type)) {
 			// Do nothing, it's valid
@@ -12302,7 +12351,7 @@ gb_internal ExprKind check_expr_base_internal(CheckerContext *c, Operand *o, Ast
 
 	case_ast_node(bl, BasicLit, node);
 		Type *t = t_invalid;
-		switch (node->tav.value.kind) {
+		switch (node->tav().value.kind) {
 		case ExactValue_String:     t = t_untyped_string;     break;
 		case ExactValue_String16:   t = t_string16;           break; // TODO(bill): determine this correctly
 		case ExactValue_Float:      t = t_untyped_float;      break;
@@ -12321,7 +12370,7 @@ gb_internal ExprKind check_expr_base_internal(CheckerContext *c, Operand *o, Ast
 
 		o->mode  = Addressing_Constant;
 		o->type  = t;
-		o->value = node->tav.value;
+		o->value = node->tav().value;
 	case_end;
 
 	case_ast_node(bd, BasicDirective, node);
@@ -12788,10 +12837,10 @@ gb_internal bool is_exact_value_zero(ExactValue const &v) {
 				return true;
 			} else {
 				for (Ast *elem : cl->elems) {
-					if (elem->tav.mode != Addressing_Constant) {
+					if (elem->tav().mode != Addressing_Constant) {
 						return false;
 					}
-					if (!is_exact_value_zero(elem->tav.value)) {
+					if (!is_exact_value_zero(elem->tav().value)) {
 						return false;
 					}
 				}
@@ -12822,7 +12871,7 @@ gb_internal bool compare_exact_values_compound_lit(TokenKind op, ExactValue x, E
 	for (isize i = 0; i < x_cl->elems.count; i++) {
 		Ast *lhs = x_cl->elems[i];
 		Ast *rhs = y_cl->elems[i];
-		if (compare_exact_values(op, lhs->tav.value, rhs->tav.value) != test) {
+		if (compare_exact_values(op, lhs->tav().value, rhs->tav().value) != test) {
 			return !test;
 		}
 	}
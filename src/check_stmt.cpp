@@ -8,7 +8,7 @@ gb_internal bool is_diverging_expr(Ast *expr) {
 		return name == "panic";
 	}
 	Ast *proc = unparen_expr(expr->CallExpr.proc);
-	TypeAndValue tv = proc->tav;
+	TypeAndValue tv = proc->tav();
 	if (tv.mode == Addressing_Builtin) {
 		Entity *e = entity_of_node(proc);
 		BuiltinProcId id = BuiltinProc_Invalid;
@@ -339,7 +339,7 @@ gb_internal bool check_is_terminating(Ast *node, String const &label) {
 
 	case_ast_node(ws, WhenStmt, node);
 		// TODO(bill): Is this logic correct for when statements?
-		auto const &tv = ws->cond->tav;
+		auto const &tv = ws->cond->tav();
 		if (tv.mode != Addressing_Constant) {
 			// NOTE(bill): Check the things regardless as a bug occurred earlier
 			if (ws->else_stmt != nullptr) {
@@ -531,7 +531,7 @@ gb_internal Type *check_assignment_variable(CheckerContext *ctx, Operand *lhs, O
 		Ast *ln = unparen_expr(lhs->expr);
 		if (ln->kind == Ast_IndexExpr) {
 			Ast *x = ln->IndexExpr.expr;
-			TypeAndValue tav = x->tav;
+			TypeAndValue tav = x->tav();
 			GB_ASSERT(tav.mode != Addressing_Invalid);
 			if (tav.mode != Addressing_Variable) {
 				if (!is_type_pointer(tav.type)) {
@@ -1379,7 +1379,7 @@ gb_internal void check_switch_stmt(CheckerContext *ctx, Ast *node, u32 mod_flags
 				continue;
 			}
 			Token ctok = stmt->CaseClause.token;
-			if (ctok.pos.column > stok.pos.column) {
+			if (token_pos_line_column(ctok.pos).column > token_pos_line_column(stok.pos).column) {
 				error(ctok, "With '-strict-style', 'case' statements must share the same column as the 'switch' token");
 			}
 		}
@@ -1655,7 +1655,7 @@ gb_internal void check_type_switch_stmt(CheckerContext *ctx, Ast *node, u32 mod_
 				continue;
 			}
 			Token ctok = stmt->CaseClause.token;
-			if (ctok.pos.column > stok.pos.column) {
+			if (token_pos_line_column(ctok.pos).column > token_pos_line_column(stok.pos).column) {
 				error(ctok, "With '-strict-style', 'case' statements must share the same column as the 'switch' token");
 			}
 		}
@@ -2343,7 +2343,7 @@ gb_internal void check_value_decl_stmt(CheckerContext *ctx, Ast *node, u32 mod_f
 					error(e->token, "A static variable declaration with a default value must be constant");
 				} else {
 					Ast *value = vd->values[i];
-					if (value->tav.mode != Addressing_Constant) {
+					if (value->tav().mode != Addressing_Constant) {
 						error(e->token, "A static variable declaration with a default value must be constant");
 					}
 				}
@@ -2485,7 +2485,7 @@ gb_internal void check_expr_stmt(CheckerContext *ctx, Ast *node) {
 			return;
 		}
 
-		switch (be->left->tav.mode) {
+		switch (be->left->tav().mode) {
 		case Addressing_Context:
 		case Addressing_Variable:
 		case Addressing_MapIndex:
@@ -2755,12 +2755,12 @@ gb_internal void check_return_stmt(CheckerContext *ctx, Ast *node) {
 			continue;
 		}
 		Ast *expr = unparen_expr(o.expr);
-		while (expr->kind == Ast_CallExpr && expr->CallExpr.proc->tav.mode == Addressing_Type) {
+		while (expr->kind == Ast_CallExpr && expr->CallExpr.proc->tav().mode == Addressing_Type) {
 			if (expr->CallExpr.args.count != 1) {
 				break;
 			}
 			Ast *arg = expr->CallExpr.args[0];
-			if (arg->kind == Ast_FieldValue || !are_types_identical(arg->tav.type, expr->tav.type)) {
+			if (arg->kind == Ast_FieldValue || !are_types_identical(arg->tav().type, expr->tav().type)) {
 				break;
 			}
 			expr = unparen_expr(arg);
@@ -2793,16 +2793,16 @@ gb_internal void check_for_stmt(CheckerContext *ctx, Ast *node, u32 mod_flags) {
 			    cond->BinaryExpr.op.kind == Token_GtEq &&
 			    type_of_expr(cond->BinaryExpr.left) != nullptr &&
 			    is_type_unsigned(type_of_expr(cond->BinaryExpr.left)) &&
-			    cond->BinaryExpr.right->tav.value.kind == ExactValue_Integer &&
-			    is_exact_value_zero(cond->BinaryExpr.right->tav.value)) {
+			    cond->BinaryExpr.right->tav().value.kind == ExactValue_Integer &&
+			    is_exact_value_zero(cond->BinaryExpr.right->tav().value)) {
 				warning(cond, "Expression is always true since unsigned numbers are always >= 0");
 			} else if (cond && cond->kind == Ast_BinaryExpr &&
 			    cond->BinaryExpr.left && cond->BinaryExpr.right &&
 			    cond->BinaryExpr.op.kind == Token_LtEq &&
 			    type_of_expr(cond->BinaryExpr.right) != nullptr &&
 			    is_type_unsigned(type_of_expr(cond->BinaryExpr.right)) &&
-			    cond->BinaryExpr.left->tav.value.kind == ExactValue_Integer &&
-			    is_exact_value_zero(cond->BinaryExpr.left->tav.value)) {
+			    cond->BinaryExpr.left->tav().value.kind == ExactValue_Integer &&
+			    is_exact_value_zero(cond->BinaryExpr.left->tav().value)) {
 				warning(cond, "Expression is always true since unsigned numbers are always >= 0");
 			}
 		}
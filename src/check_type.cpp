@@ -2,6 +2,7 @@ gb_internal ParameterValue handle_parameter_value(CheckerContext *ctx, Type *in_
 gb_internal Type *determine_type_from_polymorphic(CheckerContext *ctx, Type *poly_type, Operand const &operand);
 gb_internal Type *check_get_params(CheckerContext *ctx, Scope *scope, Ast *_params, bool *is_variadic_, isize *variadic_index_, bool *success_, isize *specialization_count_, Array<Operand> const *operands);
 gb_internal void populate_using_entity_scope(CheckerContext *ctx, Ast *node, AstField *field, Type *t, isize level);
+gb_internal u64 polymorphic_record_params_hash(TypeTuple *params);
 
 gb_internal void populate_using_array_index(CheckerContext *ctx, Ast *node, AstField *field, Type *t, String name, i32 idx) {
 	t = base_type(t);
@@ -302,7 +303,10 @@ gb_internal GenTypesData *ensure_polymorphic_record_entity_has_gen_types(Checker
 	if (original_type->Named.gen_types_data == nullptr) {
 		GenTypesData *gen_types = permanent_alloc_item<GenTypesData>();
 		gen_types->types = array_make<Entity *>(heap_allocator());
+		gen_types->unhashed_types = array_make<Entity *>(heap_allocator());
+		map_init(&gen_types->types_by_hash);
 		original_type->Named.gen_types_data = gen_types;
+		mpsc_enqueue(&ctx->info->polymorphic_records_queue, original_type);
 	}
 	found_gen_types = original_type->Named.gen_types_data;
 
@@ -359,6 +363,13 @@ gb_internal void add_polymorphic_record_entity(CheckerContext *ctx, Ast *node, T
 		}
 	}
 	array_add(&found_gen_types->types, e);
+
+	u64 hash = polymorphic_record_params_hash(get_record_polymorphic_params(base_type(named_type)));
+	if (hash != 0) {
+		multi_map_insert(&found_gen_types->types_by_hash, hash, e);
+	} else {
+		array_add(&found_gen_types->unhashed_types, e);
+	}
 }
 
 
@@ -600,55 +611,193 @@ gb_internal bool check_record_poly_operand_specialization(CheckerContext *ctx, T
 	return true;
 }
 
-gb_internal Entity *find_polymorphic_record_entity(GenTypesData *found_gen_types, isize param_count, Array<Operand> const &ordered_operands) {
-	for (Entity *e : found_gen_types->types) {
-		Type *t = base_type(e->type);
-		TypeTuple *tuple = get_record_polymorphic_params(t);
-		GB_ASSERT_MSG(tuple != nullptr, "%s :: %s", type_to_string(e->type), type_to_string(t));
-		GB_ASSERT(param_count == tuple->variables.count);
+gb_internal gb_inline u64 polymorphic_record_hash_mix(u64 h, u64 x) {
+	return (h ^ x) * 0x100000001b3ull;
+}
 
-		bool skip = false;
+// NOTE: Only needs to agree with `are_types_identical`, as the entries with the same hash are still compared in full
+gb_internal u64 polymorphic_record_type_hash(Type *t) {
+	u64 h = 0xcbf29ce484222325ull;
+	while (t != nullptr) {
+		if (t->kind == Type_Named && t->Named.type_name != nullptr && t->Named.type_name->TypeName.is_type_alias) {
+			t = t->Named.base;
+			continue;
+		}
+		h = polymorphic_record_hash_mix(h, t->kind);
+		switch (t->kind) {
+		case Type_Named:
+			return polymorphic_record_hash_mix(h, cast(u64)cast(uintptr)t->Named.type_name);
+		case Type_Basic:
+			return polymorphic_record_hash_mix(h, t->Basic.kind);
+		case Type_Array:
+			h = polymorphic_record_hash_mix(h, cast(u64)t->Array.count);
+			t = t->Array.elem;
+			break;
+		case Type_Slice:        t = t->Slice.elem;        break;
+		case Type_DynamicArray: t = t->DynamicArray.elem; break;
+		case Type_Pointer:      t = t->Pointer.elem;      break;
+		case Type_MultiPointer: t = t->MultiPointer.elem; break;
+		default:
+			// NOTE: the other kinds rarely parameterize a record, so they are left to collide
+			return h;
+		}
+	}
+	return h;
+}
 
-		for (isize j = 0; j < param_count; j++) {
-			Entity *p = tuple->variables[j];
-			Operand o = {};
-			if (j < ordered_operands.count) {
-				o = ordered_operands[j];
+// NOTE: `compare_exact_values` promotes the numeric kinds to one another, so they are hashed by their real part
+gb_internal u64 polymorphic_record_value_hash(ExactValue const &v) {
+	f64 f = 0;
+	switch (v.kind) {
+	case ExactValue_Bool:       return 1 + cast(u64)v.value_bool;
+	case ExactValue_String:     return gb_fnv64a(v.value_string.text, v.value_string.len);
+	case ExactValue_Pointer:    return cast(u64)v.value_pointer;
+	case ExactValue_Integer:    f = big_int_to_f64(&v.value_integer); break;
+	case ExactValue_Float:      f = v.value_float;                    break;
+	case ExactValue_Complex:    f = v.value_complex->real;            break;
+	case ExactValue_Quaternion: f = v.value_quaternion->real;         break;
+	default:
+		return 0;
+	}
+	if (f == 0 || f != f) {
+		// NOTE: -0.0 == 0.0, and a NaN never compares equal anyway
+		return 0;
+	}
+	u64 bits = 0;
+	gb_memmove(&bits, &f, gb_size_of(bits));
+	return bits;
+}
+
+gb_internal u64 polymorphic_record_param_hash(u64 h, Entity *p, Type *type, ExactValue const &value) {
+	h = polymorphic_record_hash_mix(h, polymorphic_record_type_hash(type));
+	if (p->kind == Entity_Constant) {
+		h = polymorphic_record_hash_mix(h, polymorphic_record_value_hash(value));
+	}
+	return h;
+}
+
+gb_internal u64 polymorphic_record_hash_finish(u64 h) {
+	// NOTE: 0 means "not hashable" and ~0 is the tombstone of a `PtrMap`
+	if (h == 0 || h == ~cast(u64)0) {
+		h = 1;
+	}
+	return h;
+}
+
+// NOTE: Returns 0 if any of the parameters is still polymorphic
+gb_internal u64 polymorphic_record_params_hash(TypeTuple *params) {
+	if (params == nullptr) {
+		return 0;
+	}
+	u64 h = 0xcbf29ce484222325ull;
+	for (Entity *p : params->variables) {
+		if (p->kind != Entity_TypeName && p->kind != Entity_Constant) {
+			return 0;
+		}
+		if (p->type == nullptr || is_type_polymorphic(p->type)) {
+			return 0;
+		}
+		ExactValue value = p->kind == Entity_Constant ? p->Constant.value : ExactValue{};
+		h = polymorphic_record_param_hash(h, p, p->type, value);
+	}
+	return polymorphic_record_hash_finish(h);
+}
+
+// NOTE: Returns 0 if the operands may match an entry without being identical to its parameters,
+// i.e. when an operand is missing or polymorphic
+gb_internal u64 polymorphic_record_operands_hash(TypeTuple *params, isize param_count, Array<Operand> const &ordered_operands) {
+	if (params == nullptr || ordered_operands.count < param_count) {
+		return 0;
+	}
+	u64 h = 0xcbf29ce484222325ull;
+	for (isize j = 0; j < param_count; j++) {
+		Entity *p = params->variables[j];
+		Operand const &o = ordered_operands[j];
+		if (o.expr == nullptr || o.type == nullptr || is_type_polymorphic(o.type)) {
+			return 0;
+		}
+		if (p->kind == Entity_TypeName) {
+			if (o.mode != Addressing_Type) {
+				return 0;
 			}
-			if (o.expr == nullptr) {
-				continue;
+		} else if (p->kind != Entity_Constant) {
+			return 0;
+		}
+		h = polymorphic_record_param_hash(h, p, o.type, o.value);
+	}
+	return polymorphic_record_hash_finish(h);
+}
+
+gb_internal bool polymorphic_record_entity_matches(Entity *e, isize param_count, Array<Operand> const &ordered_operands) {
+	Type *t = base_type(e->type);
+	TypeTuple *tuple = get_record_polymorphic_params(t);
+	GB_ASSERT_MSG(tuple != nullptr, "%s :: %s", type_to_string(e->type), type_to_string(t));
+	GB_ASSERT(param_count == tuple->variables.count);
+
+	for (isize j = 0; j < param_count; j++) {
+		Entity *p = tuple->variables[j];
+		Operand o = {};
+		if (j < ordered_operands.count) {
+			o = ordered_operands[j];
+		}
+		if (o.expr == nullptr) {
+			continue;
+		}
+		Entity *oe = entity_of_node(o.expr);
+		if (p == oe) {
+			// NOTE(bill): This is the same type, make sure that it will be be same thing and use that
+			// Saves on a lot of checking too below
+			continue;
+		}
+
+		if (p->kind == Entity_TypeName) {
+			if (is_type_polymorphic(o.type)) {
+				// NOTE(bill): Do not add polymorphic version to the gen_types
+				return false;
 			}
-			Entity *oe = entity_of_node(o.expr);
-			if (p == oe) {
-				// NOTE(bill): This is the same type, make sure that it will be be same thing and use that
-				// Saves on a lot of checking too below
-				continue;
+			if (!are_types_identical(o.type, p->type)) {
+				return false;
+			}
+		} else if (p->kind == Entity_Constant) {
+			if (!compare_exact_values(Token_CmpEq, o.value, p->Constant.value)) {
+				return false;
 			}
+			if (!are_types_identical(o.type, p->type)) {
+				return false;
+			}
+		} else {
+			GB_PANIC("Unknown entity kind");
+		}
+	}
+	return true;
+}
 
-			if (p->kind == Entity_TypeName) {
-				if (is_type_polymorphic(o.type)) {
-					// NOTE(bill): Do not add polymorphic version to the gen_types
-					skip = true;
-					break;
-				}
-				if (!are_types_identical(o.type, p->type)) {
-					skip = true;
-					break;
-				}
-			} else if (p->kind == Entity_Constant) {
-				if (!compare_exact_values(Token_CmpEq, o.value, p->Constant.value)) {
-					skip = true;
-					break;
-				}
-				if (!are_types_identical(o.type, p->type)) {
-					skip = true;
-					break;
-				}
-			} else {
-				GB_PANIC("Unknown entity kind");
+gb_internal Entity *find_polymorphic_record_entity(GenTypesData *found_gen_types, isize param_count, Array<Operand> const &ordered_operands) {
+	found_gen_types->lookup_count.fetch_add(1, std::memory_order_relaxed);
+	if (found_gen_types->types.count == 0) {
+		return nullptr;
+	}
+
+	// NOTE: every entry has the same kinds of parameters, so the first one is as good as any for hashing the operands
+	Type *first = base_type(found_gen_types->types[0]->type);
+	u64 hash = polymorphic_record_operands_hash(get_record_polymorphic_params(first), param_count, ordered_operands);
+	if (hash == 0) {
+		for (Entity *e : found_gen_types->types) {
+			if (polymorphic_record_entity_matches(e, param_count, ordered_operands)) {
+				return e;
 			}
 		}
-		if (!skip) {
+		return nullptr;
+	}
+
+	auto *entry = multi_map_find_first(&found_gen_types->types_by_hash, hash);
+	for (/**/; entry != nullptr; entry = multi_map_find_next(&found_gen_types->types_by_hash, entry)) {
+		if (polymorphic_record_entity_matches(entry->value, param_count, ordered_operands)) {
+			return entry->value;
+		}
+	}
+	for (Entity *e : found_gen_types->unhashed_types) {
+		if (polymorphic_record_entity_matches(e, param_count, ordered_operands)) {
 			return e;
 		}
 	}
@@ -3617,8 +3766,8 @@ gb_internal bool check_type_internal(CheckerContext *ctx, Ast *e, Type **type, T
 	case_end;
 
 	case_ast_node(tt, TypeidType, e);
-		e->tav.mode = Addressing_Type;
-		e->tav.type = t_typeid;
+		e->tav_mut().mode = Addressing_Type;
+		e->tav_mut().type = t_typeid;
 		*type = t_typeid;
 		set_base_type(named_type, *type);
 		return true;
@@ -5,6 +5,7 @@
 
 
 gb_internal u64 type_hash_canonical_type(Type *type);
+gb_internal u64 type_hash_canonical_type_uncached(Type *type);
 
 gb_internal String get_final_microarchitecture();
 
@@ -82,16 +83,50 @@ gb_internal void entity_graph_node_destroy(EntityGraphNode *n, gbAllocator a) {
 }
 
 
+// NOTE: The order of the packages, then of the files by their name, and then of the entities within them.
+// Unlike `order_in_src` alone, this does not depend upon the ids of the files, which are given in the
+// order in which they were parsed, and so it is the same between builds.
+gb_internal int entity_order_cmp(Entity *x, Entity *y) {
+	int cmp = 0;
+	if (x == y) {
+		return cmp;
+	}
+
+	if (x->pkg != y->pkg) {
+		isize order_x = x->pkg ? x->pkg->order : 0;
+		isize order_y = y->pkg ? y->pkg->order : 0;
+		cmp = isize_cmp(order_x, order_y);
+		if (cmp) {
+			return cmp;
+		}
+	}
+	if (x->file != y->file) {
+		String fullpath_x = x->file ? x->file->fullpath : (String{});
+		String fullpath_y = y->file ? y->file->fullpath : (String{});
+		String file_x = filename_from_path(fullpath_x);
+		String file_y = filename_from_path(fullpath_y);
+
+		cmp = string_compare(file_x, file_y);
+		if (cmp) {
+			return cmp;
+		}
+	}
+
+	cmp = u64_cmp(x->order_in_src, y->order_in_src);
+	if (cmp) {
+		return cmp;
+	}
+	return i32_cmp(x->token.pos.offset, y->token.pos.offset);
+}
+
 gb_internal int entity_graph_node_cmp(EntityGraphNode **data, isize i, isize j) {
 	EntityGraphNode *x = data[i];
 	EntityGraphNode *y = data[j];
-	u64 a = x->entity->order_in_src;
-	u64 b = y->entity->order_in_src;
 	if (x->dep_count < y->dep_count) {
 		return -1;
 	}
 	if (x->dep_count == y->dep_count) {
-		return a < b ? -1 : b > a;
+		return entity_order_cmp(x->entity, y->entity);
 	}
 	return +1;
 }
@@ -150,7 +185,8 @@ gb_internal int import_graph_node_cmp(ImportGraphNode **data, isize i, isize j)
 	if (xg && yg) return x->pkg->id < y->pkg->id ? +1 : -1;
 	if (x->dep_count < y->dep_count) return -1;
 	if (x->dep_count > y->dep_count) return +1;
-	return 0;
+	// NOTE: rather than the order in which the packages were parsed, so that it is the same between builds
+	return string_compare(x->pkg->fullpath, y->pkg->fullpath);
 }
 
 gb_internal void import_graph_node_swap(ImportGraphNode **data, isize i, isize j) {
@@ -828,7 +864,7 @@ gb_internal void check_scope_usage_internal(Checker *c, Scope *scope, u64 vet_fl
 		}
 
 		if (ve.kind == VettedEntity_Shadowed_And_Unused) {
-			error(e->token, "'%.*s' declared but not used, possibly shadows declaration at line %d", LIT(name), other->token.pos.line);
+			error(e->token, "'%.*s' declared but not used, possibly shadows declaration at line %d", LIT(name), token_pos_line_column(other->token.pos).line);
 		} else if (vet_flags) {
 			switch (ve.kind) {
 			case VettedEntity_Unused:
@@ -844,9 +880,9 @@ gb_internal void check_scope_usage_internal(Checker *c, Scope *scope, u64 vet_fl
 				break;
 			case VettedEntity_Shadowed:
 				if ((vet_flags & (VetFlag_Shadowing|VetFlag_Using)) != 0 && e->flags&EntityFlag_Using) {
-					error(e->token, "Declaration of '%.*s' from 'using' shadows declaration at line %d", LIT(name), other->token.pos.line);
+					error(e->token, "Declaration of '%.*s' from 'using' shadows declaration at line %d", LIT(name), token_pos_line_column(other->token.pos).line);
 				} else if ((vet_flags & (VetFlag_Shadowing)) != 0) {
-					error(e->token, "Declaration of '%.*s' shadows declaration at line %d", LIT(name), other->token.pos.line);
+					error(e->token, "Declaration of '%.*s' shadows declaration at line %d", LIT(name), token_pos_line_column(other->token.pos).line);
 				}
 				break;
 			default:
@@ -1636,6 +1672,8 @@ gb_internal void init_checker_info(CheckerInfo *i) {
 	mpsc_init(&i->raddbg_type_views_queue, a);
 	array_init(&i->raddbg_type_views, a);
 
+	mpsc_init(&i->polymorphic_records_queue, a);
+
 	string_map_init(&i->load_directory_cache);
 	map_init(&i->load_directory_map);
 }
@@ -1669,6 +1707,11 @@ gb_internal void destroy_checker_info(CheckerInfo *i) {
 	mpsc_destroy(&i->raddbg_type_views_queue);
 	array_free(&i->raddbg_type_views);
 
+	// NOTE: only drained by -show-more-timings
+	for (Type *t; mpsc_dequeue(&i->polymorphic_records_queue, &t); /**/) {
+	}
+	mpsc_destroy(&i->polymorphic_records_queue);
+
 	map_destroy(&i->objc_msgSend_types);
 	string_set_destroy(&i->obcj_class_name_set);
 	map_destroy(&i->objc_method_implementations);
@@ -1774,13 +1817,13 @@ gb_internal void destroy_checker(Checker *c) {
 gb_internal TypeAndValue type_and_value_of_expr(Ast *expr) {
 	TypeAndValue tav = {};
 	if (expr != nullptr) {
-		tav = expr->tav;
+		tav = expr->tav();
 	}
 	return tav;
 }
 
 gb_internal Type *type_of_expr(Ast *expr) {
-	TypeAndValue tav = expr->tav;
+	TypeAndValue tav = expr->tav();
 	if (tav.mode != Addressing_Invalid) {
 		return tav.type;
 	}
@@ -1828,10 +1871,10 @@ retry:;
 		if (we->cond == nullptr) {
 			break;
 		}
-		if (we->cond->tav.value.kind != ExactValue_Bool) {
+		if (we->cond->tav().value.kind != ExactValue_Bool) {
 			break;
 		}
-		expr = we->cond->tav.value.value_bool ? we->x : we->y;
+		expr = we->cond->tav().value.value_bool ? we->x : we->y;
 		goto retry;
 	case_end;
 	}
@@ -1985,20 +2028,20 @@ gb_internal void add_type_and_value(CheckerContext *ctx, Ast *expr, AddressingMo
 	Ast *prev_expr = nullptr;
 	while (prev_expr != expr) {
 		prev_expr = expr;
-		expr->tav.mode = mode;
-		if (type != nullptr && expr->tav.type != nullptr &&
-		    is_type_any(type) && is_type_untyped(expr->tav.type)) {
+		expr->tav_mut().mode = mode;
+		if (type != nullptr && expr->tav().type != nullptr &&
+		    is_type_any(type) && is_type_untyped(expr->tav().type)) {
 			// ignore
 		} else {
-			expr->tav.type = type;
+			expr->tav_mut().type = type;
 		}
 
 		if (mode == Addressing_Constant || mode == Addressing_Invalid) {
-			expr->tav.value = value;
+			expr->tav_mut().value = value;
 		} else if (mode == Addressing_Value && type != nullptr && is_type_typeid(type)) {
-			expr->tav.value = value;
+			expr->tav_mut().value = value;
 		} else if (mode == Addressing_Value && type != nullptr && is_type_proc(type)) {
-			expr->tav.value = value;
+			expr->tav_mut().value = value;
 		}
 
 		expr = unparen_expr(expr);
@@ -4856,8 +4899,8 @@ gb_internal void check_collect_value_decl(CheckerContext *c, Ast *decl) {
 				if (value != nullptr) {
 					if (value->kind == Ast_BasicLit && value->BasicLit.token.kind == Token_String) {
 						String v = {};
-						if (value->tav.value.kind == ExactValue_String) {
-							v = value->tav.value.value_string;
+						if (value->tav().value.kind == ExactValue_String) {
+							v = value->tav().value.value_string;
 						}
 						if (v == "file") {
 							kind = EntityVisiblity_PrivateToFile;
@@ -5653,7 +5696,7 @@ gb_internal void check_add_import_decl(CheckerContext *ctx, Ast *decl) {
 			error_line("\tSuggestion: Rename the directory or explicitly set an import name like this 'import <new_name> %.*s'", LIT(id->relpath.string));
 		}
 	} else {
-		GB_ASSERT(id->import_name.pos.line != 0);
+		GB_ASSERT(token_pos_is_valid(id->import_name.pos));
 		id->import_name.string = import_name;
 		Entity *e = alloc_entity_import_name(parent_scope, id->import_name, t_invalid,
 		                                     id->fullpath, id->import_name.string,
@@ -5841,7 +5884,7 @@ gb_internal void check_add_foreign_import_decl(CheckerContext *ctx, Ast *decl) {
 	}
 
 
-	GB_ASSERT(fl->library_name.pos.line != 0);
+	GB_ASSERT(token_pos_is_valid(fl->library_name.pos));
 	fl->library_name.string = library_name;
 
 	AttributeContext ac = {};
@@ -6566,6 +6609,25 @@ gb_internal bool check_proc_info(Checker *c, ProcInfo *pi, UntypedExprInfoMap *u
 		}
 	}
 
+	if (!pt->is_polymorphic && pi->file != nullptr && pi->file->pkg != nullptr && pi->file->pkg->summary_valid) {
+		// NOTE: Neither this package nor anything it depends upon has changed since it was
+		// last checked without any errors or warnings, see check_package_summaries
+		pi->decl->proc_checked_state.store(ProcCheckedState_Checked);
+		if (pi->body && e != nullptr) {
+			e->flags |= EntityFlag_ProcBodyChecked;
+		}
+		return true;
+	}
+
+	if (!parse_deferred_proc_body(pi->body)) {
+		// NOTE: The body could not be parsed, which has already been reported, -internal-defer-proc-bodies
+		pi->decl->proc_checked_state.store(ProcCheckedState_Checked);
+		if (e != nullptr) {
+			e->flags |= EntityFlag_ProcBodyChecked;
+		}
+		return true;
+	}
+
 	CheckerContext ctx = {};
 	init_checker_context(&ctx, c);
 	defer (destroy_checker_context(&ctx));
@@ -7445,40 +7507,9 @@ gb_internal void check_merge_queues_into_arrays(Checker *c) {
 }
 
 gb_internal GB_COMPARE_PROC(init_procedures_cmp) {
-	int cmp = 0;
 	Entity *x = *(Entity **)a;
 	Entity *y = *(Entity **)b;
-	if (x == y) {
-		cmp = 0;
-		return cmp;
-	}
-
-	if (x->pkg != y->pkg) {
-		isize order_x = x->pkg ? x->pkg->order : 0;
-		isize order_y = y->pkg ? y->pkg->order : 0;
-		cmp = isize_cmp(order_x, order_y);
-		if (cmp) {
-			return cmp;
-		}
-	}
-	if (x->file != y->file) {
-		String fullpath_x = x->file ? x->file->fullpath : (String{});
-		String fullpath_y = y->file ? y->file->fullpath : (String{});
-		String file_x = filename_from_path(fullpath_x);
-		String file_y = filename_from_path(fullpath_y);
-
-		cmp = string_compare(file_x, file_y);
-		if (cmp) {
-			return cmp;
-		}
-	}
-
-
-	cmp = u64_cmp(x->order_in_src, y->order_in_src);
-	if (cmp) {
-		return cmp;
-	}
-	return i32_cmp(x->token.pos.offset, y->token.pos.offset);
+	return entity_order_cmp(x, y);
 }
 
 gb_internal GB_COMPARE_PROC(fini_procedures_cmp) {
@@ -7576,6 +7607,10 @@ gb_internal void check_update_dependency_tree_for_procedures(Checker *c) {
 gb_internal WORKER_TASK_PROC(check_scope_usage_file_worker) {
 	Checker *c = global_checker_ptr.load(std::memory_order_relaxed);
 	AstFile *f = cast(AstFile *)data;
+	if (f->pkg != nullptr && f->pkg->summary_valid) {
+		// NOTE: the procedure bodies were not checked, so the usage information is incomplete
+		return 0;
+	}
 	u64 vet_flags = ast_file_vet_flags(f);
 	check_scope_usage(c, f->scope, vet_flags);
 	return 0;
@@ -7584,6 +7619,9 @@ gb_internal WORKER_TASK_PROC(check_scope_usage_file_worker) {
 gb_internal WORKER_TASK_PROC(check_scope_usage_pkg_worker) {
 	Checker *c = global_checker_ptr.load(std::memory_order_relaxed);
 	AstPackage *pkg = cast(AstPackage *)data;
+	if (pkg->summary_valid) {
+		return 0;
+	}
 	check_scope_usage_internal(c, pkg->scope, 0, true);
 	return 0;
 }
@@ -7641,6 +7679,416 @@ gb_internal void check_for_inline_cycles(Checker *c) {
 }
 
 
+gb_internal GB_COMPARE_PROC(package_summary_entity_cmp) {
+	Entity *x = *cast(Entity **)a;
+	Entity *y = *cast(Entity **)b;
+	i32 res = string_compare(x->token.string, y->token.string);
+	if (res == 0) {
+		res = token_pos_cmp(x->token.pos, y->token.pos);
+	}
+	return res;
+}
+
+gb_internal GB_COMPARE_PROC(package_summary_dep_cmp) {
+	AstPackage *x = *cast(AstPackage **)a;
+	AstPackage *y = *cast(AstPackage **)b;
+	return string_compare(x->fullpath, y->fullpath);
+}
+
+// NOTE: The source text of a declaration, including its attributes but excluding the body of
+// a non-polymorphic procedure, as changing that body cannot affect the packages which import it
+gb_internal u64 package_summary_decl_source_hash(Entity *e) {
+	DeclInfo *d = e->decl_info;
+	AstFile *f = e->file;
+	if (d == nullptr || d->decl_node == nullptr || f == nullptr) {
+		return 0;
+	}
+	isize file_size = f->tokenizer.end - f->tokenizer.start;
+	auto hash_range = [&](u64 seed, Ast *node, Ast *end_node) -> u64 {
+		isize lo = ast_token(node).pos.offset;
+		isize hi = 0;
+		if (end_node != nullptr) {
+			hi = ast_token(end_node).pos.offset;
+		} else {
+			Token end = ast_end_token(node);
+			hi = end.pos.offset + end.string.len;
+		}
+		lo = gb_clamp(lo, 0, file_size);
+		hi = gb_clamp(hi, lo, file_size);
+		return gb_murmur64_seed(f->tokenizer.start+lo, hi-lo, seed);
+	};
+
+	u64 hash = 0;
+	for (Ast *attr : d->attributes) {
+		hash = hash_range(hash, attr, nullptr);
+	}
+	Ast *body = nullptr;
+	if (e->kind == Entity_Procedure && d->proc_lit != nullptr && d->proc_lit->kind == Ast_ProcLit) {
+		if (e->type == nullptr || !is_type_polymorphic(e->type)) {
+			body = d->proc_lit->ProcLit.body;
+		}
+	}
+	return hash_range(hash, d->decl_node, body);
+}
+
+gb_internal WORKER_TASK_PROC(check_package_summary_interface_worker) {
+	AstPackage *pkg = cast(AstPackage *)data;
+	if (pkg->scope == nullptr) {
+		return 0;
+	}
+
+	auto entities = array_make<Entity *>(heap_allocator(), 0, pkg->scope->elements.count);
+	defer (array_free(&entities));
+	for (auto const &entry : pkg->scope->elements) {
+		Entity *e = entry.value;
+		if (e->kind == Entity_ImportName || e->kind == Entity_LibraryName) {
+			continue;
+		}
+		if (is_entity_exported(e)) {
+			array_add(&entities, e);
+		}
+	}
+	array_sort(entities, package_summary_entity_cmp);
+
+	gbString s = gb_string_make_reserve(heap_allocator(), 1024);
+	defer (gb_string_free(s));
+
+	for (Entity *e : entities) {
+		u64 type_hash = 0;
+		Type *type = e->state.load() == EntityState_Resolved ? e->type : nullptr;
+		if (type != nullptr && !is_type_polymorphic(type)) {
+			switch (e->kind) {
+			case Entity_Constant:
+			case Entity_Variable:
+			case Entity_Procedure:
+				type_hash = type_hash_canonical_type(type);
+				break;
+			case Entity_TypeName:
+				// NOTE: a named type only hashes its name, so include the structure too
+				type_hash = type_hash_canonical_type(type);
+				type_hash = gb_murmur64_seed(&type_hash, gb_size_of(type_hash), type_hash_canonical_type(base_type(type)));
+				break;
+			}
+		}
+
+		s = gb_string_append_fmt(s, "%.*s %.*s 0x%016llx 0x%016llx ",
+		                         LIT(entity_strings[e->kind]), LIT(e->token.string),
+		                         cast(unsigned long long)type_hash,
+		                         cast(unsigned long long)package_summary_decl_source_hash(e));
+		if (type != nullptr) {
+			gbString t = type_to_string(type, heap_allocator());
+			s = gb_string_append_length(s, t, gb_string_length(t));
+			gb_string_free(t);
+		} else {
+			s = gb_string_appendc(s, "<unresolved>");
+		}
+		if (e->kind == Entity_Constant && type != nullptr) {
+			gbString v = exact_value_to_string(e->Constant.value, 1<<20);
+			s = gb_string_appendc(s, " = ");
+			s = gb_string_append_length(s, v, gb_string_length(v));
+			gb_string_free(v);
+		}
+		s = gb_string_appendc(s, "\n");
+	}
+
+	pkg->summary_interface = copy_string(permanent_allocator(), make_string(cast(u8 *)s, gb_string_length(s)));
+	pkg->summary_interface_hash = gb_murmur64(pkg->summary_interface.text, pkg->summary_interface.len);
+	return 0;
+}
+
+// NOTE: Every package reachable through the imports of `pkg`, plus the runtime, sorted by their full path
+gb_internal Array<AstPackage *> check_package_summary_deps(Checker *c, AstPackage *pkg) {
+	auto deps = array_make<AstPackage *>(heap_allocator(), 0, 16);
+	PtrSet<AstPackage *> seen = {};
+	defer (ptr_set_destroy(&seen));
+
+	ptr_set_add(&seen, pkg);
+	auto add_imports = [&](AstPackage *p) {
+		for (AstFile *f : p->files) {
+			for (Ast *decl : f->imports) {
+				if (decl->kind != Ast_ImportDecl || decl->ImportDecl.package == nullptr) {
+					continue;
+				}
+				AstPackage *dep = decl->ImportDecl.package;
+				if (!ptr_set_update(&seen, dep)) {
+					array_add(&deps, dep);
+				}
+			}
+		}
+	};
+
+	if (c->info.runtime_package != nullptr && !ptr_set_update(&seen, c->info.runtime_package)) {
+		array_add(&deps, c->info.runtime_package);
+	}
+	add_imports(pkg);
+	for (isize i = 0; i < deps.count; i++) {
+		add_imports(deps[i]);
+	}
+	array_sort(deps, package_summary_dep_cmp);
+	return deps;
+}
+
+gb_internal GB_COMPARE_PROC(package_summary_use_cmp) {
+	String const &x = *cast(String *)a;
+	String const &y = *cast(String *)b;
+	return string_compare(x, y);
+}
+
+// NOTE: The index of the package which declares `e` within the package or file scope from which it can
+// be looked up by its name: 0 for `pkg` and `i+1` for `deps[i]`. -1 if it cannot be, e.g. a local entity
+// or a polymorphic specialization, and -2 if it is declared by a package outside of the summary.
+// `file_` is set to the file if `e` is private to it.
+gb_internal isize package_summary_entity_index(AstPackage *pkg, Array<AstPackage *> const &deps, Entity *e, AstFile **file_) {
+	*file_ = nullptr;
+	Scope *s = e->scope;
+	if (s == nullptr || (s->flags & (ScopeFlag_Pkg|ScopeFlag_File)) == 0 || e->token.string.len == 0) {
+		return -1;
+	}
+	u32 hash = 0;
+	InternedString key = string_interner_insert(e->token.string, 0, &hash);
+	AstPackage *p = nullptr;
+	if (s->flags & ScopeFlag_File) {
+		// NOTE: the scope of a package level entity is the file which declares it
+		p = s->file->pkg;
+		if (scope_lookup_current(s, key, hash) == e) {
+			*file_ = s->file;
+		} else if (p == nullptr || p->scope == nullptr || scope_lookup_current(p->scope, key, hash) != e) {
+			return -1;
+		}
+	} else {
+		p = s->pkg;
+		if (scope_lookup_current(s, key, hash) != e) {
+			return -1;
+		}
+	}
+	if (p == pkg) {
+		return 0;
+	}
+	for_array(i, deps) {
+		if (deps[i] == p) {
+			return i+1;
+		}
+	}
+	return -2;
+}
+
+// NOTE: An entity of a package summary is written as `<index>:<name>`, or `<index>:<name>:<file>` if it is
+// private to a file, see package_summary_entity_index
+gb_internal bool package_summary_entity_ref(gbString *s_, isize index, AstFile *file, Entity *e) {
+	gbString s = *s_;
+	defer (*s_ = s);
+	s = gb_string_append_fmt(s, "%td:%.*s", index, LIT(e->token.string));
+	if (file != nullptr) {
+		if (string_index_byte(file->filename, ' ') >= 0 || string_index_byte(file->filename, '\n') >= 0) {
+			return false;
+		}
+		s = gb_string_append_fmt(s, ":%.*s", LIT(file->filename));
+	}
+	return true;
+}
+
+gb_internal Entity *package_summary_entity_from_ref(AstPackage *pkg, Array<AstPackage *> const &deps, String ref) {
+	isize sep = string_index_byte(ref, ':');
+	if (sep <= 0) {
+		return nullptr;
+	}
+	u64 index = u64_from_string(substring(ref, 0, sep));
+	AstPackage *p = nullptr;
+	if (index == 0) {
+		p = pkg;
+	} else if (index <= cast(u64)deps.count) {
+		p = deps[index-1];
+	} else {
+		return nullptr;
+	}
+
+	String name = substring(ref, sep+1, ref.len);
+	Scope *s = p->scope;
+	sep = string_index_byte(name, ':');
+	if (sep >= 0) {
+		String filename = substring(name, sep+1, name.len);
+		name = substring(name, 0, sep);
+		s = nullptr;
+		for (AstFile *f : p->files) {
+			if (f->filename == filename) {
+				s = f->scope;
+				break;
+			}
+		}
+	}
+	if (s == nullptr || name.len == 0) {
+		return nullptr;
+	}
+	u32 hash = 0;
+	InternedString key = string_interner_insert(name, 0, &hash);
+	return scope_lookup_current(s, key, hash);
+}
+
+// NOTE: The entities used by the declaration `d`, which includes those used by the procedure bodies within
+// it. An entity which cannot be looked up by its name is replaced by the entities which it uses in turn.
+gb_internal bool package_summary_collect_uses(AstPackage *pkg, Array<AstPackage *> const &deps, DeclInfo *d,
+                                              PtrSet<Entity *> *visited, Array<String> *uses) {
+	FOR_PTR_SET(dep, d->deps) {
+		if (dep == nullptr || ptr_set_update(visited, dep)) {
+			continue;
+		}
+		if (dep->scope != nullptr && (dep->scope->flags & ScopeFlag_Builtin)) {
+			continue;
+		}
+		AstFile *file = nullptr;
+		isize index = package_summary_entity_index(pkg, deps, dep, &file);
+		if (index == -2) {
+			return false;
+		} else if (index >= 0) {
+			gbString s = gb_string_make_reserve(temporary_allocator(), 32);
+			if (!package_summary_entity_ref(&s, index, file, dep)) {
+				return false;
+			}
+			array_add(uses, make_string(cast(u8 *)s, gb_string_length(s)));
+		} else if (dep->decl_info != nullptr) {
+			if (!package_summary_collect_uses(pkg, deps, dep->decl_info, visited, uses)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// NOTE: The bodies of the procedures of a package which has not changed are not checked again, so the
+// entities that they use are kept as `uses <entity> <used>...` lines of its summary and restored by
+// check_package_summary_restore_uses. Otherwise the dependency graph would be missing them, and e.g.
+// `-vet-unused-procedures` would report the procedures that only those bodies use. The type info
+// dependencies are not kept as the summaries are only used by `odin check`.
+gb_internal bool check_package_summary_uses(gbString *s_, AstPackage *pkg, Array<AstPackage *> const &deps) {
+	if (pkg->scope == nullptr) {
+		return true;
+	}
+
+	auto entities = array_make<Entity *>(heap_allocator(), 0, pkg->scope->elements.count);
+	defer (array_free(&entities));
+	auto add_entities = [&](Scope *s) {
+		for (auto const &entry : s->elements) {
+			Entity *e = entry.value;
+			AstFile *file = nullptr;
+			if (e->decl_info != nullptr && e->decl_info->deps.count != 0 &&
+			    package_summary_entity_index(pkg, deps, e, &file) == 0) {
+				array_add(&entities, e);
+			}
+		}
+	};
+	add_entities(pkg->scope);
+	for (AstFile *f : pkg->files) {
+		if (f->scope != nullptr) {
+			add_entities(f->scope);
+		}
+	}
+	array_sort(entities, package_summary_entity_cmp);
+
+	auto uses = array_make<String>(heap_allocator(), 0, 64);
+	defer (array_free(&uses));
+	PtrSet<Entity *> visited = {};
+	defer (ptr_set_destroy(&visited));
+
+	gbString s = *s_;
+	defer (*s_ = s);
+	for (Entity *e : entities) {
+		TEMPORARY_ALLOCATOR_GUARD();
+		array_clear(&uses);
+		ptr_set_clear(&visited);
+		ptr_set_add(&visited, e);
+		if (!package_summary_collect_uses(pkg, deps, e->decl_info, &visited, &uses)) {
+			return false;
+		}
+		if (uses.count == 0) {
+			continue;
+		}
+		array_sort(uses, package_summary_use_cmp);
+
+		AstFile *file = nullptr;
+		package_summary_entity_index(pkg, deps, e, &file);
+		s = gb_string_appendc(s, "uses ");
+		if (!package_summary_entity_ref(&s, 0, file, e)) {
+			return false;
+		}
+		for (String const &use : uses) {
+			s = gb_string_append_fmt(s, " %.*s", LIT(use));
+		}
+		s = gb_string_appendc(s, "\n");
+	}
+	return true;
+}
+
+// NOTE: Returns false, without restoring anything, if an entity of the summary can no longer be found
+gb_internal bool check_package_summary_restore_uses(Checker *c, AstPackage *pkg, Array<AstPackage *> const &deps) {
+	struct PackageSummaryUse {
+		DeclInfo *decl;
+		Entity *  used;
+	};
+	auto restored = array_make<PackageSummaryUse>(heap_allocator(), 0, 4*pkg->summary_cached_uses.count);
+	defer (array_free(&restored));
+
+	for (String const &line : pkg->summary_cached_uses) {
+		String_Iterator it = {line, 0};
+		Entity *e = package_summary_entity_from_ref(pkg, deps, string_split_iterator(&it, ' '));
+		if (e == nullptr || e->decl_info == nullptr) {
+			return false;
+		}
+		while (it.pos < line.len) {
+			Entity *used = package_summary_entity_from_ref(pkg, deps, string_split_iterator(&it, ' '));
+			if (used == nullptr) {
+				return false;
+			}
+			array_add(&restored, PackageSummaryUse{e->decl_info, used});
+		}
+	}
+
+	for (PackageSummaryUse const &use : restored) {
+		add_dependency(&c->info, use.decl, use.used);
+		use.used->flags |= EntityFlag_Used;
+	}
+	return true;
+}
+
+// NOTE: Called once every global declaration has been checked. A package whose own source is unchanged
+// and whose dependencies export exactly what they did on the previous (error free) check does not need
+// its procedure bodies checked again.
+gb_internal void check_package_summaries(Checker *c) {
+	for (AstPackage *pkg : c->parser->packages) {
+		thread_pool_add_task(check_package_summary_interface_worker, pkg);
+	}
+	thread_pool_wait();
+
+	isize valid_count = 0;
+	for (AstPackage *pkg : c->parser->packages) {
+		if (!pkg->summary_loaded) {
+			continue;
+		}
+		auto deps = check_package_summary_deps(c, pkg);
+		defer (array_free(&deps));
+
+		bool valid = deps.count == pkg->summary_cached_deps.count;
+		for (isize i = 0; valid && i < deps.count; i++) {
+			AstPackageSummaryDep const &cached = pkg->summary_cached_deps[i];
+			if (deps[i]->summary_source_hash == 0 ||
+			    deps[i]->fullpath != cached.fullpath ||
+			    deps[i]->summary_interface_hash != cached.interface_hash) {
+				valid = false;
+			}
+		}
+		if (valid && !check_package_summary_restore_uses(c, pkg, deps)) {
+			debugf("Package Summary: the entities used by %.*s have changed\n", LIT(pkg->fullpath));
+			valid = false;
+		}
+		pkg->summary_valid = valid;
+		if (valid) {
+			valid_count += 1;
+		} else {
+			debugf("Package Summary: %.*s is stale\n", LIT(pkg->fullpath));
+		}
+	}
+	debugf("Package Summary: %td of %td packages unchanged\n", valid_count, c->parser->packages.count);
+}
+
 gb_internal void check_parsed_files(Checker *c) {
 	global_checker_ptr.store(c, std::memory_order_relaxed);
 
@@ -7688,6 +8136,11 @@ gb_internal void check_parsed_files(Checker *c) {
 	TIME_SECTION("check all global entities");
 	check_all_global_entities(c);
 
+	if (build_context.cached_packages) {
+		TIME_SECTION("check package summaries");
+		check_package_summaries(c);
+	}
+
 	TIME_SECTION("init preload");
 	init_preload(c);
 
@@ -7780,13 +8233,12 @@ gb_internal void check_parsed_files(Checker *c) {
 		Entity *e = scope_lookup_current(s, string_interner_insert(str_lit("main")));
 		if (e == nullptr) {
 			Token token = {};
-			token.pos.file_id = 0;
-			token.pos.line    = 1;
-			token.pos.column  = 1;
+			token.pos = token_pos_line_only(1);
 			if (s->pkg->files.count > 0) {
 				AstFile *f = s->pkg->files[0];
-				if (f->tokens.count > 0) {
-					token = f->tokens[0];
+				Token first = ast_file_first_token(f);
+				if (token_pos_is_valid(first.pos)) {
+					token = first;
 				}
 			}
 
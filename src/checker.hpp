@@ -672,14 +672,26 @@ struct LoadDirectoryCache {
 };
 
 
+// NOTE: An open addressed table of the instantiations by the canonical hash of their procedure types.
+// It is replaced (never modified) when it grows, so that it can be searched without taking the mutex.
+struct GenProcsTable {
+	isize                 capacity; // a power of two
+	std::atomic<u64> *    hashes;
+	std::atomic<Entity *> *procs;
+};
+
 struct GenProcsData {
-	Array<Entity *> procs;
-	RwMutex         mutex;
+	Array<Entity *>              procs; // in the order they were generated
+	RwMutex                      mutex;
+	std::atomic<GenProcsTable *> table;
 };
 
 struct GenTypesData {
-	Array<Entity *> types;
-	RecursiveMutex  mutex;
+	Array<Entity *>       types;
+	PtrMap<u64, Entity *> types_by_hash;  // multi-map of the `types` with concrete parameters, see `polymorphic_record_params_hash`
+	Array<Entity *>       unhashed_types; // the `types` with polymorphic parameters, which are always compared in full
+	std::atomic<isize>    lookup_count;   // for -show-more-timings
+	RecursiveMutex        mutex;
 };
 
 struct Defineable {
@@ -770,6 +782,8 @@ struct CheckerInfo {
 	StringSet obcj_class_name_set;
 	MPSCQueue<Entity *> objc_class_implementations;
 
+	MPSCQueue<Type *>   polymorphic_records_queue; // records with a `gen_types_data`, for -show-more-timings
+
 	BlockingMutex objc_method_mutex;
 	PtrMap<Type *, Array<ObjcMethodData>> objc_method_implementations;
 
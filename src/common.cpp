@@ -29,6 +29,12 @@
 #include <psapi.h>
 #endif
 
+#if defined(GB_CPU_X86)
+#include <emmintrin.h> // SSE2
+#elif defined(GB_CPU_ARM) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include <math.h>
 #include <string.h>
 #include <atomic> // Because I wanted the C++11 memory order semantics, of which gb.h does not offer (because it was a C89 library)
@@ -465,6 +471,30 @@ gb_internal i64 bit_set_count(u64 x) {
 	return bit_set_count(a) + bit_set_count(b);
 }
 
+// NOTE: `x` must not be zero
+gb_internal i32 count_trailing_zeros(u32 x) {
+#if defined(GB_COMPILER_MSVC)
+	unsigned long index = 0;
+	_BitScanForward(&index, x);
+	return cast(i32)index;
+#else
+	return __builtin_ctz(x);
+#endif
+}
+
+gb_internal i32 count_trailing_zeros(u64 x) {
+#if defined(GB_COMPILER_MSVC) && defined(GB_ARCH_64_BIT)
+	unsigned long index = 0;
+	_BitScanForward64(&index, x);
+	return cast(i32)index;
+#elif defined(GB_COMPILER_MSVC)
+	u32 lo = cast(u32)x;
+	return lo != 0 ? count_trailing_zeros(lo) : 32 + count_trailing_zeros(cast(u32)(x >> 32));
+#else
+	return __builtin_ctzll(x);
+#endif
+}
+
 gb_internal u32 floor_log2(u32 x) {
 	x |= x >> 1;
 	x |= x >> 2;
@@ -709,8 +739,17 @@ struct LoadedFile {
 	void *handle;
 	
 	void const *data;
-	i32         size;
+	isize       size;
+};
+
+// NOTE: How the contents of the source files and the `#load`-ed files are loaded (see -map-files)
+enum FileLoadMode : u8 {
+	FileLoad_Copy,          // read into the permanent arena
+	FileLoad_Map,           // memory mapped, and read in as the pages are touched
+	FileLoad_MapSequential, // memory mapped, with the kernel told to read ahead
+	FileLoad_MapPopulate,   // memory mapped, with all of the pages read in up front (Linux only)
 };
+
 enum LoadedFileError {
 	LoadedFile_None,
 	
@@ -723,10 +762,11 @@ enum LoadedFileError {
 	LoadedFile_COUNT,
 };
 
-gb_internal LoadedFileError load_file_32(char const *fullpath, LoadedFile *memory_mapped_file, bool copy_file_contents) {
+// NOTE: The mapped files are never unmapped, as their contents are used for the rest of the compilation
+gb_internal LoadedFileError load_file(char const *fullpath, LoadedFile *memory_mapped_file, FileLoadMode mode, i64 max_size) {
 	LoadedFileError err = LoadedFile_None;
 	
-	if (!copy_file_contents) {
+	if (mode != FileLoad_Copy) {
 	#if defined(GB_SYSTEM_WINDOWS)
 		TEMPORARY_ALLOCATOR_GUARD();
 
@@ -752,7 +792,7 @@ gb_internal LoadedFileError load_file_32(char const *fullpath, LoadedFile *memor
 			goto window_handle_file_error;
 		}
 		file_size = cast(i64)li_file_size.QuadPart;
-		if (file_size > I32_MAX) {
+		if (file_size > max_size) {
 			CloseHandle(handle);
 			return LoadedFile_FileTooLarge;
 		}
@@ -772,7 +812,7 @@ gb_internal LoadedFileError load_file_32(char const *fullpath, LoadedFile *memor
 		file_data = MapViewOfFileEx(file_mapping, FILE_MAP_READ, 0, 0, 0/*file_size*/, nullptr/*base address*/);
 		memory_mapped_file->handle = cast(void *)file_mapping;
 		memory_mapped_file->data = file_data;
-		memory_mapped_file->size = cast(i32)file_size;
+		memory_mapped_file->size = cast(isize)file_size;
 		return err;
 	
 	window_handle_file_error:;
@@ -793,18 +833,66 @@ gb_internal LoadedFileError load_file_32(char const *fullpath, LoadedFile *memor
 			}
 			return err;
 		}
+	#else
+		int fd = open(fullpath, O_RDONLY|O_CLOEXEC);
+		if (fd < 0) {
+			switch (errno) {
+			case ENOENT:
+			case ENOTDIR:
+				return LoadedFile_NotExists;
+			case EACCES:
+			case EPERM:
+				return LoadedFile_Permission;
+			}
+			return LoadedFile_Invalid;
+		}
+		defer (close(fd));
+
+		struct stat st = {};
+		if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+			return LoadedFile_Invalid;
+		}
+		i64 file_size = cast(i64)st.st_size;
+		if (file_size > max_size) {
+			return LoadedFile_FileTooLarge;
+		}
+		if (file_size == 0) {
+			memory_mapped_file->handle = nullptr;
+			memory_mapped_file->data   = nullptr;
+			memory_mapped_file->size   = 0;
+			return LoadedFile_Empty;
+		}
+
+		int flags = MAP_PRIVATE;
+	#if defined(MAP_POPULATE)
+		if (mode == FileLoad_MapPopulate) {
+			flags |= MAP_POPULATE;
+		}
+	#endif
+		void *file_data = mmap(nullptr, cast(size_t)file_size, PROT_READ, flags, fd, 0);
+		if (file_data == MAP_FAILED) {
+			return LoadedFile_Invalid;
+		}
+		if (mode == FileLoad_MapSequential) {
+			madvise(file_data, cast(size_t)file_size, MADV_SEQUENTIAL);
+		}
+
+		memory_mapped_file->handle = nullptr;
+		memory_mapped_file->data   = file_data;
+		memory_mapped_file->size   = cast(isize)file_size;
+		return err;
 	#endif
 	}
 	
 	gbFileContents fc = gb_file_read_contents(permanent_allocator(), true, fullpath);
 
-	if (fc.size > I32_MAX) {
+	if (fc.size > max_size) {
 		err = LoadedFile_FileTooLarge;
 		gb_file_free_contents(&fc);
 	} else if (fc.data != nullptr) {
 		memory_mapped_file->handle = nullptr;
 		memory_mapped_file->data = fc.data;
-		memory_mapped_file->size = cast(i32)fc.size;
+		memory_mapped_file->size = fc.size;
 	} else {
 		gbFile f = {};
 		gbFileError file_err = gb_file_open(&f, fullpath);
@@ -823,7 +911,9 @@ gb_internal LoadedFileError load_file_32(char const *fullpath, LoadedFile *memor
 	return err;
 }
 
-
+gb_internal LoadedFileError load_file_32(char const *fullpath, LoadedFile *memory_mapped_file, bool copy_file_contents) {
+	return load_file(fullpath, memory_mapped_file, copy_file_contents ? FileLoad_Copy : FileLoad_Map, I32_MAX);
+}
 
 
 
@@ -62,13 +62,26 @@ struct MemoryBlock {
 	isize        committed;
 };
 
+enum ThreadArenaKind : uintptr {
+	ThreadArena_Permanent,
+	ThreadArena_Temporary,
+
+	ThreadArena_COUNT,
+};
+
+gb_global char const *thread_arena_kind_strings[ThreadArena_COUNT] = {"Permanent", "Temporary"};
+
+// NOTE: the memory committed for the blocks of the arenas of each kind, across all threads
+gb_global std::atomic<isize> thread_arena_memory_committed[ThreadArena_COUNT];
+
 struct Arena {
-	MemoryBlock * curr_block;
-	isize         minimum_block_size;
+	MemoryBlock *   curr_block;
+	isize           minimum_block_size;
 	// BlockingMutex mutex;
-	isize         temp_count;
-	Thread *      parent_thread;
-	bool          custom_arena;
+	isize           temp_count;
+	Thread *        parent_thread;
+	bool            custom_arena;
+	ThreadArenaKind kind;
 };
 
 enum { DEFAULT_MINIMUM_BLOCK_SIZE = 8ll*1024ll*1024ll };
@@ -77,6 +90,7 @@ gb_global isize DEFAULT_PAGE_SIZE = 4096;
 
 gb_internal MemoryBlock *virtual_memory_alloc(isize size, bool commit);
 gb_internal void virtual_memory_dealloc(MemoryBlock *block);
+gb_internal isize virtual_memory_minimum_block_size(isize minimum_block_size);
 gb_internal void *arena_alloc(Arena *arena, isize min_size, isize alignment);
 gb_internal void arena_free_all(Arena *arena);
 
@@ -99,6 +113,9 @@ gb_internal void thread_init_arenas(Thread *t) {
 
 	t->permanent_arena->minimum_block_size = DEFAULT_MINIMUM_BLOCK_SIZE;
 	t->temporary_arena->minimum_block_size = DEFAULT_MINIMUM_BLOCK_SIZE;
+
+	t->permanent_arena->kind = ThreadArena_Permanent;
+	t->temporary_arena->kind = ThreadArena_Temporary;
 }
 
 gb_internal void *arena_alloc(Arena *arena, isize min_size, isize alignment) {
@@ -112,13 +129,16 @@ gb_internal void *arena_alloc(Arena *arena, isize min_size, isize alignment) {
 
 	if (arena->curr_block == nullptr || (arena->curr_block->used + size) > arena->curr_block->size) {
 		size = align_formula_isize(min_size, alignment);
-		arena->minimum_block_size = gb_max(DEFAULT_MINIMUM_BLOCK_SIZE, arena->minimum_block_size);
+		if (arena->minimum_block_size <= 0) {
+			arena->minimum_block_size = DEFAULT_MINIMUM_BLOCK_SIZE;
+		}
 		
-		isize block_size = gb_max(size, arena->minimum_block_size);
+		isize block_size = gb_max(size, virtual_memory_minimum_block_size(arena->minimum_block_size));
 		
 		MemoryBlock *new_block = virtual_memory_alloc(block_size, true);
 		new_block->prev = arena->curr_block;
 		arena->curr_block = new_block;
+		thread_arena_memory_committed[arena->kind].fetch_add(new_block->size, std::memory_order_relaxed);
 	}
 	
 	MemoryBlock *curr_block = arena->curr_block;
@@ -147,6 +167,8 @@ struct StaticArena {
 
 enum {STATIC_ARENA_DEFAULT_COMMIT_BLOCK_SIZE = 8<<20};
 
+gb_global std::atomic<isize> static_arena_memory_committed;
+
 gb_internal void static_arena_init(StaticArena *arena, isize reserve_size, isize commit_block_size) {
 	GB_ASSERT(gb_is_power_of_two(reserve_size));
 	GB_ASSERT(gb_is_power_of_two(commit_block_size));
@@ -166,6 +188,7 @@ gb_internal void static_arena_commit_memory(StaticArena *arena, isize amount) {
 
 	platform_virtual_memory_commit_internal(arena->data + arena->committed, total_amount);
 	arena->committed += total_amount;
+	static_arena_memory_committed.fetch_add(total_amount, std::memory_order_relaxed);
 }
 
 gb_internal void *static_arena_alloc(StaticArena *arena, isize size, isize alignment) {
@@ -201,6 +224,7 @@ gb_internal void arena_free_all(Arena *arena) {
 	while (arena->curr_block != nullptr) {
 		MemoryBlock *free_block = arena->curr_block;
 		arena->curr_block = free_block->prev;
+		thread_arena_memory_committed[arena->kind].fetch_sub(free_block->size, std::memory_order_relaxed);
 		virtual_memory_dealloc(free_block);
 	}
 }
@@ -213,8 +237,38 @@ struct PlatformMemoryBlock {
 };
 
 gb_global std::atomic<isize> global_platform_memory_total_usage;
+
+// NOTE: Huge pages are opted into with the environment variable ODIN_HUGE_PAGES, as the arenas are
+// used before the flags have been parsed:
+//     thp     - transparent huge pages, with madvise(MADV_HUGEPAGE)
+//     hugetlb - explicit huge pages from the reserved pool, with MAP_HUGETLB, falling back to thp
+enum VirtualMemoryHugePages {
+	VirtualMemoryHugePages_None,
+	VirtualMemoryHugePages_Transparent,
+	VirtualMemoryHugePages_HugeTLB,
+
+	VirtualMemoryHugePages_COUNT,
+};
+
+gb_global char const *virtual_memory_huge_pages_strings[VirtualMemoryHugePages_COUNT] = {"none", "thp", "hugetlb"};
+
+gb_global VirtualMemoryHugePages virtual_memory_huge_pages = VirtualMemoryHugePages_None;
+gb_global isize virtual_memory_huge_page_size = 0;
+gb_global std::atomic<isize> virtual_memory_huge_page_reservations;          // large enough for huge pages
+gb_global std::atomic<isize> virtual_memory_huge_page_reservations_obtained; // successfully advised or mapped
+gb_global std::atomic<isize> virtual_memory_huge_page_reservations_hugetlb;  // mapped from the pool of explicit huge pages
 gb_global PlatformMemoryBlock global_platform_memory_block_sentinel;
 
+// NOTE: A block which uses huge pages is mapped in whole huge pages along with its header and guard pages,
+// so the minimum block leaves room for them rather than spilling into one more huge page
+gb_internal isize virtual_memory_minimum_block_size(isize minimum_block_size) {
+	isize const huge = virtual_memory_huge_page_size;
+	if (virtual_memory_huge_pages == VirtualMemoryHugePages_None || minimum_block_size < huge) {
+		return minimum_block_size;
+	}
+	return align_formula_isize(minimum_block_size, huge) - 2*DEFAULT_PAGE_SIZE;
+}
+
 gb_internal PlatformMemoryBlock *platform_virtual_memory_alloc(isize total_size, bool commit);
 gb_internal void platform_virtual_memory_free(PlatformMemoryBlock *block);
 gb_internal void platform_virtual_memory_protect(void *memory, isize size);
@@ -274,16 +328,111 @@ gb_internal bool  platform_virtual_memory_commit_internal(void *data, isize comm
 	#define MAP_ANONYMOUS MAP_ANON
 	#endif
 
+	#if defined(GB_SYSTEM_LINUX)
+	gb_internal isize platform_huge_page_size(char const *path, char const *format, isize scale) {
+		FILE *f = fopen(path, "r");
+		if (f == nullptr) {
+			return 0;
+		}
+		isize size = 0;
+		char line[256];
+		while (fgets(line, gb_size_of(line), f) != nullptr) {
+			long long value = 0;
+			if (sscanf(line, format, &value) == 1) {
+				size = cast(isize)value * scale;
+				break;
+			}
+		}
+		fclose(f);
+		return gb_is_power_of_two(size) ? size : 0;
+	}
+
+	gb_internal void platform_huge_pages_init(void) {
+		char const *mode = getenv("ODIN_HUGE_PAGES");
+		if (mode == nullptr || mode[0] == 0) {
+			return;
+		}
+		if (gb_strcmp(mode, "thp") == 0) {
+			virtual_memory_huge_pages = VirtualMemoryHugePages_Transparent;
+			virtual_memory_huge_page_size = platform_huge_page_size("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "%lld", 1);
+		} else if (gb_strcmp(mode, "hugetlb") == 0) {
+			virtual_memory_huge_pages = VirtualMemoryHugePages_HugeTLB;
+			virtual_memory_huge_page_size = platform_huge_page_size("/proc/meminfo", "Hugepagesize: %lld kB", 1024);
+		} else {
+			gb_printf_err("ODIN_HUGE_PAGES: expected 'thp' or 'hugetlb', got '%s'\n", mode);
+			return;
+		}
+		if (virtual_memory_huge_page_size <= DEFAULT_PAGE_SIZE) {
+			gb_printf_err("ODIN_HUGE_PAGES: huge pages are not supported by this system\n");
+			virtual_memory_huge_pages = VirtualMemoryHugePages_None;
+		}
+	}
+
+	// NOTE: The reservations which may use huge pages are mapped in whole huge pages, so they must be unmapped the same way
+	gb_internal isize platform_virtual_memory_mapped_size(isize total_size) {
+		if (virtual_memory_huge_pages != VirtualMemoryHugePages_None && total_size >= virtual_memory_huge_page_size) {
+			return align_formula_isize(total_size, virtual_memory_huge_page_size);
+		}
+		return total_size;
+	}
+
+	gb_internal void *platform_virtual_memory_alloc_huge_pages(isize total_size) {
+		isize const huge = virtual_memory_huge_page_size;
+		isize size = platform_virtual_memory_mapped_size(total_size);
+		virtual_memory_huge_page_reservations.fetch_add(1, std::memory_order_relaxed);
+
+		if (virtual_memory_huge_pages == VirtualMemoryHugePages_HugeTLB) {
+			void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_HUGETLB, -1, 0);
+			if (mem != MAP_FAILED) {
+				virtual_memory_huge_page_reservations_obtained.fetch_add(1, std::memory_order_relaxed);
+				virtual_memory_huge_page_reservations_hugetlb.fetch_add(1, std::memory_order_relaxed);
+				return mem;
+			}
+			// NOTE: the pool of huge pages is usually too small (or empty), so fall back to transparent huge pages
+		}
+
+		// NOTE: transparent huge pages are only used for aligned huge pages, so over-reserve and trim the excess
+		u8 *mem = cast(u8 *)mmap(nullptr, size + huge, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+		if (mem == MAP_FAILED) {
+			return MAP_FAILED;
+		}
+		u8 *aligned = cast(u8 *)align_formula_ptr(mem, huge);
+		if (aligned != mem) {
+			munmap(mem, aligned-mem);
+		}
+		isize tail = (mem + size + huge) - (aligned + size);
+		if (tail > 0) {
+			munmap(aligned + size, tail);
+		}
+		if (madvise(aligned, size, MADV_HUGEPAGE) == 0) {
+			virtual_memory_huge_page_reservations_obtained.fetch_add(1, std::memory_order_relaxed);
+		}
+		return aligned;
+	}
+	#endif
+
 	gb_internal void platform_virtual_memory_init(void) {
 		global_platform_memory_block_sentinel.prev = &global_platform_memory_block_sentinel;	
 		global_platform_memory_block_sentinel.next = &global_platform_memory_block_sentinel;
 		
 		DEFAULT_PAGE_SIZE = gb_max(DEFAULT_PAGE_SIZE, cast(isize)sysconf(_SC_PAGE_SIZE));
 		GB_ASSERT(gb_is_power_of_two(DEFAULT_PAGE_SIZE));
+
+	#if defined(GB_SYSTEM_LINUX)
+		platform_huge_pages_init();
+	#endif
 	}
 
 	gb_internal void *platform_virtual_memory_alloc_internal(isize total_size, bool commit) {
-		void *mem = mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+		void *mem = nullptr;
+	#if defined(GB_SYSTEM_LINUX)
+		if (virtual_memory_huge_pages != VirtualMemoryHugePages_None && total_size >= virtual_memory_huge_page_size) {
+			mem = platform_virtual_memory_alloc_huge_pages(total_size);
+		} else
+	#endif
+		{
+			mem = mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+		}
 		if (mem == MAP_FAILED) {
 			gb_printf_err("Out of Virtual memory, oh no...\n");
 			gb_printf_err("Requested: %lld bytes\n", cast(long long)total_size);
@@ -310,11 +459,16 @@ gb_internal bool  platform_virtual_memory_commit_internal(void *data, isize comm
 	gb_internal void platform_virtual_memory_free(PlatformMemoryBlock *block) {
 		isize size = block->total_size;
 		global_platform_memory_total_usage.fetch_sub(size);
+	#if defined(GB_SYSTEM_LINUX)
+		munmap(block, platform_virtual_memory_mapped_size(size));
+	#else
 		munmap(block, size);
+	#endif
 	}
 	gb_internal void platform_virtual_memory_protect(void *memory, isize size) {
 		int err = mprotect(memory, size, PROT_NONE);
-		GB_ASSERT(err == 0);
+		// NOTE: explicit huge pages cannot be protected in parts, so those blocks have no overflow protection
+		GB_ASSERT(err == 0 || virtual_memory_huge_pages == VirtualMemoryHugePages_HugeTLB);
 	}
 
 	gb_internal bool platform_virtual_memory_commit_internal(void *data, isize commit_amount) {
@@ -338,6 +492,11 @@ gb_internal MemoryBlock *virtual_memory_alloc(isize size, bool commit) {
 	bool do_protection = false;
 	{ // overflow protection
 		isize rounded_size = align_formula_isize(size, page_size);
+		if (virtual_memory_huge_pages != VirtualMemoryHugePages_None && rounded_size + 2*page_size >= virtual_memory_huge_page_size) {
+			// NOTE: the block is mapped in whole huge pages, so it is given the rest of the last one
+			rounded_size = align_formula_isize(rounded_size + 2*page_size, virtual_memory_huge_page_size) - 2*page_size;
+			size = rounded_size;
+		}
 		total_size     = rounded_size + 2*page_size;
 		base_offset    = page_size + rounded_size - size;
 		protect_offset = page_size + rounded_size;
@@ -421,6 +580,7 @@ void arena_temp_end(ArenaTemp const &temp) {
 			MemoryBlock *free_block = arena->curr_block;
 			if (free_block != nullptr) {
 				arena->curr_block = free_block->prev;
+				thread_arena_memory_committed[arena->kind].fetch_sub(free_block->size, std::memory_order_relaxed);
 				virtual_memory_dealloc(free_block);
 			}
 		}
@@ -501,13 +661,8 @@ gb_internal GB_ALLOCATOR_PROC(arena_allocator_proc) {
 }
 
 
-enum ThreadArenaKind : uintptr {
-	ThreadArena_Permanent,
-	ThreadArena_Temporary,
-};
-
-gb_global Arena default_permanent_arena = {nullptr, DEFAULT_MINIMUM_BLOCK_SIZE};
-gb_global Arena default_temporary_arena = {nullptr, DEFAULT_MINIMUM_BLOCK_SIZE};
+gb_global Arena default_permanent_arena = {nullptr, DEFAULT_MINIMUM_BLOCK_SIZE, 0, nullptr, false, ThreadArena_Permanent};
+gb_global Arena default_temporary_arena = {nullptr, DEFAULT_MINIMUM_BLOCK_SIZE, 0, nullptr, false, ThreadArena_Temporary};
 
 
 gb_internal Arena *get_arena(ThreadArenaKind kind) {
@@ -272,8 +272,9 @@ gb_internal OdinDocPosition odin_doc_token_pos_cast(OdinDocWriter *w, TokenPos c
 
 	OdinDocPosition doc_pos = {};
 	doc_pos.file   = file_index;
-	doc_pos.line   = cast(u32)pos.line;
-	doc_pos.column = cast(u32)pos.column;
+	TokenLineColumn lc = token_pos_line_column(pos);
+	doc_pos.line   = cast(u32)lc.line;
+	doc_pos.column = cast(u32)lc.column;
 	doc_pos.offset = cast(u32)pos.offset;
 	return doc_pos;
 }
@@ -27,6 +27,10 @@ struct ErrorCollector {
 
 gb_global ErrorCollector global_error_collector;
 
+// NOTE: Whilst set, the errors of this thread are held back rather than collected, e.g. for the chunks of a
+// file parsed in parallel which may be discarded
+gb_global gb_thread_local Array<ErrorValue> *error_value_buffer = nullptr;
+
 
 gb_internal void push_error_value(TokenPos const &pos, ErrorValueKind kind = ErrorValue_Error) {
 	GB_ASSERT_MSG(global_error_collector.curr_error_value_set.load() == false, "Possible race condition in error handling system, please report this with an issue");
@@ -40,7 +44,11 @@ gb_internal void push_error_value(TokenPos const &pos, ErrorValueKind kind = Err
 gb_internal void pop_error_value(void) {
 	mutex_lock(&global_error_collector.mutex);
 	if (global_error_collector.curr_error_value_set.load()) {
-		array_add(&global_error_collector.error_values, global_error_collector.curr_error_value);
+		if (error_value_buffer != nullptr) {
+			array_add(error_value_buffer, global_error_collector.curr_error_value);
+		} else {
+			array_add(&global_error_collector.error_values, global_error_collector.curr_error_value);
+		}
 
 		global_error_collector.curr_error_value = {};
 		global_error_collector.curr_error_value_set.store(false);
@@ -49,6 +57,13 @@ gb_internal void pop_error_value(void) {
 }
 
 
+gb_internal void flush_error_value_buffer(Array<ErrorValue> *buffer) {
+	mutex_lock(&global_error_collector.mutex);
+	array_add_elems(&global_error_collector.error_values, buffer->data, buffer->count);
+	mutex_unlock(&global_error_collector.mutex);
+	array_clear(buffer);
+}
+
 gb_internal void try_pop_error_value(void) {
 	if (!global_error_collector.in_block.load()) {
 		pop_error_value();
@@ -62,6 +77,14 @@ gb_internal ErrorValue *get_error_value(void) {
 
 
 
+// NOTE: The errors reported by the current thread, so that the errors of some work done on a single
+// thread can be counted whilst other threads report errors of their own
+gb_global gb_thread_local i64 thread_error_count;
+
+gb_internal i64 current_thread_error_count(void) {
+	return thread_error_count;
+}
+
 gb_internal bool any_errors(void) {
 	return global_error_collector.count.load() != 0;
 }
@@ -122,6 +145,19 @@ gb_internal bool thread_safe_set_ast_file_from_id(i32 index, AstFile *file) {
 	return ok;
 }
 
+// NOTE: Replaces the file of an id, e.g. for an edited file which is parsed again in place of its previous version
+gb_internal void thread_safe_replace_ast_file_from_id(i32 index, AstFile *file) {
+	GB_ASSERT(index >= 0);
+	mutex_lock(&global_files_mutex);
+
+	if (index >= global_files.count) {
+		array_resize(&global_files, index+1);
+	}
+	global_files[index] = file;
+
+	mutex_unlock(&global_files_mutex);
+}
+
 gb_internal String get_file_path_string(i32 index) {
 	GB_ASSERT(index >= 0);
 	// mutex_lock(&global_error_collector.path_mutex);
@@ -447,10 +483,12 @@ gb_internal isize show_error_on_line(TokenPos const &pos, TokenPos end) {
 	i32 squiggle_length = 0;
 	bool trailing_squiggle = false;
 
+	TokenLineColumn pos_lc = token_pos_line_column(pos);
+	TokenLineColumn end_lc = token_pos_line_column(end);
 	if (end.file_id == pos.file_id) {
 		// The error has an endpoint.
 
-		if (end.line > pos.line) {
+		if (end_lc.line > pos_lc.line) {
 			// Error goes to next line.
 			// Always show the ellipsis in this case
 			show_right_ellipsis = true;
@@ -460,9 +498,9 @@ gb_internal isize show_error_on_line(TokenPos const &pos, TokenPos end) {
 				trailing_squiggle = true;
 			}
 
-		} else if (end.line == pos.line && end.column > pos.column) {
+		} else if (end_lc.line == pos_lc.line && end.offset > pos.offset) {
 			// Error terminates before line end.
-			i32 adjusted_end_index = graphemes[error_start_index_graphemes].byte_index + end.column - pos.column;
+			i32 adjusted_end_index = graphemes[error_start_index_graphemes].byte_index + end.offset - pos.offset;
 
 			for (i32 i = error_start_index_graphemes; i < line_length_graphemes; i += 1) {
 				if (graphemes[i].byte_index >= adjusted_end_index) {
@@ -534,6 +572,7 @@ gb_internal void error_out_coloured(char const *str, TerminalStyle style, Termin
 
 gb_internal void error_va(TokenPos const &pos, TokenPos end, char const *fmt, va_list va) {
 	global_error_collector.count.fetch_add(1);
+	thread_error_count += 1;
 	mutex_lock(&global_error_collector.mutex);
 	if (global_error_collector.count > MAX_ERROR_COLLECTOR_COUNT()) {
 		print_all_errors();
@@ -541,7 +580,7 @@ gb_internal void error_va(TokenPos const &pos, TokenPos end, char const *fmt, va
 	}
 
 	push_error_value(pos, ErrorValue_Error);
-	if (pos.line == 0) {
+	if (!token_pos_has_line(pos)) {
 		error_out_empty();
 		error_out_coloured("Error: ", TerminalStyle_Normal, TerminalColour_Red);
 		error_out_va(fmt, va);
@@ -576,7 +615,7 @@ gb_internal void warning_va(TokenPos const &pos, TokenPos end, char const *fmt,
 
 	push_error_value(pos, ErrorValue_Warning);
 
-	if (pos.line == 0) {
+	if (!token_pos_has_line(pos)) {
 		error_out_empty();
 		error_out_coloured("Warning: ", TerminalStyle_Normal, TerminalColour_Yellow);
 		error_out_va(fmt, va);
@@ -604,6 +643,7 @@ gb_internal void error_line_va(char const *fmt, va_list va) {
 
 gb_internal void error_no_newline_va(TokenPos const &pos, char const *fmt, va_list va) {
 	global_error_collector.count.fetch_add(1);
+	thread_error_count += 1;
 	mutex_lock(&global_error_collector.mutex);
 	if (global_error_collector.count.load() > MAX_ERROR_COLLECTOR_COUNT()) {
 		print_all_errors();
@@ -612,7 +652,7 @@ gb_internal void error_no_newline_va(TokenPos const &pos, char const *fmt, va_li
 
 	push_error_value(pos, ErrorValue_Error);
 
-	if (pos.line == 0) {
+	if (!token_pos_has_line(pos)) {
 		error_out_empty();
 		error_out_coloured("Error: ", TerminalStyle_Normal, TerminalColour_Red);
 		error_out_va(fmt, va);
@@ -636,6 +676,7 @@ gb_internal void error_no_newline_va(TokenPos const &pos, char const *fmt, va_li
 
 gb_internal void syntax_error_va(TokenPos const &pos, TokenPos end, char const *fmt, va_list va) {
 	global_error_collector.count.fetch_add(1);
+	thread_error_count += 1;
 	mutex_lock(&global_error_collector.mutex);
 	if (global_error_collector.count > MAX_ERROR_COLLECTOR_COUNT()) {
 		print_all_errors();
@@ -644,7 +685,7 @@ gb_internal void syntax_error_va(TokenPos const &pos, TokenPos end, char const *
 
 	push_error_value(pos, ErrorValue_Warning);
 
-	if (pos.line == 0) {
+	if (!token_pos_has_line(pos)) {
 		error_out_empty();
 		error_out_coloured("Syntax Error: ", TerminalStyle_Normal, TerminalColour_Red);
 		error_out_va(fmt, va);
@@ -668,6 +709,7 @@ gb_internal void syntax_error_va(TokenPos const &pos, TokenPos end, char const *
 
 gb_internal void syntax_error_with_verbose_va(TokenPos const &pos, TokenPos end, char const *fmt, va_list va) {
 	global_error_collector.count.fetch_add(1);
+	thread_error_count += 1;
 	mutex_lock(&global_error_collector.mutex);
 	if (global_error_collector.count > MAX_ERROR_COLLECTOR_COUNT()) {
 		print_all_errors();
@@ -676,7 +718,7 @@ gb_internal void syntax_error_with_verbose_va(TokenPos const &pos, TokenPos end,
 
 	push_error_value(pos, ErrorValue_Warning);
 
-	if (pos.line == 0) {
+	if (!token_pos_has_line(pos)) {
 		error_out_empty();
 		error_out_coloured("Syntax Error: ", TerminalStyle_Normal, TerminalColour_Red);
 		error_out_va(fmt, va);
@@ -715,7 +757,7 @@ gb_internal void syntax_warning_va(TokenPos const &pos, TokenPos end, char const
 
 	push_error_value(pos, ErrorValue_Warning);
 
-	if (pos.line == 0) {
+	if (!token_pos_has_line(pos)) {
 		error_out_empty();
 		error_out_coloured("Syntax Warning: ", TerminalStyle_Normal, TerminalColour_Yellow);
 		error_out_va(fmt, va);
@@ -966,9 +1008,11 @@ gb_internal void print_all_errors(void) {
 				}
 				res = gb_string_append_fmt(res, "\",\n");
 				res = gb_string_append_fmt(res, "\t\t\t\t\"offset\": %d,\n", ev.pos.offset);
-				res = gb_string_append_fmt(res, "\t\t\t\t\"line\": %d,\n", ev.pos.line);
-				res = gb_string_append_fmt(res, "\t\t\t\t\"column\": %d,\n", ev.pos.column);
-				i32 end_column = gb_max(ev.end.column, ev.pos.column);
+				TokenLineColumn pos_lc = token_pos_line_column(ev.pos);
+				TokenLineColumn end_lc = token_pos_line_column(ev.end);
+				res = gb_string_append_fmt(res, "\t\t\t\t\"line\": %d,\n", pos_lc.line);
+				res = gb_string_append_fmt(res, "\t\t\t\t\"column\": %d,\n", pos_lc.column);
+				i32 end_column = gb_max(end_lc.column, pos_lc.column);
 				res = gb_string_append_fmt(res, "\t\t\t\t\"end_column\": %d\n", end_column);
 				res = gb_string_append_fmt(res, "\t\t\t},\n");
 			} else {
@@ -1031,3 +1075,17 @@ gb_internal void print_all_errors(void) {
 
 	errors_already_printed = true;
 }
+
+// NOTE: Forgets every error and warning reported so far, e.g. once the errors of an edited file have been
+// printed and the previous version of the file is used again
+gb_internal void clear_all_errors(void) {
+	mutex_lock(&global_error_collector.mutex);
+	for (ErrorValue &ev : global_error_collector.error_values) {
+		array_free(&ev.msg);
+	}
+	array_clear(&global_error_collector.error_values);
+	global_error_collector.count.store(0);
+	global_error_collector.warning_count.store(0);
+	errors_already_printed = false;
+	mutex_unlock(&global_error_collector.mutex);
+}
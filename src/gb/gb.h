@@ -5097,9 +5097,18 @@ u64 gb_murmur64_seed(void const *data_, isize len, u64 seed) {
 	}
 
 	gb_internal GB_FILE_READ_AT_PROC(gb__posix_file_read) {
-		isize res = pread(fd.i, buffer, size, offset);
-		if (res < 0) return false;
-		if (bytes_read) *bytes_read = res;
+		// NOTE: Linux transfers at most 0x7ffff000 bytes per call, so larger reads are done in parts
+		isize total = 0;
+		while (total < size) {
+			isize res = pread(fd.i, cast(u8 *)buffer + total, size - total, offset + total);
+			if (res < 0) {
+				if (errno == EINTR) continue;
+				return false;
+			}
+			if (res == 0) break;
+			total += res;
+		}
+		if (bytes_read) *bytes_read = total;
 		return true;
 	}
 
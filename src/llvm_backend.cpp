@@ -179,29 +179,33 @@ gb_internal void lb_set_entity_from_other_modules_linkage_correctly(lbModule *ot
 	mpsc_enqueue(&other_module->gen->entities_to_correct_linkage, lbEntityCorrection{other_module, e, cname});
 }
 
-gb_internal void lb_correct_entity_linkage(lbGenerator *gen) {
-	for (lbEntityCorrection ec = {}; mpsc_dequeue(&gen->entities_to_correct_linkage, &ec); /**/) {
-		LLVMValueRef other_global = nullptr;
-		if (ec.e->kind == Entity_Variable) {
-			other_global = LLVMGetNamedGlobal(ec.other_module->mod, ec.cname);
-			if (other_global && (LLVMGetInitializer(other_global) != nullptr || LLVMIsExternallyInitialized(other_global))) {
-				LLVM_SET_INTERNAL_WEAK_LINKAGE(other_global);
-				if (!ec.e->Variable.is_export && !ec.e->Variable.is_foreign) {
-					LLVMSetVisibility(other_global, LLVMHiddenVisibility);
-				}
+gb_internal void lb_correct_entity_linkage(lbEntityCorrection const &ec) {
+	LLVMValueRef other_global = nullptr;
+	if (ec.e->kind == Entity_Variable) {
+		other_global = LLVMGetNamedGlobal(ec.other_module->mod, ec.cname);
+		if (other_global && (LLVMGetInitializer(other_global) != nullptr || LLVMIsExternallyInitialized(other_global))) {
+			LLVM_SET_INTERNAL_WEAK_LINKAGE(other_global);
+			if (!ec.e->Variable.is_export && !ec.e->Variable.is_foreign) {
+				LLVMSetVisibility(other_global, LLVMHiddenVisibility);
 			}
-		} else if (ec.e->kind == Entity_Procedure) {
-			other_global = LLVMGetNamedFunction(ec.other_module->mod, ec.cname);
-			if (other_global && LLVMCountBasicBlocks(other_global) != 0) {
-				LLVM_SET_INTERNAL_WEAK_LINKAGE(other_global);
-				if (!ec.e->Procedure.is_export && !ec.e->Procedure.is_foreign) {
-					LLVMSetVisibility(other_global, LLVMHiddenVisibility);
-				}
+		}
+	} else if (ec.e->kind == Entity_Procedure) {
+		other_global = LLVMGetNamedFunction(ec.other_module->mod, ec.cname);
+		if (other_global && LLVMCountBasicBlocks(other_global) != 0) {
+			LLVM_SET_INTERNAL_WEAK_LINKAGE(other_global);
+			if (!ec.e->Procedure.is_export && !ec.e->Procedure.is_foreign) {
+				LLVMSetVisibility(other_global, LLVMHiddenVisibility);
 			}
 		}
 	}
 }
 
+gb_internal void lb_correct_entity_linkage(lbGenerator *gen) {
+	for (lbEntityCorrection ec = {}; mpsc_dequeue(&gen->entities_to_correct_linkage, &ec); /**/) {
+		lb_correct_entity_linkage(ec);
+	}
+}
+
 
 gb_internal void lb_emit_init_context(lbProcedure *p, lbAddr addr) {
 	TEMPORARY_ALLOCATOR_GUARD();
@@ -2067,7 +2071,7 @@ gb_internal bool lb_init_global_var(lbModule *m, lbProcedure *p, Entity *e, Ast
 		Type *t = type_deref(var.var.type);
 
 		// NOTE: 'any' literals or 'any's that point to other variables can be handled by the generic path
-		if (is_type_any(t) && !is_type_any(var.init.type) && init_expr->tav.mode != Addressing_Variable) {
+		if (is_type_any(t) && !is_type_any(var.init.type) && init_expr->tav().mode != Addressing_Variable) {
 			// NOTE(bill): Edge case for 'any' type
 			Type *var_type = default_type(var.init.type);
 			gbString var_name = gb_string_make(permanent_allocator(), "__$global_any::");
@@ -2243,11 +2247,30 @@ gb_internal GB_COMPARE_PROC(llvm_global_entity_cmp) {
 		return cast(i32)(x->kind - y->kind);
 	}
 
+	// NOTE: the token of a specialization is that of the last use of its polymorphic procedure that was
+	// checked, so the position of the polymorphic procedure itself is used, and the specializations are
+	// ordered by their types, so that the module is the same between builds.
+	// The canonical type hash is not enough for that, as e.g. `int` and `i64` share it.
+	TokenPos pos_x = x->token.pos;
+	TokenPos pos_y = y->token.pos;
+	if (x->decl_info != nullptr && x->decl_info->para_poly_original != nullptr) {
+		pos_x = x->decl_info->para_poly_original->token.pos;
+	}
+	if (y->decl_info != nullptr && y->decl_info->para_poly_original != nullptr) {
+		pos_y = y->decl_info->para_poly_original->token.pos;
+	}
+
 	i32 cmp = 0;
-	cmp = token_pos_cmp(x->token.pos, y->token.pos);
-	if (!cmp) {
+	cmp = token_pos_cmp(pos_x, pos_y);
+	if (cmp) {
 		return cmp;
 	}
+	if (x->type != nullptr && y->type != nullptr) {
+		TEMPORARY_ALLOCATOR_GUARD();
+		gbString type_x = type_to_string(x->type, temporary_allocator(), false);
+		gbString type_y = type_to_string(y->type, temporary_allocator(), false);
+		cmp = string_compare(make_string_c(type_x), make_string_c(type_y));
+	}
 	return cmp;
 }
 
@@ -2365,11 +2388,86 @@ gb_internal bool lb_is_module_empty(lbModule *m) {
 	return true;
 }
 
+gb_internal void lb_object_cache_store(lbModule *m, String const &filepath_obj) {
+	if (m->object_cache_path.len == 0) {
+		return;
+	}
+	// NOTE: copy then rename so that a concurrent build never sees a partially written object
+	gbString tmp = gb_string_make_length(heap_allocator(), m->object_cache_path.text, m->object_cache_path.len);
+	defer (gb_string_free(tmp));
+	tmp = gb_string_append_fmt(tmp, "-%p.tmp", m);
+
+	if (gb_file_copy(cast(char const *)filepath_obj.text, tmp, false)) {
+		if (!gb_file_move(tmp, cast(char const *)m->object_cache_path.text)) {
+			gb_file_remove(tmp);
+		}
+	}
+}
+
+// NOTE: Releases the LLVM module, and the AST and tokens of its package, with -release-emitted-packages.
+// Every procedure has been generated by the time any object is emitted, so neither is needed again once
+// the module has been written.
+gb_internal void lb_release_emitted_module(lbModule *m) {
+	if (!build_context.release_emitted_packages || m->mod == nullptr) {
+		return;
+	}
+
+	if (m->polymorphic_module != m && m->file == nullptr) {
+		if (m->pkg != nullptr) {
+			for (AstFile *f : m->pkg->files) {
+				ast_file_release_memory(f);
+			}
+		} else if (m == &m->gen->default_module && !USE_SEPARATE_MODULES) {
+			for (auto const &entry : m->info->packages) {
+				for (AstFile *f : entry.value->files) {
+					ast_file_release_memory(f);
+				}
+			}
+		}
+	}
+
+	for (i32 i = 0; i < lbFunctionPassManager_COUNT; i++) {
+		if (m->function_pass_managers[i] != nullptr) {
+			LLVMDisposePassManager(m->function_pass_managers[i]);
+			m->function_pass_managers[i] = nullptr;
+		}
+	}
+	if (m->debug_builder != nullptr) {
+		LLVMDisposeDIBuilder(m->debug_builder);
+		m->debug_builder = nullptr;
+	}
+	LLVMDisposeBuilder(m->const_dummy_builder);
+	m->const_dummy_builder = nullptr;
+
+	LLVMDisposeModule(m->mod);
+	LLVMContextDispose(m->ctx);
+	LLVMDisposeTargetMachine(m->target_machine);
+	m->mod            = nullptr;
+	m->ctx            = nullptr;
+	m->target_machine = nullptr;
+
+	map_destroy(&m->types);
+	map_destroy(&m->func_raw_types);
+	map_destroy(&m->struct_field_remapping);
+	map_destroy(&m->values);
+	map_destroy(&m->soa_values);
+	string_map_destroy(&m->members);
+	string_map_destroy(&m->procedures);
+	map_destroy(&m->procedure_values);
+	string_map_destroy(&m->const_strings);
+	map_destroy(&m->function_type_map);
+	string_map_destroy(&m->gen_procs);
+	map_destroy(&m->debug_values);
+	map_destroy(&m->exact_value_compound_literal_addr_map);
+	array_free(&m->generated_procedures);
+}
+
 struct lbLLVMEmitWorker {
 	LLVMTargetMachineRef target_machine;
 	LLVMCodeGenFileType code_gen_file_type;
 	String filepath_obj;
 	lbModule *m;
+	bool is_empty; // NOTE: only known once the module is ready when the object generation is pipelined
 };
 
 gb_internal WORKER_TASK_PROC(lb_llvm_emit_worker_proc) {
@@ -2379,6 +2477,16 @@ gb_internal WORKER_TASK_PROC(lb_llvm_emit_worker_proc) {
 
 	auto wd = cast(lbLLVMEmitWorker *)data;
 
+	if (wd->m->object_cache_hit) {
+		if (!gb_file_copy(cast(char const *)wd->m->object_cache_path.text, cast(char const *)wd->filepath_obj.text, false)) {
+			gb_printf_err("Failed to copy cached object file: %.*s\n", LIT(wd->m->object_cache_path));
+			exit_with_errors();
+		}
+		debugf("Copied Cached File: %.*s\n", LIT(wd->filepath_obj));
+		lb_release_emitted_module(wd->m);
+		return 0;
+	}
+
 	if (build_context.lto_kind != LTO_None) {
 		if (LLVMWriteBitcodeToFile(wd->m->mod, cast(char *)wd->filepath_obj.text)) {
 			gb_printf_err("Failed to write bitcode file: %.*s\n", LIT(wd->filepath_obj));
@@ -2389,6 +2497,9 @@ gb_internal WORKER_TASK_PROC(lb_llvm_emit_worker_proc) {
 		exit_with_errors();
 	}
 	debugf("Generated File: %.*s\n", LIT(wd->filepath_obj));
+
+	lb_object_cache_store(wd->m, wd->filepath_obj);
+	lb_release_emitted_module(wd->m);
 	return 0;
 }
 
@@ -2400,6 +2511,9 @@ gb_internal void lb_llvm_function_pass_per_function_internal(lbModule *module, l
 
 gb_internal WORKER_TASK_PROC(lb_llvm_function_pass_per_module) {
 	lbModule *m = cast(lbModule *)data;
+	if (m->object_cache_hit) {
+		return 0;
+	}
 	{
 		GB_ASSERT(m->function_pass_managers[lbFunctionPassManager_default] == nullptr);
 
@@ -2473,10 +2587,17 @@ struct lbLLVMModulePassWorkerData {
 	lbModule *m;
 	LLVMTargetMachineRef target_machine;
 	bool do_threading;
+
+	// NOTE: only used when the object generation is pipelined with the module passes
+	Slice<lbEntityCorrection> corrections;
+	lbLLVMEmitWorker *emit;
 };
 
 gb_internal WORKER_TASK_PROC(lb_llvm_module_pass_worker_proc) {
 	auto wd = cast(lbLLVMModulePassWorkerData *)data;
+	if (wd->m->object_cache_hit) {
+		return 0;
+	}
 
 	LLVMPassManagerRef module_pass_manager = LLVMCreatePassManager();
 	LLVMRunPassManager(module_pass_manager, wd->m->mod);
@@ -2693,6 +2814,103 @@ gb_internal void lb_llvm_module_passes_and_verification(lbGenerator *gen, bool d
 	}
 }
 
+// NOTE: Runs every step after the function passes for a single module, so that the objects of the
+// modules which are ready are emitted while the passes of the others are still running
+gb_internal WORKER_TASK_PROC(lb_llvm_module_pipeline_worker_proc) {
+	auto wd = cast(lbLLVMModulePassWorkerData *)data;
+	GB_ASSERT(!wd->do_threading);
+
+	lb_run_remove_unused_function_pass(wd->m);
+	lb_run_remove_unused_globals_pass(wd->m);
+
+	lb_llvm_module_pass_worker_proc(wd);
+
+	// NOTE: the linkage of a module is only corrected after its passes, and it determines whether it is empty
+	for (lbEntityCorrection const &ec : wd->corrections) {
+		lb_correct_entity_linkage(ec);
+	}
+
+	wd->emit->is_empty = lb_is_module_empty(wd->m);
+	if (!wd->emit->is_empty) {
+		lb_llvm_emit_worker_proc(wd->emit);
+	} else {
+		lb_release_emitted_module(wd->m);
+	}
+	return 0;
+}
+
+// NOTE: Every module only depends upon its own previous steps once all of the procedures have been generated,
+// so each one is scheduled as soon as its function passes are done rather than after those of every module.
+// The procedure generation itself is not part of the graph, as generating the procedures of a module may add
+// procedures to be generated by another, see lb_generate_missing_procedures
+gb_internal void lb_llvm_module_pipeline(lbGenerator *gen, bool function_passes) {
+	LLVMCodeGenFileType code_gen_file_type = LLVMObjectFile;
+	if (build_context.build_mode == BuildMode_Assembly) {
+		code_gen_file_type = LLVMAssemblyFile;
+	}
+
+	auto corrections = array_make<lbEntityCorrection>(heap_allocator());
+	defer (array_free(&corrections));
+	for (lbEntityCorrection ec = {}; mpsc_dequeue(&gen->entities_to_correct_linkage, &ec); /**/) {
+		array_add(&corrections, ec);
+	}
+
+	auto workers = array_make<lbLLVMModulePassWorkerData *>(heap_allocator(), 0, gen->modules.count);
+	defer (array_free(&workers));
+	auto nodes = array_make<TaskNode *>(heap_allocator(), 0, 2*gen->modules.count);
+	defer (array_free(&nodes));
+
+	TaskGroup group = {};
+	for (auto const &entry : gen->modules) {
+		lbModule *m = entry.value;
+
+		auto wd = permanent_alloc_item<lbLLVMModulePassWorkerData>();
+		wd->m = m;
+		wd->target_machine = m->target_machine;
+		wd->do_threading = false;
+
+		auto module_corrections = array_make<lbEntityCorrection>(permanent_allocator());
+		for (lbEntityCorrection const &ec : corrections) {
+			if (ec.other_module == m) {
+				array_add(&module_corrections, ec);
+			}
+		}
+		wd->corrections = slice_from_array(module_corrections);
+
+		wd->emit = permanent_alloc_item<lbLLVMEmitWorker>();
+		wd->emit->target_machine = m->target_machine;
+		wd->emit->code_gen_file_type = code_gen_file_type;
+		wd->emit->filepath_obj = lb_filepath_obj_for_module(m);
+		wd->emit->m = m;
+
+		array_add(&workers, wd);
+
+		TaskNode *pipeline_node = permanent_alloc_item<TaskNode>();
+		task_node_init(pipeline_node, &group, lb_llvm_module_pipeline_worker_proc, wd);
+		if (function_passes) {
+			TaskNode *function_pass_node = permanent_alloc_item<TaskNode>();
+			task_node_init(function_pass_node, &group, lb_llvm_function_pass_per_module, m);
+			task_node_add_dependency(pipeline_node, function_pass_node);
+			array_add(&nodes, function_pass_node);
+		}
+		array_add(&nodes, pipeline_node);
+	}
+
+	for (TaskNode *node : nodes) {
+		thread_pool_start_task_node(node);
+	}
+	thread_pool_wait(&group);
+
+	for (lbLLVMModulePassWorkerData *wd : workers) {
+		if (wd->emit->is_empty) {
+			continue;
+		}
+		gen->used_module_count += 1;
+		array_add(&gen->output_object_paths, wd->emit->filepath_obj);
+		array_add(&gen->output_temp_paths, lb_filepath_ll_for_module(wd->m));
+	}
+}
+
 gb_internal String lb_filepath_ll_for_module(lbModule *m) {
 	String path = concatenate3_strings(permanent_allocator(),
 		build_context.build_paths[BuildPath_Output].basename,
@@ -2792,6 +3010,147 @@ gb_internal void lb_add_foreign_library_paths(lbGenerator *gen) {
 	}
 }
 
+gb_internal String lb_object_cache_dir(void) {
+	String dir = build_context.build_paths[BuildPath_Output].basename;
+	dir = concatenate_strings(permanent_allocator(), dir, str_lit("/.odin-cache"));
+	(void)check_if_exists_directory_otherwise_create(dir);
+	dir = concatenate_strings(permanent_allocator(), dir, str_lit("/objects"));
+	(void)check_if_exists_directory_otherwise_create(dir);
+	return dir;
+}
+
+// NOTE: Everything which changes the output of the passes and emission but which is not
+// already recorded within the module's bitcode itself
+gb_internal u64 lb_object_cache_options_hash(void) {
+	TEMPORARY_ALLOCATOR_GUARD();
+
+	String llvm_cpu = get_final_microarchitecture();
+
+	gbString s = gb_string_make(temporary_allocator(), "");
+	s = gb_string_append_fmt(s, "%.*s %s\n", LIT(ODIN_VERSION), LLVM_VERSION_STRING);
+#ifdef GIT_SHA
+	s = gb_string_append_fmt(s, "%s\n", GIT_SHA);
+#endif
+	s = gb_string_append_fmt(s, "%.*s\n", LIT(build_context.metrics.target_triplet));
+	s = gb_string_append_fmt(s, "%.*s\n", LIT(llvm_cpu));
+	s = gb_string_append_fmt(s, "%.*s\n", LIT(build_context.target_features_string));
+	s = gb_string_append_fmt(s, "%d %d %d %d\n",
+		build_context.optimization_level,
+		build_context.build_mode,
+		build_context.reloc_mode,
+		build_context.metrics.os);
+	s = gb_string_append_fmt(s, "%u %d %d %d\n",
+		build_context.sanitizer_flags,
+		build_context.fast_isel,
+		build_context.internal_llvm_no_sroa,
+		build_context.ODIN_DEBUG);
+
+	return gb_murmur64(s, gb_string_length(s));
+}
+
+gb_internal WORKER_TASK_PROC(lb_object_cache_lookup_worker_proc) {
+	lbModule *m = cast(lbModule *)data;
+
+	// NOTE: the names of the static variables hold their entity ids, which depend on the order in which
+	// the procedures were checked, so they are numbered in the order of their generation for the key instead
+	// and are given their names back right after, so the output is unaffected
+	TEMPORARY_ALLOCATOR_GUARD();
+	auto static_names = array_make<String>(temporary_allocator(), m->static_variables.count);
+	for_array(i, m->static_variables) {
+		size_t len = 0;
+		char const *name = LLVMGetValueName2(m->static_variables[i], &len);
+		static_names[i] = copy_string(temporary_allocator(), make_string(cast(u8 const *)name, cast(isize)len));
+
+		char key_name[32] = {};
+		isize key_name_len = gb_snprintf(key_name, gb_size_of(key_name), ".static-%td", i) - 1;
+		LLVMSetValueName2(m->static_variables[i], key_name, cast(size_t)key_name_len);
+	}
+
+	LLVMMemoryBufferRef buf = LLVMWriteBitcodeToMemoryBuffer(m->mod);
+	defer (LLVMDisposeMemoryBuffer(buf));
+
+	for_array(i, m->static_variables) {
+		LLVMSetValueName2(m->static_variables[i], cast(char const *)static_names[i].text, cast(size_t)static_names[i].len);
+	}
+
+	u64 key = gb_murmur64_seed(LLVMGetBufferStart(buf), cast(isize)LLVMGetBufferSize(buf), m->object_cache_key);
+	m->object_cache_key = key;
+
+	String ext = infer_object_extension_from_build_context();
+	gbString path = gb_string_make(heap_allocator(), "");
+	path = gb_string_append_length(path, m->gen->object_cache_dir.text, m->gen->object_cache_dir.len);
+	path = gb_string_append_fmt(path, "/%016llx.%.*s", cast(unsigned long long)key, LIT(ext));
+
+	m->object_cache_path = make_string(cast(u8 *)path, gb_string_length(path));
+	m->object_cache_hit  = gb_file_exists(path);
+	return 0;
+}
+
+// NOTE: The key of each module is the hash of its unoptimized bitcode, so any module which
+// hits the cache can skip both the pass pipeline and the object emission entirely
+gb_internal void lb_object_cache_lookup(lbGenerator *gen, bool do_threading) {
+	if (build_context.lto_kind != LTO_None) {
+		return;
+	}
+	switch (build_context.build_mode) {
+	case BuildMode_Executable:
+	case BuildMode_DynamicLibrary:
+	case BuildMode_StaticLibrary:
+	case BuildMode_Object:
+		break;
+	default:
+		return;
+	}
+
+	gen->object_cache_dir = lb_object_cache_dir();
+
+	u64 options_hash = lb_object_cache_options_hash();
+	for (auto const &entry : gen->modules) {
+		lbModule *m = entry.value;
+		m->object_cache_key = options_hash;
+	}
+
+	// NOTE: the linkage corrections are applied after the passes, so they must be a part of the key
+	auto corrections = array_make<lbEntityCorrection>(heap_allocator());
+	defer (array_free(&corrections));
+	for (lbEntityCorrection ec = {}; mpsc_dequeue(&gen->entities_to_correct_linkage, &ec); /**/) {
+		array_add(&corrections, ec);
+	}
+	for (lbEntityCorrection const &ec : corrections) {
+		ec.other_module->object_cache_key += fnv64a(ec.cname, gb_strlen(ec.cname));
+		mpsc_enqueue(&gen->entities_to_correct_linkage, ec);
+	}
+
+	if (do_threading) {
+		for (auto const &entry : gen->modules) {
+			lbModule *m = entry.value;
+			if (!lb_is_module_empty(m)) {
+				thread_pool_add_task(lb_object_cache_lookup_worker_proc, m);
+			}
+		}
+		thread_pool_wait();
+	} else {
+		for (auto const &entry : gen->modules) {
+			lbModule *m = entry.value;
+			if (!lb_is_module_empty(m)) {
+				lb_object_cache_lookup_worker_proc(m);
+			}
+		}
+	}
+
+	isize hit_count = 0;
+	for (auto const &entry : gen->modules) {
+		lbModule *m = entry.value;
+		if (m->object_cache_hit) {
+			debugf("Object Cache: hit %s -> %.*s\n", m->module_name, LIT(m->object_cache_path));
+			hit_count += 1;
+		} else if (m->object_cache_path.len != 0) {
+			debugf("Object Cache: miss %s -> %.*s\n", m->module_name, LIT(m->object_cache_path));
+		}
+	}
+	debugf("Object Cache: %td of %td modules cached\n", hit_count, gen->modules.count);
+}
+
 gb_internal bool lb_llvm_object_generation(lbGenerator *gen, bool do_threading) {
 	LLVMCodeGenFileType code_gen_file_type = LLVMObjectFile;
 	if (build_context.build_mode == BuildMode_Assembly) {
@@ -2805,6 +3164,7 @@ gb_internal bool lb_llvm_object_generation(lbGenerator *gen, bool do_threading)
 		for (auto const &entry : gen->modules) {
 			lbModule *m = entry.value;
 			if (lb_is_module_empty(m)) {
+				lb_release_emitted_module(m);
 				continue;
 			}
 
@@ -2826,6 +3186,7 @@ gb_internal bool lb_llvm_object_generation(lbGenerator *gen, bool do_threading)
 		for (auto const &entry : gen->modules) {
 			lbModule *m = entry.value;
 			if (lb_is_module_empty(m)) {
+				lb_release_emitted_module(m);
 				continue;
 			}
 
@@ -2838,6 +3199,17 @@ gb_internal bool lb_llvm_object_generation(lbGenerator *gen, bool do_threading)
 
 			TIME_SECTION_WITH_LEN(section_name, gb_string_length(section_name));
 
+			if (m->object_cache_hit) {
+				if (!gb_file_copy(cast(char const *)m->object_cache_path.text, cast(char const *)filepath_obj.text, false)) {
+					gb_printf_err("Failed to copy cached object file: %.*s\n", LIT(m->object_cache_path));
+					exit_with_errors();
+					return false;
+				}
+				debugf("Copied Cached File: %.*s\n", LIT(filepath_obj));
+				lb_release_emitted_module(m);
+				continue;
+			}
+
 			if (build_context.lto_kind != LTO_None) {
 				if (LLVMWriteBitcodeToFile(m->mod, cast(char *)filepath_obj.text)) {
 					gb_printf_err("Failed to write bitcode file: %.*s\n", LIT(filepath_obj));
@@ -2850,6 +3222,9 @@ gb_internal bool lb_llvm_object_generation(lbGenerator *gen, bool do_threading)
 				return false;
 			}
 			debugf("Generated File: %.*s\n", LIT(filepath_obj));
+
+			lb_object_cache_store(m, filepath_obj);
+			lb_release_emitted_module(m);
 		}
 	}
 	return true;
@@ -3491,7 +3866,7 @@ gb_internal bool lb_generate_code(lbGenerator *gen) {
 					m->debug_builder, llvm_scope,
 					cast(char const *)global_name.text, global_name.len,
 					"", 0, // linkage
-					llvm_file, e->token.pos.line,
+					llvm_file, token_pos_line_column(e->token.pos).line,
 					lb_debug_type(m, e->type),
 					local_to_unit,
 					llvm_expr,
@@ -3698,69 +4073,91 @@ gb_internal bool lb_generate_code(lbGenerator *gen) {
 	TIME_SECTION("LLVM Add Foreign Library Paths");
 	lb_add_foreign_library_paths(gen);
 
-	TIME_SECTION("LLVM Function Pass");
-	lb_llvm_function_passes(gen, do_threading && !build_context.ODIN_DEBUG);
+	if (build_context.cached_objects) {
+		TIME_SECTION("LLVM Object Cache Lookup");
+		lb_object_cache_lookup(gen, do_threading);
+	}
+
+	// NOTE: the object of a module can be emitted as soon as its own passes are done, unless every
+	// module must be finished first to print or inspect them
+	bool pipeline_object_generation = do_threading &&
+	                                  !build_context.keep_temp_files &&
+	                                  !build_context.build_diagnostics &&
+	                                  !build_context.ignore_llvm_build &&
+	                                  build_context.build_mode != BuildMode_LLVM_IR;
+	if (pipeline_object_generation) {
+		if (build_context.ODIN_DEBUG) {
+			TIME_SECTION("LLVM Function Pass");
+			lb_llvm_function_passes(gen, false);
+		}
 
-	TIME_SECTION("LLVM Remove Unused Functions and Globals");
-	lb_remove_unused_functions_and_globals(gen);
+		TIME_SECTION("LLVM Passes and Object Generation");
+		lb_llvm_module_pipeline(gen, !build_context.ODIN_DEBUG);
+	} else {
+		TIME_SECTION("LLVM Function Pass");
+		lb_llvm_function_passes(gen, do_threading && !build_context.ODIN_DEBUG);
 
-	TIME_SECTION("LLVM Module Pass and Verification");
-	lb_llvm_module_passes_and_verification(gen, do_threading);
+		TIME_SECTION("LLVM Remove Unused Functions and Globals");
+		lb_remove_unused_functions_and_globals(gen);
 
-	TIME_SECTION("LLVM Correct Entity Linkage");
-	lb_correct_entity_linkage(gen);
+		TIME_SECTION("LLVM Module Pass and Verification");
+		lb_llvm_module_passes_and_verification(gen, do_threading);
 
-	if (build_context.build_diagnostics) {
-		lb_do_build_diagnostics(gen);
-	}
+		TIME_SECTION("LLVM Correct Entity Linkage");
+		lb_correct_entity_linkage(gen);
 
-	llvm_error = nullptr;
-	defer (LLVMDisposeMessage(llvm_error));
+		if (build_context.build_diagnostics) {
+			lb_do_build_diagnostics(gen);
+		}
 
-	if (build_context.keep_temp_files ||
-	    build_context.build_mode == BuildMode_LLVM_IR) {
-		TIME_SECTION("LLVM Print Module to File");
+		llvm_error = nullptr;
+		defer (LLVMDisposeMessage(llvm_error));
+
+		if (build_context.keep_temp_files ||
+		    build_context.build_mode == BuildMode_LLVM_IR) {
+			TIME_SECTION("LLVM Print Module to File");
+
+			for (auto const &entry : gen->modules) {
+				lbModule *m = entry.value;
+				if (lb_is_module_empty(m)) {
+					continue;
+				}
+				String filepath_ll = lb_filepath_ll_for_module(m);
+				if (LLVMPrintModuleToFile(m->mod, cast(char const *)filepath_ll.text, &llvm_error)) {
+					gb_printf_err("LLVM Error: %s\n", llvm_error);
+					exit_with_errors();
+					return false;
+				}
+				array_add(&gen->output_temp_paths, filepath_ll);
 
-		for (auto const &entry : gen->modules) {
-			lbModule *m = entry.value;
-			if (lb_is_module_empty(m)) {
-				continue;
 			}
-			String filepath_ll = lb_filepath_ll_for_module(m);
-			if (LLVMPrintModuleToFile(m->mod, cast(char const *)filepath_ll.text, &llvm_error)) {
-				gb_printf_err("LLVM Error: %s\n", llvm_error);
-				exit_with_errors();
-				return false;
+			if (build_context.build_mode == BuildMode_LLVM_IR) {
+				return true;
 			}
-			array_add(&gen->output_temp_paths, filepath_ll);
-
 		}
-		if (build_context.build_mode == BuildMode_LLVM_IR) {
-			return true;
-		}
-	}
 
 
-	////////////////////////////////////////////
-	for (auto const &entry: gen->modules) {
-		lbModule *m = entry.value;
-		if (!lb_is_module_empty(m)) {
-			gen->used_module_count += 1;
+		////////////////////////////////////////////
+		for (auto const &entry: gen->modules) {
+			lbModule *m = entry.value;
+			if (!lb_is_module_empty(m)) {
+				gen->used_module_count += 1;
+			}
 		}
-	}
 
-	gbString label_object_generation = gb_string_make(heap_allocator(), "LLVM Object Generation");
-	if (gen->used_module_count > 1) {
-		label_object_generation = gb_string_append_fmt(label_object_generation, " (%td used modules)", gen->used_module_count);
-	}
-	TIME_SECTION_WITH_LEN(label_object_generation, gb_string_length(label_object_generation));
+		gbString label_object_generation = gb_string_make(heap_allocator(), "LLVM Object Generation");
+		if (gen->used_module_count > 1) {
+			label_object_generation = gb_string_append_fmt(label_object_generation, " (%td used modules)", gen->used_module_count);
+		}
+		TIME_SECTION_WITH_LEN(label_object_generation, gb_string_length(label_object_generation));
 	
-	if (build_context.ignore_llvm_build) {
-		gb_printf_err("LLVM object generation has been ignored!\n");
-		return false;
-	}
-	if (!lb_llvm_object_generation(gen, do_threading)) {
-		return false;
+		if (build_context.ignore_llvm_build) {
+			gb_printf_err("LLVM object generation has been ignored!\n");
+			return false;
+		}
+		if (!lb_llvm_object_generation(gen, do_threading)) {
+			return false;
+		}
 	}
 
 
@@ -175,6 +175,13 @@ struct lbModule {
 
 	BlockingMutex pad_types_mutex;
 	Array<lbPadType> pad_types;
+
+	BlockingMutex        static_variables_mutex;
+	Array<LLVMValueRef>  static_variables; // named by their entity ids, see lb_object_cache_lookup_worker_proc
+
+	u64    object_cache_key;
+	String object_cache_path;
+	bool   object_cache_hit;
 };
 
 struct lbEntityCorrection {
@@ -211,6 +218,8 @@ struct lbGenerator : LinkerData {
 	MPSCQueue<lbObjCGlobal> objc_classes;
 	MPSCQueue<lbObjCGlobal> objc_ivars;
 	MPSCQueue<String> raddebug_section_strings;
+
+	String object_cache_dir;
 };
 
 
@@ -598,6 +607,7 @@ gb_internal LLVMTypeRef OdinLLVMGetArrayElementType(LLVMTypeRef type);
 gb_internal LLVMTypeRef OdinLLVMGetVectorElementType(LLVMTypeRef type);
 
 gb_internal String lb_filepath_ll_for_module(lbModule *m);
+gb_internal String lb_filepath_obj_for_module(lbModule *m);
 
 gb_internal LLVMTypeRef lb_type_internal_for_procedures_raw(lbModule *m, Type *type);
 
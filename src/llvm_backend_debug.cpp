@@ -54,7 +54,8 @@ gb_internal LLVMMetadataRef lb_get_current_debug_scope(lbProcedure *p) {
 gb_internal LLVMMetadataRef lb_debug_location_from_token_pos(lbProcedure *p, TokenPos pos) {
 	LLVMMetadataRef scope = lb_get_current_debug_scope(p);
 	GB_ASSERT_MSG(scope != nullptr, "%.*s", LIT(p->name));
-	return LLVMDIBuilderCreateDebugLocation(p->module->ctx, cast(unsigned)pos.line, cast(unsigned)pos.column, scope, nullptr);
+	TokenLineColumn lc = token_pos_line_column(pos);
+	return LLVMDIBuilderCreateDebugLocation(p->module->ctx, cast(unsigned)lc.line, cast(unsigned)lc.column, scope, nullptr);
 }
 gb_internal LLVMMetadataRef lb_debug_location_from_ast(lbProcedure *p, Ast *node) {
 	GB_ASSERT(node != nullptr);
@@ -69,7 +70,7 @@ gb_internal void lb_debug_file_line(lbModule *m, Ast *node, LLVMMetadataRef *fil
 	if (*file == nullptr) {
 		if (node) {
 			*file = lb_get_llvm_metadata(m, node->file());
-			*line = cast(unsigned)ast_token(node).pos.line;
+			*line = cast(unsigned)token_pos_line_column(ast_token(node).pos).line;
 		}
 	}
 }
@@ -1146,7 +1147,7 @@ gb_internal LLVMMetadataRef lb_debug_type(lbModule *m, Type *type) {
 			if (scope != nullptr) {
 				file = LLVMDIScopeGetFile(scope);
 			}
-			line = cast(unsigned)e->token.pos.line;
+			line = cast(unsigned)token_pos_line_column(e->token.pos).line;
 		}
 
 		String name = type_to_canonical_string(temporary_allocator(), type);
@@ -1237,7 +1238,7 @@ gb_internal void lb_add_debug_local_variable(lbProcedure *p, LLVMValueRef ptr, T
 	LLVMMetadataRef var_info = LLVMDIBuilderCreateAutoVariable(
 		m->debug_builder, llvm_scope,
 		cast(char const *)name.text, cast(size_t)name.len,
-		llvm_file, token.pos.line,
+		llvm_file, token_pos_line_column(token.pos).line,
 		debug_type,
 		always_preserve, flags, alignment_in_bits
 	);
@@ -1303,7 +1304,7 @@ gb_internal void lb_add_debug_param_variable(lbProcedure *p, LLVMValueRef ptr, T
 		m->debug_builder, llvm_scope,
 		cast(char const *)name.text, cast(size_t)name.len,
 		arg_number,
-		llvm_file, token.pos.line,
+		llvm_file, token_pos_line_column(token.pos).line,
 		debug_type,
 		always_preserve, flags
 	);
@@ -1331,8 +1332,10 @@ gb_internal void lb_add_debug_context_variable(lbProcedure *p, lbAddr const &ctx
 	TokenPos pos = {};
 
 	pos.file_id = p->body->file_id;
-	pos.line = LLVMDILocationGetLine(loc);
-	pos.column = LLVMDILocationGetColumn(loc);
+	AstFile *file = thread_unsafe_get_ast_file_from_id(pos.file_id);
+	if (file != nullptr) {
+		pos.offset = tokenizer_offset_from_line_column(&file->tokenizer, LLVMDILocationGetLine(loc), LLVMDILocationGetColumn(loc));
+	}
 
 	Token token = {};
 	token.kind = Token_context;
@@ -1498,7 +1501,7 @@ gb_internal void lb_add_debug_label(lbProcedure *p, Ast *label, lbBlock *target)
 		(const char *)label_token.string.text,
 		(size_t)label_token.string.len,
 		llvm_file,
-		label_token.pos.line,
+		token_pos_line_column(label_token.pos).line,
 
 		// NOTE(tf2spi): Defaults to false in LLVM API, but I'd rather not take chances
 		//               Always preserve the label no matter what when debugging
@@ -2013,9 +2013,9 @@ handle_op:;
 }
 
 gb_internal bool lb_is_empty_string_constant(Ast *expr) {
-	if (expr->tav.value.kind == ExactValue_String &&
-	    is_type_string(expr->tav.type)) {
-		String s = expr->tav.value.value_string;
+	if (expr->tav().value.kind == ExactValue_String &&
+	    is_type_string(expr->tav().type)) {
+		String s = expr->tav().value.value_string;
 		return s.len == 0;
 	}
 	return false;
@@ -2078,7 +2078,7 @@ gb_internal lbValue lb_build_binary_expr(lbProcedure *p, Ast *expr) {
 
 	TypeAndValue tv = type_and_value_of_expr(expr);
 
-	if (is_type_matrix(be->left->tav.type) || is_type_matrix(be->right->tav.type)) {
+	if (is_type_matrix(be->left->tav().type) || is_type_matrix(be->right->tav().type)) {
 		lbValue left = lb_build_expr(p, be->left);
 		lbValue right = lb_build_expr(p, be->right);
 		return lb_emit_arith_matrix(p, be->op.kind, left, right, default_type(tv.type), false);
@@ -2120,22 +2120,22 @@ gb_internal lbValue lb_build_binary_expr(lbProcedure *p, Ast *expr) {
 
 	case Token_CmpEq:
 	case Token_NotEq:
-		if (is_type_untyped_nil(be->right->tav.type)) {
+		if (is_type_untyped_nil(be->right->tav().type)) {
 			// `x == nil` or `x != nil`
 			lbValue left = lb_build_expr(p, be->left);
 			lbValue cmp = lb_emit_comp_against_nil(p, be->op.kind, left);
 			Type *type = default_type(tv.type);
 			return lb_emit_conv(p, cmp, type);
-		} else if (is_type_untyped_nil(be->left->tav.type)) {
+		} else if (is_type_untyped_nil(be->left->tav().type)) {
 			// `nil == x` or `nil != x`
 			lbValue right = lb_build_expr(p, be->right);
 			lbValue cmp = lb_emit_comp_against_nil(p, be->op.kind, right);
 			Type *type = default_type(tv.type);
 			return lb_emit_conv(p, cmp, type);
-		} else if (lb_is_empty_string_constant(be->right) && !is_type_union(be->left->tav.type)) {
+		} else if (lb_is_empty_string_constant(be->right) && !is_type_union(be->left->tav().type)) {
 			// `x == ""` or `x != ""`
 			Type *str_type = t_string;
-			if (is_type_string16(be->left->tav.type) || is_type_cstring16(be->left->tav.type)) {
+			if (is_type_string16(be->left->tav().type) || is_type_cstring16(be->left->tav().type)) {
 				str_type = t_string16;
 			}
 			lbValue s = lb_build_expr(p, be->left);
@@ -2144,10 +2144,10 @@ gb_internal lbValue lb_build_binary_expr(lbProcedure *p, Ast *expr) {
 			lbValue cmp = lb_emit_comp(p, be->op.kind, len, lb_const_int(p->module, t_int, 0));
 			Type *type = default_type(tv.type);
 			return lb_emit_conv(p, cmp, type);
-		} else if (lb_is_empty_string_constant(be->left) && !is_type_union(be->right->tav.type)) {
+		} else if (lb_is_empty_string_constant(be->left) && !is_type_union(be->right->tav().type)) {
 			// `"" == x` or `"" != x`
 			Type *str_type = t_string;
-			if (is_type_string16(be->right->tav.type) || is_type_cstring16(be->right->tav.type)) {
+			if (is_type_string16(be->right->tav().type) || is_type_cstring16(be->right->tav().type)) {
 				str_type = t_string16;
 			}
 			lbValue s = lb_build_expr(p, be->right);
@@ -2166,11 +2166,11 @@ gb_internal lbValue lb_build_binary_expr(lbProcedure *p, Ast *expr) {
 			lbValue left = {};
 			lbValue right = {};
 
-			if (be->left->tav.mode == Addressing_Type) {
-				left = lb_typeid(p->module, be->left->tav.type);
+			if (be->left->tav().mode == Addressing_Type) {
+				left = lb_typeid(p->module, be->left->tav().type);
 			}
-			if (be->right->tav.mode == Addressing_Type) {
-				right = lb_typeid(p->module, be->right->tav.type);
+			if (be->right->tav().mode == Addressing_Type) {
+				right = lb_typeid(p->module, be->right->tav().type);
 			}
 			if (left.value == nullptr)  left  = lb_build_expr(p, be->left);
 			if (right.value == nullptr) right = lb_build_expr(p, be->right);
@@ -4398,7 +4398,7 @@ gb_internal Type *lb_build_expr_original_const_type(Ast *expr) {
 	Type *type = type_of_expr(expr);
 	if (is_type_union(type)) {
 		if (expr->kind == Ast_CallExpr) {
-			if (expr->CallExpr.proc->tav.mode == Addressing_Type) {
+			if (expr->CallExpr.proc->tav().mode == Addressing_Type) {
 				Type *res = lb_build_expr_original_const_type(expr->CallExpr.args[0]);
 				return res;
 			}
@@ -4938,8 +4938,8 @@ gb_internal void lb_build_addr_compound_lit_populate(lbProcedure *p, Slice<Ast *
 			}
 			if (is_ast_range(fv->field)) {
 				ast_node(ie, BinaryExpr, fv->field);
-				TypeAndValue lo_tav = ie->left->tav;
-				TypeAndValue hi_tav = ie->right->tav;
+				TypeAndValue lo_tav = ie->left->tav();
+				TypeAndValue hi_tav = ie->right->tav();
 				GB_ASSERT(lo_tav.mode == Addressing_Constant);
 				GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -4980,7 +4980,7 @@ gb_internal void lb_build_addr_compound_lit_populate(lbProcedure *p, Slice<Ast *
 					}
 				}
 			} else {
-				auto tav = fv->field->tav;
+				auto tav = fv->field->tav();
 				GB_ASSERT(tav.mode == Addressing_Constant);
 				i64 index = exact_value_to_i64(tav.value);
 
@@ -5072,7 +5072,7 @@ gb_internal lbAddr lb_build_addr_index_expr(lbProcedure *p, Ast *expr) {
 		return lb_addr_soa_variable(val, index, ie->index);
 	}
 
-	if (ie->expr->tav.mode == Addressing_SoaVariable) {
+	if (ie->expr->tav().mode == Addressing_SoaVariable) {
 		// SOA Structures for slices/dynamic arrays
 		GB_ASSERT_MSG(is_type_multi_pointer(type_of_expr(ie->expr)), "%s", type_to_string(type_of_expr(ie->expr)));
 
@@ -5859,7 +5859,7 @@ gb_internal void lb_build_addr_struct_compound_lit_populate(lbProcedure *p, Ast
 	isize field_index = 0;
 
 	for (Ast *elem : cl->elems) {
-		if (is_type_tuple(elem->tav.type)) {
+		if (is_type_tuple(elem->tav().type)) {
 			lbValue tuple_field_expr = lb_build_expr(p, elem);
 			GB_ASSERT(is_type_tuple(tuple_field_expr.type));
 
@@ -6486,7 +6486,7 @@ gb_internal lbAddr lb_build_addr_internal(lbProcedure *p, Ast *expr) {
 					a = lb_addr_get_ptr(p, addr);
 				}
 
-				Type *type = type_deref(expr->tav.type);
+				Type *type = type_deref(expr->tav().type);
 				GB_ASSERT(is_type_array(type) || is_type_simd_vector(type));
 				return lb_addr_swizzle(a, type, swizzle_count, swizzle_indices);
 			}
@@ -6700,7 +6700,7 @@ gb_internal lbAddr lb_build_addr_internal(lbProcedure *p, Ast *expr) {
 
 	case_ast_node(ce, CallExpr, expr);
 		BuiltinProcId builtin_id = BuiltinProc_Invalid;
-		if (ce->proc->tav.mode == Addressing_Builtin) {
+		if (ce->proc->tav().mode == Addressing_Builtin) {
 			Entity *e = entity_of_node(ce->proc);
 			if (e != nullptr) {
 				builtin_id = cast(BuiltinProcId)e->Builtin.id;
@@ -6708,7 +6708,7 @@ gb_internal lbAddr lb_build_addr_internal(lbProcedure *p, Ast *expr) {
 				builtin_id = BuiltinProc_DIRECTIVE;
 			}
 		}
-		auto const &tv = expr->tav;
+		auto const &tv = expr->tav();
 		if (builtin_id == BuiltinProc_swizzle &&
 		    is_type_array(tv.type)) {
 		    	// NOTE(bill, 2021-08-09): `swizzle` has some bizarre semantics so it needs to be
@@ -6825,7 +6825,7 @@ gb_internal lbAddr lb_build_addr_internal(lbProcedure *p, Ast *expr) {
 		}
 
 		GB_ASSERT(block != nullptr);
-		TypeAndValue tv = expr->tav;
+		TypeAndValue tv = expr->tav();
 
 		lbValue lhs = {};
 		lbValue rhs = {};
@@ -122,6 +122,7 @@ gb_internal WORKER_TASK_PROC(lb_init_module_worker_proc) {
 
 	array_init(&m->global_procedures_to_create, a, 0, 1024);
 	array_init(&m->global_types_to_create, a, 0, 1024);
+	array_init(&m->static_variables, a);
 	mpsc_init(&m->missing_procedures_to_check, a);
 	map_init(&m->debug_values);
 
@@ -393,6 +394,19 @@ gb_internal LLVMValueRef llvm_zero(lbModule *m) {
 	return LLVMConstInt(lb_type(m, t_int), 0, false);
 }
 
+// NOTE: the `#load`-ed data may be larger than the 4 GiB which LLVMConstStringInContext allows
+gb_internal LLVMValueRef llvm_const_string_data(LLVMContextRef ctx, String const &str, bool dont_null_terminate) {
+#if LLVM_VERSION_MAJOR >= 19
+	return LLVMConstStringInContext2(ctx, cast(char const *)str.text, cast(size_t)str.len, dont_null_terminate);
+#else
+	if (str.len > cast(isize)U32_MAX) {
+		gb_printf_err("Constant data of %td bytes is too large, LLVM %d only allows up to 4 GiB (LLVM 19 or later is required)\n", str.len, LLVM_VERSION_MAJOR);
+		exit_with_errors();
+	}
+	return LLVMConstStringInContext(ctx, cast(char const *)str.text, cast(unsigned)str.len, dont_null_terminate);
+#endif
+}
+
 gb_internal LLVMValueRef llvm_alloca(lbProcedure *p, LLVMTypeRef llvm_type, isize alignment, char const *name) {
 	LLVMPositionBuilderAtEnd(p->builder, p->decl_block->block);
 
@@ -705,8 +719,9 @@ gb_internal lbValue lb_build_addr_ptr(lbProcedure *p, Ast *expr) {
 
 gb_internal void lb_set_file_line_col(lbProcedure *p, Array<lbValue> arr, TokenPos pos) {
 	String file = get_file_path_string(pos.file_id);
-	i32 line    = pos.line;
-	i32 col     = pos.column;
+	TokenLineColumn lc = token_pos_line_column(pos);
+	i32 line    = lc.line;
+	i32 col     = lc.column;
 
 	switch (build_context.source_code_location_info) {
 	case SourceCodeLocationInfo_Normal:
@@ -3067,10 +3082,7 @@ gb_internal LLVMValueRef lb_find_or_add_entity_string_ptr(lbModule *m, String co
 		return *found;
 	} else {
 		LLVMValueRef indices[2] = {llvm_zero(m), llvm_zero(m)};
-		LLVMValueRef data = LLVMConstStringInContext(m->ctx,
-			cast(char const *)str.text,
-			cast(unsigned)str.len,
-			false);
+		LLVMValueRef data = llvm_const_string_data(m->ctx, str, false);
 
 
 		u32 id = m->global_array_index.fetch_add(1);
@@ -3161,10 +3173,7 @@ gb_internal lbValue lb_find_or_add_entity_string(lbModule *m, String const &str,
 gb_internal lbValue lb_find_or_add_entity_string_byte_slice_with_type(lbModule *m, String const &str, Type *slice_type) {
 	GB_ASSERT(is_type_slice(slice_type));
 	LLVMValueRef indices[2] = {llvm_zero(m), llvm_zero(m)};
-	LLVMValueRef data = LLVMConstStringInContext(m->ctx,
-		cast(char const *)str.text,
-		cast(unsigned)str.len,
-		false);
+	LLVMValueRef data = llvm_const_string_data(m->ctx, str, false);
 
 
 	u32 id = m->global_array_index.fetch_add(1);
@@ -330,7 +330,7 @@ gb_internal lbProcedure *lb_create_procedure(lbModule *m, Entity *entity, bool i
 	if (m->debug_builder) { // Debug Information
 		Type *bt = base_type(p->type);
 
-		unsigned line = cast(unsigned)entity->token.pos.line;
+		unsigned line = cast(unsigned)token_pos_line_column(entity->token.pos).line;
 
 		LLVMMetadataRef scope = nullptr;
 		LLVMMetadataRef file = nullptr;
@@ -1556,8 +1556,8 @@ gb_internal lbValue lb_build_builtin_simd_proc(lbProcedure *p, Ast *expr, TypeAn
 			lbValue arg0 = lb_build_expr(p, ce->args[0]);
 			LLVMTypeRef types[1] = {lb_type(m, arg0.type)};
 
-			GB_ASSERT(ce->args[1]->tav.value.kind == ExactValue_Integer);
-			int n = cast(int)exact_value_to_i64(ce->args[1]->tav.value);
+			GB_ASSERT(ce->args[1]->tav().value.kind == ExactValue_Integer);
+			int n = cast(int)exact_value_to_i64(ce->args[1]->tav().value);
 
 			if (n == 1) {
 				res.value = arg0.value;
@@ -2299,8 +2299,8 @@ gb_internal lbValue lb_build_builtin_simd_proc(lbProcedure *p, Ast *expr, TypeAn
 
 			u64 max_count = cast(u64)vt->SimdVector.count;
 
-			GB_ASSERT(ce->args[1]->tav.mode == Addressing_Constant);
-			u64 n = exact_value_to_u64(ce->args[1]->tav.value);
+			GB_ASSERT(ce->args[1]->tav().mode == Addressing_Constant);
+			u64 n = exact_value_to_u64(ce->args[1]->tav().value);
 			GB_ASSERT(max_count >= n);
 			GB_ASSERT(max_count % n == 0);
 
@@ -2651,7 +2651,7 @@ gb_internal lbValue lb_build_builtin_simd_proc(lbProcedure *p, Ast *expr, TypeAn
 			BigInt bi_count = {};
 			big_int_from_i64(&bi_count, count);
 
-			TypeAndValue const &tv = ce->args[1]->tav;
+			TypeAndValue const &tv = ce->args[1]->tav();
 			ExactValue val = exact_value_to_integer(tv.value);
 			GB_ASSERT(val.kind == ExactValue_Integer);
 			BigInt *bi = &val.value_integer;
@@ -3128,7 +3128,7 @@ gb_internal lbValue lb_build_builtin_proc(lbProcedure *p, Ast *expr, TypeAndValu
 	case BuiltinProc_compress_values: {
 		isize value_count = 0;
 		for (Ast *arg : ce->args) {
-			Type *t = arg->tav.type;
+			Type *t = arg->tav().type;
 			if (is_type_tuple(t)) {
 				value_count += t->Tuple.variables.count;
 			} else {
@@ -3870,16 +3870,16 @@ gb_internal lbValue lb_build_builtin_proc(lbProcedure *p, Ast *expr, TypeAndValu
 
 
 	case BuiltinProc_type_equal_proc:
-		return lb_equal_proc_for_type(p->module, ce->args[0]->tav.type);
+		return lb_equal_proc_for_type(p->module, ce->args[0]->tav().type);
 
 	case BuiltinProc_type_hasher_proc:
-		return lb_hasher_proc_for_type(p->module, ce->args[0]->tav.type);
+		return lb_hasher_proc_for_type(p->module, ce->args[0]->tav().type);
 
 	case BuiltinProc_type_map_info:
-		return lb_gen_map_info_ptr(p->module, ce->args[0]->tav.type);
+		return lb_gen_map_info_ptr(p->module, ce->args[0]->tav().type);
 
 	case BuiltinProc_type_map_cell_info:
-		return lb_gen_map_cell_info_ptr(p->module, ce->args[0]->tav.type);
+		return lb_gen_map_cell_info_ptr(p->module, ce->args[0]->tav().type);
 
 
 	case BuiltinProc_fixed_point_mul:
@@ -3971,7 +3971,7 @@ gb_internal lbValue lb_build_builtin_proc(lbProcedure *p, Ast *expr, TypeAndValu
 	case BuiltinProc_prefetch_write_data:
 		{
 			lbValue ptr = lb_emit_conv(p, lb_build_expr(p, ce->args[0]), t_rawptr);
-			unsigned long long locality = cast(unsigned long long)exact_value_to_i64(ce->args[1]->tav.value);
+			unsigned long long locality = cast(unsigned long long)exact_value_to_i64(ce->args[1]->tav().value);
 			unsigned long long rw = 0;
 			unsigned long long cache = 0;
 			switch (id) {
@@ -4830,8 +4830,8 @@ gb_internal lbValue lb_build_call_expr_internal(lbProcedure *p, Ast *expr, lbVal
 		}
 	}
 
-	if (proc_expr->tav.mode == Addressing_Constant) {
-		ExactValue v = proc_expr->tav.value;
+	if (proc_expr->tav().mode == Addressing_Constant) {
+		ExactValue v = proc_expr->tav().value;
 		switch (v.kind) {
 		case ExactValue_Integer:
 			{
@@ -4840,7 +4840,7 @@ gb_internal lbValue lb_build_call_expr_internal(lbProcedure *p, Ast *expr, lbVal
 				x.value = LLVMConstInt(lb_type(m, t_uintptr), u, false);
 				x.type = t_uintptr;
 				x = lb_emit_conv(p, x, t_rawptr);
-				value = lb_emit_conv(p, x, proc_expr->tav.type);
+				value = lb_emit_conv(p, x, proc_expr->tav().type);
 				break;
 			}
 		case ExactValue_Pointer:
@@ -4850,7 +4850,7 @@ gb_internal lbValue lb_build_call_expr_internal(lbProcedure *p, Ast *expr, lbVal
 				x.value = LLVMConstInt(lb_type(m, t_uintptr), u, false);
 				x.type = t_uintptr;
 				x = lb_emit_conv(p, x, t_rawptr);
-				value = lb_emit_conv(p, x, proc_expr->tav.type);
+				value = lb_emit_conv(p, x, proc_expr->tav().type);
 				break;
 			}
 		}
@@ -4871,7 +4871,7 @@ gb_internal lbValue lb_build_call_expr_internal(lbProcedure *p, Ast *expr, lbVal
 
 	auto args = array_make<lbValue>(permanent_allocator(), 0, pt->param_count);
 
-	bool vari_expand = (ce->ellipsis.pos.line != 0);
+	bool vari_expand = token_pos_is_valid(ce->ellipsis.pos);
 	bool is_c_vararg = pt->c_vararg;
 
 	for_array(i, ce->split_args->positional) {
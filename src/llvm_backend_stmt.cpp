@@ -296,8 +296,9 @@ gb_internal void lb_open_scope(lbProcedure *p, Scope *s) {
 		LLVMMetadataRef curr_metadata = lb_get_llvm_metadata(m, s);
 		if (s != nullptr && s->node != nullptr && curr_metadata == nullptr) {
 			Token token = ast_token(s->node);
-			unsigned line = cast(unsigned)token.pos.line;
-			unsigned column = cast(unsigned)token.pos.column;
+			TokenLineColumn lc = token_pos_line_column(token.pos);
+			unsigned line = cast(unsigned)lc.line;
+			unsigned column = cast(unsigned)lc.column;
 
 			LLVMMetadataRef file = nullptr;
 			AstFile *ast_file = s->node->file();
@@ -1548,11 +1549,11 @@ gb_internal void lb_build_unroll_range_stmt(lbProcedure *p, AstUnrollRangeStmt *
 		TokenKind op = expr->BinaryExpr.op.kind;
 		Ast *start_expr = expr->BinaryExpr.left;
 		Ast *end_expr   = expr->BinaryExpr.right;
-		GB_ASSERT(start_expr->tav.mode == Addressing_Constant);
-		GB_ASSERT(end_expr->tav.mode == Addressing_Constant);
+		GB_ASSERT(start_expr->tav().mode == Addressing_Constant);
+		GB_ASSERT(end_expr->tav().mode == Addressing_Constant);
 
-		ExactValue start = start_expr->tav.value;
-		ExactValue end   = end_expr->tav.value;
+		ExactValue start = start_expr->tav().value;
+		ExactValue end   = end_expr->tav().value;
 		if (op != Token_RangeHalf) { // .. [start, end] (or ..=)
 			ExactValue index = exact_value_i64(0);
 			for (ExactValue val = start;
@@ -1603,21 +1604,21 @@ gb_internal void lb_build_unroll_range_stmt(lbProcedure *p, AstUnrollRangeStmt *
 
 		ExactValue unroll_count_ev = {};
 		if (rs->args.count != 0) {
-			unroll_count_ev = rs->args[0]->tav.value;
+			unroll_count_ev = rs->args[0]->tav().value;
 		}
 
 
 		if (unroll_count_ev.kind == ExactValue_Invalid) {
 
-			Type *t = base_type(expr->tav.type);
+			Type *t = base_type(expr->tav().type);
 
 			switch (t->kind) {
 			case Type_Basic:
-				GB_ASSERT(expr->tav.mode == Addressing_Constant);
+				GB_ASSERT(expr->tav().mode == Addressing_Constant);
 
 				GB_ASSERT(is_type_string(t));
 				{
-					ExactValue value = expr->tav.value;
+					ExactValue value = expr->tav().value;
 					GB_ASSERT(value.kind == ExactValue_String);
 					String str = value.value_string;
 					Rune codepoint = 0;
@@ -1687,7 +1688,7 @@ gb_internal void lb_build_unroll_range_stmt(lbProcedure *p, AstUnrollRangeStmt *
 			i64 unroll_count = exact_value_to_i64(unroll_count_ev);
 			gb_unused(unroll_count);
 
-			Type *t = base_type(expr->tav.type);
+			Type *t = base_type(expr->tav().type);
 
 			lbValue data_ptr = {};
 			lbValue count_ptr = {};
@@ -1848,7 +1849,7 @@ gb_internal bool lb_switch_stmt_can_be_trivial_jump_table(AstSwitchStmt *ss, boo
 			if (is_ast_range(expr)) {
 				return false;
 			}
-			if (expr->tav.mode == Addressing_Type) {
+			if (expr->tav().mode == Addressing_Type) {
 				GB_ASSERT(is_typeid);
 				continue;
 			}
@@ -1914,9 +1915,9 @@ gb_internal void lb_build_switch_stmt(lbProcedure *p, AstSwitchStmt *ss, Scope *
 			gbString bn = gb_string_make(heap_allocator(), "switch.case.");
 
 			Ast *first = cc->list[0];
-			if (first->tav.mode == Addressing_Type) {
+			if (first->tav().mode == Addressing_Type) {
 				bn = gb_string_appendc(bn, "type.");
-			} else if (is_type_rune(first->tav.type)) {
+			} else if (is_type_rune(first->tav().type)) {
 				bn = gb_string_appendc(bn, "rune.");
 			} else {
 				bn = gb_string_appendc(bn, "value.");
@@ -1928,11 +1929,11 @@ gb_internal void lb_build_switch_stmt(lbProcedure *p, AstSwitchStmt *ss, Scope *
 				}
 
 				Ast *expr = cc->list[i];
-				if (expr->tav.mode == Addressing_Type) {
-					bn = write_type_to_string(bn, expr->tav.type, false);
+				if (expr->tav().mode == Addressing_Type) {
+					bn = write_type_to_string(bn, expr->tav().type, false);
 				} else {
-					ExactValue value = expr->tav.value;
-					if (is_type_rune(expr->tav.type) && value.kind == ExactValue_Integer) {
+					ExactValue value = expr->tav().value;
+					if (is_type_rune(expr->tav().type) && value.kind == ExactValue_Integer) {
 						Rune r = cast(Rune)exact_value_to_i64(value);
 						u8 rune_temp[6] = {};
 						isize size = gb_utf8_encode_rune(rune_temp, r);
@@ -2003,12 +2004,12 @@ gb_internal void lb_build_switch_stmt(lbProcedure *p, AstSwitchStmt *ss, Scope *
 
 			if (switch_instr != nullptr) {
 				lbValue on_val = {};
-				if (expr->tav.mode == Addressing_Type) {
+				if (expr->tav().mode == Addressing_Type) {
 					GB_ASSERT(is_type_typeid(tag.type));
-					lbValue e = lb_typeid(p->module, expr->tav.type);
+					lbValue e = lb_typeid(p->module, expr->tav().type);
 					on_val = lb_emit_conv(p, e, tag.type);
 				} else {
-					GB_ASSERT(expr->tav.mode == Addressing_Constant);
+					GB_ASSERT(expr->tav().mode == Addressing_Constant);
 					GB_ASSERT(!is_ast_range(expr));
 
 					on_val = lb_build_expr(p, expr);
@@ -2039,9 +2040,9 @@ gb_internal void lb_build_switch_stmt(lbProcedure *p, AstSwitchStmt *ss, Scope *
 				lbValue cond_rhs = lb_emit_comp(p, op, tag, rhs);
 				cond = lb_emit_arith(p, Token_And, cond_lhs, cond_rhs, t_bool);
 			} else {
-				if (expr->tav.mode == Addressing_Type) {
+				if (expr->tav().mode == Addressing_Type) {
 					GB_ASSERT(is_type_typeid(tag.type));
-					lbValue e = lb_typeid(p->module, expr->tav.type);
+					lbValue e = lb_typeid(p->module, expr->tav().type);
 					e = lb_emit_conv(p, e, tag.type);
 					cond = lb_emit_comp(p, Token_CmpEq, tag, e);
 				} else {
@@ -2378,14 +2379,14 @@ gb_internal void lb_build_static_variables(lbProcedure *p, AstValueDecl *vd) {
 		if (vd->values.count > 0) {
 			GB_ASSERT(vd->names.count == vd->values.count);
 			Ast *ast_value = vd->values[i];
-			GB_ASSERT(ast_value->tav.mode == Addressing_Constant ||
-			          ast_value->tav.mode == Addressing_Invalid);
+			GB_ASSERT(ast_value->tav().mode == Addressing_Constant ||
+			          ast_value->tav().mode == Addressing_Invalid);
 
 			auto cc = LB_CONST_CONTEXT_DEFAULT_NO_LOCAL;
 			if (e->Variable.is_rodata) {
 				cc.is_rodata = true;
 			}
-			value = lb_const_value(p->module, ast_value->tav.type, ast_value->tav.value, nullptr, cc);
+			value = lb_const_value(p->module, ast_value->tav().type, ast_value->tav().value, nullptr, cc);
 		}
 
 		String mangled_name = {};
@@ -2411,6 +2412,10 @@ gb_internal void lb_build_static_variables(lbProcedure *p, AstValueDecl *vd) {
 			LLVMSetLinkage(global, LLVMInternalLinkage);
 		}
 
+		mutex_lock(&p->module->static_variables_mutex);
+		array_add(&p->module->static_variables, global);
+		mutex_unlock(&p->module->static_variables_mutex);
+
 		if (value.value != nullptr) {
 			if (is_type_any(e->type)) {
 				Type *var_type = default_type(value.type);
@@ -2429,6 +2434,10 @@ gb_internal void lb_build_static_variables(lbProcedure *p, AstValueDecl *vd) {
 					LLVMSetLinkage(var_global_ref, LLVMInternalLinkage);
 				}
 
+				mutex_lock(&p->module->static_variables_mutex);
+				array_add(&p->module->static_variables, var_global_ref);
+				mutex_unlock(&p->module->static_variables_mutex);
+
 				auto vals = array_make<LLVMValueRef>(temporary_allocator(), 0, 3);
 				array_add(&vals, lb_emit_conv(p, var_global.addr, t_rawptr).value);
 				if (build_context.metrics.ptr_size == 4) {
@@ -3097,7 +3106,7 @@ gb_internal void lb_build_assign_stmt(lbProcedure *p, AstAssignStmt *as) {
 	op_ += Token_Add - Token_AddEq; // Convert += to +
 	TokenKind op = cast(TokenKind)op_;
 	if (op == Token_CmpAnd || op == Token_CmpOr) {
-		Type *type = as->lhs[0]->tav.type;
+		Type *type = as->lhs[0]->tav().type;
 		lbValue new_value = lb_emit_logical_binary_expr(p, op, as->lhs[0], as->rhs[0], type);
 
 		lbAddr lhs = lb_build_addr(p, as->lhs[0]);
@@ -3431,7 +3440,7 @@ gb_internal void lb_build_defer_stmt(lbProcedure *p, lbDefer const &d) {
 	if (d.kind == lbDefer_Node) {
 		lb_build_stmt(p, d.stmt);
 	} else if (d.kind == lbDefer_Proc) {
-		if (p->debug_info != nullptr && d.pos.line > 0) {
+		if (p->debug_info != nullptr && token_pos_is_valid(d.pos)) {
 			LLVMSetCurrentDebugLocation2(p->builder, lb_debug_location_from_token_pos(p, d.pos));
 		}
 		lb_emit_call(p, d.proc.deferred, d.proc.result_as_args);
@@ -17,6 +17,7 @@ gb_internal void init_global_thread_pool(void) {
 	isize thread_count = gb_max(build_context.thread_count, 1);
 	isize worker_count = thread_count; // +1
 	thread_pool_init(&global_thread_pool, worker_count, "ThreadPoolWorker");
+	global_thread_pool.show_stats = build_context.show_thread_pool_stats;
 }
 gb_internal bool thread_pool_add_task(WorkerTaskProc *proc, void *data) {
 	return thread_pool_add_task(&global_thread_pool, proc, data);
@@ -24,6 +25,15 @@ gb_internal bool thread_pool_add_task(WorkerTaskProc *proc, void *data) {
 gb_internal void thread_pool_wait(void) {
 	thread_pool_wait(&global_thread_pool);
 }
+gb_internal bool thread_pool_add_task(TaskGroup *group, WorkerTaskProc *proc, void *data) {
+	return thread_pool_add_task(&global_thread_pool, group, proc, data);
+}
+gb_internal void thread_pool_wait(TaskGroup *group) {
+	thread_pool_wait(&global_thread_pool, group);
+}
+gb_internal void thread_pool_start_task_node(TaskNode *node) {
+	thread_pool_start_task_node(&global_thread_pool, node);
+}
 
 
 gb_internal i64 PRINT_PEAK_USAGE(void) {
@@ -76,6 +86,8 @@ gb_global Timings global_timings = {0};
 
 #include "linker.cpp"
 #include "bundle_command.cpp"
+#include "server_command.cpp"
+#include "watch_command.cpp"
 
 #include "llvm_backend.cpp"
 
@@ -311,6 +323,7 @@ gb_internal void usage(String argv0, String argv1 = {}) {
 	print_usage_line(1, "version           Prints version.");
 	print_usage_line(1, "report            Prints information useful to reporting a bug.");
 	print_usage_line(1, "root              Prints the root path where Odin looks for the builtin collections.");
+	print_usage_line(1, "server            Serves check and build requests from a Unix socket.");
 	print_usage_line(0, "");
 	print_usage_line(0, "For further details on a command, invoke command help:");
 	print_usage_line(1, "e.g. `odin build -help` or `odin help build`");
@@ -328,6 +341,8 @@ enum BuildFlagKind {
 	BuildFlag_ShowUnused,
 	BuildFlag_ShowUnusedWithLocation,
 	BuildFlag_ShowMoreTimings,
+	BuildFlag_ShowThreadPoolStats,
+	BuildFlag_ShowMemory,
 	BuildFlag_ShowImportGraph,
 	BuildFlag_ExportTimings,
 	BuildFlag_ExportTimingsFile,
@@ -355,6 +370,8 @@ enum BuildFlagKind {
 	BuildFlag_Linker,
 	BuildFlag_UseSeparateModules,
 	BuildFlag_UseSingleModule,
+	BuildFlag_ReleaseEmittedPackages,
+	BuildFlag_MapFiles,
 	BuildFlag_NoThreadedChecker,
 	BuildFlag_ShowDebugMessages,
 	BuildFlag_DidYouMeanLimit,
@@ -440,12 +457,20 @@ enum BuildFlagKind {
 	BuildFlag_InternalIgnorePanic,
 	BuildFlag_InternalModulePerFile,
 	BuildFlag_InternalCached,
+	BuildFlag_InternalCachedContentHash,
+	BuildFlag_InternalCachedObjects,
+	BuildFlag_InternalCachedPackages,
+	BuildFlag_InternalCachedAst,
+	BuildFlag_Watch,
 	BuildFlag_InternalNoInline,
 	BuildFlag_InternalByValue,
 	BuildFlag_InternalWeakMonomorphization,
 	BuildFlag_InternalLLVMVerification,
 	BuildFlag_InternalLLVMNoSROA,
 	BuildFlag_InternalEnableRVO,
+	BuildFlag_InternalNoTokenStream,
+	BuildFlag_InternalDeferProcBodies,
+	BuildFlag_InternalNoFilePrefetch,
 
 	BuildFlag_Sanitize,
 	BuildFlag_LTO,
@@ -565,6 +590,8 @@ gb_internal bool parse_build_flags(Array<String> args) {
 	add_flag(&build_flags, BuildFlag_OptimizationMode,        str_lit("o"),                         BuildFlagParam_String,  Command__does_build);
 	add_flag(&build_flags, BuildFlag_ShowTimings,             str_lit("show-timings"),              BuildFlagParam_None,    Command__does_check);
 	add_flag(&build_flags, BuildFlag_ShowMoreTimings,         str_lit("show-more-timings"),         BuildFlagParam_None,    Command__does_check);
+	add_flag(&build_flags, BuildFlag_ShowThreadPoolStats,     str_lit("show-thread-pool-stats"),    BuildFlagParam_None,    Command__does_check);
+	add_flag(&build_flags, BuildFlag_ShowMemory,              str_lit("show-memory"),               BuildFlagParam_None,    Command__does_check);
 	add_flag(&build_flags, BuildFlag_ShowImportGraph,         str_lit("show-import-graph"),         BuildFlagParam_None,    Command__does_check);
 	add_flag(&build_flags, BuildFlag_ExportTimings,           str_lit("export-timings"),            BuildFlagParam_String,  Command__does_check);
 	add_flag(&build_flags, BuildFlag_ExportTimingsFile,       str_lit("export-timings-file"),       BuildFlagParam_String,  Command__does_check);
@@ -573,7 +600,7 @@ gb_internal bool parse_build_flags(Array<String> args) {
 	add_flag(&build_flags, BuildFlag_ShowUnused,              str_lit("show-unused"),               BuildFlagParam_None,    Command_check);
 	add_flag(&build_flags, BuildFlag_ShowUnusedWithLocation,  str_lit("show-unused-with-location"), BuildFlagParam_None,    Command_check);
 	add_flag(&build_flags, BuildFlag_ShowSystemCalls,         str_lit("show-system-calls"),         BuildFlagParam_None,    Command_all);
-	add_flag(&build_flags, BuildFlag_ThreadCount,             str_lit("thread-count"),              BuildFlagParam_Integer, Command_all);
+	add_flag(&build_flags, BuildFlag_ThreadCount,             str_lit("thread-count"),              BuildFlagParam_String,  Command_all);
 	add_flag(&build_flags, BuildFlag_KeepTempFiles,           str_lit("keep-temp-files"),           BuildFlagParam_None,    Command__does_build | Command_strip_semicolon);
 	add_flag(&build_flags, BuildFlag_Collection,              str_lit("collection"),                BuildFlagParam_String,  Command__does_check);
 	add_flag(&build_flags, BuildFlag_Define,                  str_lit("define"),                    BuildFlagParam_String,  Command__does_check, true);
@@ -595,6 +622,8 @@ gb_internal bool parse_build_flags(Array<String> args) {
 	add_flag(&build_flags, BuildFlag_Linker,                  str_lit("linker"),                    BuildFlagParam_String,  Command__does_build);
 	add_flag(&build_flags, BuildFlag_UseSeparateModules,      str_lit("use-separate-modules"),      BuildFlagParam_None,    Command__does_build);
 	add_flag(&build_flags, BuildFlag_UseSingleModule,         str_lit("use-single-module"),         BuildFlagParam_None,    Command__does_build);
+	add_flag(&build_flags, BuildFlag_ReleaseEmittedPackages,  str_lit("release-emitted-packages"),  BuildFlagParam_None,    Command__does_build);
+	add_flag(&build_flags, BuildFlag_MapFiles,                str_lit("map-files"),                 BuildFlagParam_String,  Command__does_check);
 	add_flag(&build_flags, BuildFlag_NoThreadedChecker,       str_lit("no-threaded-checker"),       BuildFlagParam_None,    Command__does_check);
 	add_flag(&build_flags, BuildFlag_ShowDebugMessages,       str_lit("show-debug-messages"),       BuildFlagParam_None,    Command_all);
 	add_flag(&build_flags, BuildFlag_DidYouMeanLimit,         str_lit("did-you-mean-limit"),        BuildFlagParam_Integer, Command__does_check);
@@ -678,12 +707,20 @@ gb_internal bool parse_build_flags(Array<String> args) {
 	add_flag(&build_flags, BuildFlag_InternalIgnorePanic,     str_lit("internal-ignore-panic"),     BuildFlagParam_None,    Command_all);
 	add_flag(&build_flags, BuildFlag_InternalModulePerFile,   str_lit("internal-module-per-file"),  BuildFlagParam_None,    Command_all);
 	add_flag(&build_flags, BuildFlag_InternalCached,          str_lit("internal-cached"),           BuildFlagParam_None,    Command_all);
+	add_flag(&build_flags, BuildFlag_InternalCachedContentHash, str_lit("internal-cached-content-hash"), BuildFlagParam_None, Command_all);
+	add_flag(&build_flags, BuildFlag_InternalCachedObjects,   str_lit("internal-cached-objects"),   BuildFlagParam_None,    Command__does_build);
+	add_flag(&build_flags, BuildFlag_InternalCachedPackages,  str_lit("internal-cached-packages"),  BuildFlagParam_None,    Command_check);
+	add_flag(&build_flags, BuildFlag_InternalCachedAst,       str_lit("internal-cached-ast"),       BuildFlagParam_None,    Command_all);
+	add_flag(&build_flags, BuildFlag_Watch,                   str_lit("watch"),                     BuildFlagParam_None,    Command_build|Command_check);
 	add_flag(&build_flags, BuildFlag_InternalNoInline,        str_lit("internal-no-inline"),        BuildFlagParam_None,    Command_all);
 	add_flag(&build_flags, BuildFlag_InternalByValue,         str_lit("internal-by-value"),         BuildFlagParam_None,    Command_all);
 	add_flag(&build_flags, BuildFlag_InternalWeakMonomorphization, str_lit("internal-weak-monomorphization"), BuildFlagParam_None, Command_all);
 	add_flag(&build_flags, BuildFlag_InternalLLVMVerification, str_lit("internal-ignore-llvm-verification"), BuildFlagParam_None, Command_all);
 	add_flag(&build_flags, BuildFlag_InternalLLVMNoSROA,      str_lit("internal-llvm-no-sroa"), BuildFlagParam_None, Command_all);
 	add_flag(&build_flags, BuildFlag_InternalEnableRVO,       str_lit("internal-enable-rvo"), BuildFlagParam_None, Command_all);
+	add_flag(&build_flags, BuildFlag_InternalNoTokenStream,   str_lit("internal-no-token-stream"), BuildFlagParam_None, Command_all);
+	add_flag(&build_flags, BuildFlag_InternalDeferProcBodies, str_lit("internal-defer-proc-bodies"), BuildFlagParam_None, Command__does_check);
+	add_flag(&build_flags, BuildFlag_InternalNoFilePrefetch,  str_lit("internal-no-file-prefetch"), BuildFlagParam_None, Command_all);
 
 
 	add_flag(&build_flags, BuildFlag_Sanitize,                str_lit("sanitize"),                  BuildFlagParam_String,  Command__does_build, true);
@@ -911,6 +948,15 @@ gb_internal bool parse_build_flags(Array<String> args) {
 							build_context.show_timings = true;
 							build_context.show_more_timings = true;
 							break;
+						case BuildFlag_ShowThreadPoolStats:
+							GB_ASSERT(value.kind == ExactValue_Invalid);
+							build_context.show_thread_pool_stats = true;
+							break;
+						case BuildFlag_ShowMemory:
+							GB_ASSERT(value.kind == ExactValue_Invalid);
+							build_context.show_timings = true;
+							build_context.show_memory = true;
+							break;
 						case BuildFlag_ShowImportGraph:
 							GB_ASSERT(value.kind == ExactValue_Invalid);
 							build_context.show_import_graph = true;
@@ -1005,8 +1051,18 @@ gb_internal bool parse_build_flags(Array<String> args) {
 							break;
 						}
 						case BuildFlag_ThreadCount: {
-							GB_ASSERT(value.kind == ExactValue_Integer);
-							isize count = cast(isize)big_int_to_i64(&value.value_integer);
+							GB_ASSERT(value.kind == ExactValue_String);
+							if (value.value_string == "auto-mem") {
+								build_context.thread_count_auto_mem = true;
+								break;
+							}
+							ExactValue count_value = exact_value_integer_from_string(value.value_string);
+							if (count_value.kind != ExactValue_Integer) {
+								gb_printf_err("%.*s expected an integer or 'auto-mem', got %.*s\n", LIT(name), LIT(param));
+								bad_flags = true;
+								break;
+							}
+							isize count = cast(isize)big_int_to_i64(&count_value.value_integer);
 							if (count <= 0) {
 								gb_printf_err("%.*s expected a positive non-zero number, got %.*s\n", LIT(name), LIT(param));
 								build_context.thread_count = 1;
@@ -1343,6 +1399,27 @@ gb_internal bool parse_build_flags(Array<String> args) {
 							}
 							build_context.use_single_module = true;
 							break;
+						case BuildFlag_ReleaseEmittedPackages:
+							GB_ASSERT(value.kind == ExactValue_Invalid);
+							build_context.release_emitted_packages = true;
+							break;
+						case BuildFlag_MapFiles: {
+							GB_ASSERT(value.kind == ExactValue_String);
+							String mode = value.value_string;
+							if (mode == "copy") {
+								build_context.file_load_mode = FileLoad_Copy;
+							} else if (mode == "map") {
+								build_context.file_load_mode = FileLoad_Map;
+							} else if (mode == "sequential") {
+								build_context.file_load_mode = FileLoad_MapSequential;
+							} else if (mode == "populate") {
+								build_context.file_load_mode = FileLoad_MapPopulate;
+							} else {
+								gb_printf_err("-map-files options are 'copy', 'map', 'sequential', and 'populate'\n");
+								bad_flags = true;
+							}
+							break;
+						}
 						case BuildFlag_NoThreadedChecker:
 							build_context.no_threaded_checker = true;
 							break;
@@ -1701,6 +1778,32 @@ gb_internal bool parse_build_flags(Array<String> args) {
 							build_context.cached = true;
 							build_context.use_separate_modules = true;
 							break;
+						case BuildFlag_InternalCachedContentHash:
+							build_context.cached = true;
+							build_context.cached_content_hash = true;
+							build_context.use_separate_modules = true;
+							break;
+						case BuildFlag_InternalCachedObjects:
+							build_context.cached_objects = true;
+							build_context.use_separate_modules = true;
+							break;
+						case BuildFlag_InternalCachedPackages:
+							build_context.cached_packages = true;
+							break;
+						case BuildFlag_InternalCachedAst:
+							build_context.cached_ast = true;
+							break;
+						case BuildFlag_Watch:
+							build_context.watch = true;
+							// NOTE: each rebuild reuses the work of the previous ones through the caches
+							build_context.cached_ast = true;
+							if (build_context.command_kind == Command_check) {
+								build_context.cached_packages = true;
+							} else {
+								build_context.cached_objects = true;
+								build_context.use_separate_modules = true;
+							}
+							break;
 						case BuildFlag_InternalNoInline:
 							build_context.internal_no_inline = true;
 							break;
@@ -1719,6 +1822,15 @@ gb_internal bool parse_build_flags(Array<String> args) {
 						case BuildFlag_InternalEnableRVO:
 							build_context.enable_rvo = true;
 							break;
+						case BuildFlag_InternalNoTokenStream:
+							build_context.internal_no_token_stream = true;
+							break;
+						case BuildFlag_InternalDeferProcBodies:
+							build_context.internal_defer_proc_bodies = true;
+							break;
+						case BuildFlag_InternalNoFilePrefetch:
+							build_context.internal_no_file_prefetch = true;
+							break;
 
 
 						case BuildFlag_Sanitize:
@@ -1931,7 +2043,7 @@ gb_internal bool parse_build_flags(Array<String> args) {
 	}
 
 	if (build_context.export_timings_format && !(build_context.show_timings || build_context.show_more_timings)) {
-		gb_printf_err("`-export-timings:<format>` requires `-show-timings` or `-show-more-timings` to be present\n");
+		gb_printf_err("`-export-timings:<format>` requires `-show-timings`, `-show-more-timings`, or `-show-memory` to be present\n");
 		bad_flags = true;
 	}
 
@@ -1963,8 +2075,7 @@ gb_internal void timings_export_all(Timings *t, Checker *c, bool timings_are_fin
 		or just one of them, we only need to stop the clock once.
 	*/
 	if (!timings_are_finalized) {
-		timings__stop_current_section(t);
-		t->total.finish = time_stamp_time_now();
+		timings__stop_total(t);
 	}
 
 	TimingUnit unit = TimingUnit_Millisecond;
@@ -2017,13 +2128,28 @@ gb_internal void timings_export_all(Timings *t, Checker *c, bool timings_are_fin
 		t->total_time_seconds = time_stamp_as_s(t->total, t->freq);
 		f64 total_time = time_stamp(t->total, t->freq, unit);
 
-		gb_fprintf(&f, "\t\t{\"name\": \"%.*s\", \"millis\": %.3f},\n",
+		auto print_memory = [&f, t](TimeStamp const &ts) {
+			if (!t->record_memory) {
+				return;
+			}
+			MemoryUsage const &m = ts.memory;
+			gb_fprintf(&f, ", \"permanent_arena_bytes\": %td, \"temporary_arena_bytes\": %td, \"interned_bytes\": %td",
+			    m.arena_committed[ThreadArena_Permanent], m.arena_committed[ThreadArena_Temporary], m.static_arena_committed);
+			gb_fprintf(&f, ", \"heap_bytes\": %td, \"malloc_bytes\": %td, \"peak_rss_bytes\": %td, \"huge_page_bytes\": %td",
+			    m.heap_allocated, m.other_malloc, m.peak_rss, m.huge_pages);
+		};
+
+		gb_fprintf(&f, "\t\t{\"name\": \"%.*s\", \"millis\": %.3f",
 		    LIT(t->total.label), total_time);
+		print_memory(t->total);
+		gb_fprintf(&f, "},\n");
 
 		for (TimeStamp const &ts : t->sections) {
 			f64 section_time = time_stamp(ts, t->freq, unit);
-			gb_fprintf(&f, "\t\t{\"name\": \"%.*s\", \"millis\": %.3f},\n",
+			gb_fprintf(&f, "\t\t{\"name\": \"%.*s\", \"millis\": %.3f",
 			    LIT(ts.label), section_time);
+			print_memory(ts);
+			gb_fprintf(&f, "},\n");
 		}
 
 		gb_fprintf(&f, "\t],\n");
@@ -2039,11 +2165,26 @@ gb_internal void timings_export_all(Timings *t, Checker *c, bool timings_are_fin
 		/*
 			CSV doesn't really like floating point values. Cast to `int`.
 		*/
-		gb_fprintf(&f, "\"%.*s\", %d\n", LIT(t->total.label), int(total_time));
+		auto print_memory = [&f, t](TimeStamp const &ts) {
+			if (!t->record_memory) {
+				return;
+			}
+			// NOTE: permanent arena, temporary arena, interned, heap, malloc, peak RSS, and huge pages, in bytes
+			MemoryUsage const &m = ts.memory;
+			gb_fprintf(&f, ", %td, %td, %td, %td, %td, %td, %td",
+			    m.arena_committed[ThreadArena_Permanent], m.arena_committed[ThreadArena_Temporary], m.static_arena_committed,
+			    m.heap_allocated, m.other_malloc, m.peak_rss, m.huge_pages);
+		};
+
+		gb_fprintf(&f, "\"%.*s\", %d", LIT(t->total.label), int(total_time));
+		print_memory(t->total);
+		gb_fprintf(&f, "\n");
 
 		for (TimeStamp const &ts : t->sections) {
 			f64 section_time = time_stamp(ts, t->freq, unit);
-			gb_fprintf(&f, "\"%.*s\", %d\n", LIT(ts.label), int(section_time));
+			gb_fprintf(&f, "\"%.*s\", %d", LIT(ts.label), int(section_time));
+			print_memory(ts);
+			gb_fprintf(&f, "\n");
 		}
 	}
 
@@ -2242,6 +2383,49 @@ gb_internal void show_import_graph(Checker *c) {
 	gb_printf("}\n\n");
 }
 
+gb_internal GB_COMPARE_PROC(polymorphic_record_instantiations_cmp) {
+	Type *x = *cast(Type **)a;
+	Type *y = *cast(Type **)b;
+	isize nx = x->Named.gen_types_data->types.count;
+	isize ny = y->Named.gen_types_data->types.count;
+	if (nx != ny) {
+		return nx > ny ? -1 : +1;
+	}
+	return string_compare(x->Named.name, y->Named.name);
+}
+
+// NOTE: The generic records with the most instantiations, which are usually the ones to blame for a slow check
+gb_internal void show_polymorphic_record_instantiations(Checker *c) {
+	auto records = array_make<Type *>(heap_allocator());
+	defer (array_free(&records));
+	for (Type *t; mpsc_dequeue(&c->info.polymorphic_records_queue, &t); /**/) {
+		array_add(&records, t);
+	}
+	if (records.count == 0) {
+		return;
+	}
+	array_sort(records, polymorphic_record_instantiations_cmp);
+
+	isize total = 0;
+	for (Type *t : records) {
+		total += t->Named.gen_types_data->types.count;
+	}
+
+	gb_printf_err("\n");
+	gb_printf_err("Polymorphic Record Instantiations - %td across %td records\n", total, records.count);
+	isize shown = gb_min(records.count, 20);
+	for (isize i = 0; i < shown; i++) {
+		Type *t = records[i];
+		Entity *e = t->Named.type_name;
+		GenTypesData *gen_types = t->Named.gen_types_data;
+		String pkg_name = (e != nullptr && e->pkg != nullptr) ? e->pkg->name : str_lit("");
+		TokenPos pos = e != nullptr ? e->token.pos : TokenPos{};
+		gb_printf_err("%8td instantiations %10td lookups  %.*s.%.*s (%s)\n",
+		              gen_types->types.count, gen_types->lookup_count.load(),
+		              LIT(pkg_name), LIT(t->Named.name), token_pos_to_string(pos));
+	}
+}
+
 gb_internal void show_timings(Checker *c, Timings *t) {
 	Parser *p      = c->parser;
 	isize lines    = p->total_line_count;
@@ -2264,6 +2448,10 @@ gb_internal void show_timings(Checker *c, Timings *t) {
 
 	PRINT_PEAK_USAGE();
 
+	if (build_context.show_more_timings) {
+		show_polymorphic_record_instantiations(c);
+	}
+
 	if (!(build_context.export_timings_format == TimingsExportUnspecified)) {
 		timings_export_all(t, c, true);
 	}
@@ -2278,6 +2466,18 @@ gb_internal void show_timings(Checker *c, Timings *t) {
 			gb_printf_err("Total File Size - %td\n", total_file_size);
 			gb_printf_err("\n");
 		}
+		{
+			isize nodes  = p->total_node_count;
+			isize memory = p->total_node_memory;
+			gb_printf_err("AST Nodes\n");
+			gb_printf_err("Total Nodes  - %td\n", nodes);
+			gb_printf_err("Total Bytes  - %td\n", memory);
+			gb_printf_err("bytes/LOC    - %.3f\n", cast(f64)memory/cast(f64)lines);
+			gb_printf_err("bytes/Node   - %.3f\n", cast(f64)memory/cast(f64)nodes);
+			gb_printf_err("Nodes/LOC    - %.3f\n", cast(f64)nodes/cast(f64)lines);
+
+			gb_printf_err("\n");
+		}
 		{
 			f64 time = total_tokenizing_time;
 			gb_printf_err("Tokenization Only\n");
@@ -2524,8 +2724,8 @@ gb_internal void export_linked_libraries(LinkerData *gen) {
 			gb_fprintf(&f, "\t");
 
 			Ast *file_path = imp->filepaths[i];
-			GB_ASSERT(file_path->tav.mode == Addressing_Constant && file_path->tav.value.kind == ExactValue_String);
-			String file_path_str = file_path->tav.value.value_string;
+			GB_ASSERT(file_path->tav().mode == Addressing_Constant && file_path->tav().value.kind == ExactValue_String);
+			String file_path_str = file_path->tav().value.value_string;
 
 			if (string_starts_with(file_path_str, str_lit("system:"))) {
 				gb_fprintf(&f, "system");
@@ -2647,6 +2847,15 @@ gb_internal int print_show_help(String const arg0, String command, String option
 	} else if (command == "root") {
 		print_usage_header_once();
 		print_usage_line(1, "root    Prints the root path where Odin looks for the builtin collections.");
+	} else if (command == "server") {
+		print_usage_header_once();
+		print_usage_line(1, "server <socket>   Serves check and build requests from a Unix socket.");
+		print_usage_line(2, "Each request is served by a fork of an already initialized compiler.");
+		print_usage_line(2, "Request: the working directory and then the arguments, each terminated by a NUL byte, then an extra NUL byte.");
+		print_usage_line(2, "Response: the output of the command, a NUL byte, and then the exit code in decimal.");
+		print_usage_line(2, "Examples:");
+		print_usage_line(3, "odin server /tmp/odin.sock");
+		print_usage_line(3, "printf '%%s\\0check\\0.\\0\\0' \"$PWD\" | nc -U /tmp/odin.sock");
 	}
 
 	bool doc             = command == "doc";
@@ -2970,6 +3179,17 @@ gb_internal int print_show_help(String const arg0, String command, String option
 		}
 	}
 
+	if (check) {
+		if (print_flag("-map-files:<string>")) {
+			print_usage_line(2, "Specifies how the source files and the files of #load are read.");
+			print_usage_line(2, "Choices:");
+			print_usage_line(3, "copy       (Read into memory, default)");
+			print_usage_line(3, "map        (Memory-map the files)");
+			print_usage_line(3, "sequential (Memory-map the files, and hint that they are read sequentially)");
+			print_usage_line(3, "populate   (Memory-map the files, and fault the pages in up front)");
+		}
+	}
+
 	if (run_or_build) {
 		if (print_flag("-microarch:<string>")) {
 			print_usage_line(2, "Specifies the specific micro-architecture for the build in a string.");
@@ -3089,6 +3309,11 @@ gb_internal int print_show_help(String const arg0, String command, String option
 	}
 
 	if (run_or_build) {
+		if (print_flag("-release-emitted-packages")) {
+			print_usage_line(2, "Releases the memory of the AST, tokens, and LLVM module of a package as soon as its object file has been written.");
+			print_usage_line(2, "This lowers the peak memory usage of large builds, especially with '-use-separate-modules'.");
+		}
+
 		if (print_flag("-reloc-mode:<string>")) {
 			print_usage_line(2, "Specifies the reloc mode.");
 			print_usage_line(2, "Available options:");
@@ -3151,10 +3376,20 @@ gb_internal int print_show_help(String const arg0, String command, String option
 			print_usage_line(2, "Shows dot graph text format of the import graph of a project.");
 		}
 
+		if (print_flag("-show-thread-pool-stats")) {
+			print_usage_line(2, "Shows the tasks executed, steals, and time spent parked of each thread of the compiler's thread pool.");
+		}
+
 		if (print_flag("-show-timings")) {
 			print_usage_line(2, "Shows basic overview of the timings of different stages within the compiler in milliseconds.");
 		}
 
+		if (print_flag("-show-memory")) {
+			print_usage_line(2, "Shows the memory usage at the end of each stage within the compiler, along with the timings.");
+			print_usage_line(2, "This is the memory committed for each kind of arena, the heap allocations, the other malloc-ed memory (mostly LLVM), and the peak RSS of the process.");
+			print_usage_line(2, "On Linux, setting ODIN_HUGE_PAGES=thp or ODIN_HUGE_PAGES=hugetlb backs the arenas with huge pages, and the memory backed by them is shown too.");
+		}
+
 		if (print_flag("-show-more-timings")) {
 			print_usage_line(2, "Shows an advanced overview of the timings of different stages within the compiler in milliseconds.");
 		}
@@ -3236,7 +3471,10 @@ gb_internal int print_show_help(String const arg0, String command, String option
 
 		if (print_flag("-thread-count:<integer>")) {
 			print_usage_line(2, "Overrides the number of threads the compiler will use to compile with.");
+			print_usage_line(2, "By default, this is the number of CPUs allowed by the CPU affinity mask and the cgroup CPU quota.");
+			print_usage_line(2, "'auto-mem' uses the default, capped at one thread per GiB of available memory.");
 			print_usage_line(2, "Example: -thread-count:2");
+			print_usage_line(2, "Example: -thread-count:auto-mem");
 		}
 	}
 
@@ -3330,6 +3568,14 @@ gb_internal int print_show_help(String const arg0, String command, String option
 		}
 	}
 
+	if (build || check_only) {
+		if (print_flag("-watch")) {
+			print_usage_line(2, "Watches the files of the program and rebuilds whenever any of them change.");
+			print_usage_line(2, "Only the work which depends upon the changed packages is redone.");
+			print_usage_line(2, "Only supported on Linux.");
+		}
+	}
+
 	if (bundle) {
 		print_usage_line(0, "");
 		print_usage_line(1, "Android-specific flags");
@@ -3472,16 +3718,19 @@ gb_internal gbFileError write_file_with_stripped_tokens(gbFile *f, AstFile *file
 	u8 const *file_data = file->tokenizer.start;
 	i32 prev_offset = 0;
 	i32 const end_offset = cast(i32)(file->tokenizer.end - file->tokenizer.start);
-	for (Token const &token : file->tokens) {
-		if (token.flags & (TokenFlag_Remove|TokenFlag_Replace)) {
-			i32 offset = token.pos.offset;
-			i32 to_write = offset-prev_offset;
-			if (!gb_file_write(f, file_data+prev_offset, to_write)) {
-				return gbFileError_Invalid;
-			}
-			written += to_write;
-			prev_offset = token_pos_end(token).offset;
+	for (isize i = 0; i < file->tokens.count; i++) {
+		if ((file->tokens.flags[i] & (TokenFlag_Remove|TokenFlag_Replace)) == 0) {
+			continue;
 		}
+		Token token = token_list_get(&file->tokens, i);
+		i32 offset = token.pos.offset;
+		i32 to_write = offset-prev_offset;
+		if (!gb_file_write(f, file_data+prev_offset, to_write)) {
+			return gbFileError_Invalid;
+		}
+		written += to_write;
+		prev_offset = token_pos_end(token).offset;
+
 		if (token.flags & TokenFlag_Replace) {
 			if (token.kind == Token_Ellipsis) {
 				if (!gb_file_write(f, "..=", 3)) {
@@ -3516,8 +3765,8 @@ gb_internal int strip_semicolons(Parser *parser) {
 	for (AstPackage *pkg : parser->packages) {
 		for (AstFile *file : pkg->files) {
 			bool nothing_to_change = true;
-			for (Token const &token : file->tokens) {
-				if (token.flags) {
+			for (isize i = 0; i < file->tokens.count; i++) {
+				if (file->tokens.flags[i]) {
 					nothing_to_change = false;
 					break;
 				}
@@ -3751,6 +4000,23 @@ int main(int arg_count, char const **arg_ptr) {
 	add_collection(str_lit("core"));
 	add_collection(str_lit("vendor"));
 
+#if defined(GB_SYSTEM_OSX) || defined(GB_SYSTEM_UNIX)
+	if (make_string_c(arg_ptr[1]) == "server") {
+		// NOTE: Only returns here within a forked process which then starts the session of a request
+		Array<char const *> request_args = {};
+		int exit_code = 0;
+		if (!server_command(arg_count, arg_ptr, &request_args, &exit_code)) {
+			return exit_code;
+		}
+		arg_count = cast(int)request_args.count;
+		arg_ptr   = request_args.data;
+
+		timings_destroy(&global_timings);
+		timings_init(&global_timings, str_lit("Total Time"), 2048);
+		MAIN_TIME_SECTION("initialization");
+	}
+#endif
+
 	TIME_SECTION("init args");
 	map_init(&build_context.defined_values);
 	build_context.extra_packages.allocator = heap_allocator();
@@ -3934,6 +4200,10 @@ int main(int arg_count, char const **arg_ptr) {
 			return 1;
 		}
 		init_filename = args[3];
+	} else if (command == "server") {
+		// NOTE: handled before the arguments are set up on platforms which support it
+		gb_printf_err("'odin server' is not supported on this platform\n");
+		return 1;
 	} else if (command == "root") {
 		if (args.count != 2) {
 			usage(args[0]);
@@ -3966,6 +4236,7 @@ int main(int arg_count, char const **arg_ptr) {
 	if (!parse_build_flags(args)) {
 		return 1;
 	}
+	global_timings.record_memory = build_context.show_memory;
 
 	if (build_context.show_help) {
 		return print_show_help(args[0], command);
@@ -4229,14 +4500,29 @@ int main(int arg_count, char const **arg_ptr) {
 		}
 	}
 
-	TIME_SECTION("init thread pool");
-	init_global_thread_pool();
-	defer (thread_pool_destroy(&global_thread_pool));
-
 	TIME_SECTION("init universal");
 	init_universal();
 	// TODO(bill): prevent compiling without a linker
 
+	if (build_context.watch) {
+	#if defined(GB_SYSTEM_LINUX)
+		// NOTE: the rebuilds are forked from here, so no threads may have been started yet
+		int exit_code = 0;
+		if (!watch_command(init_filename, &exit_code)) {
+			return exit_code;
+		}
+		timings_init(&global_timings, str_lit("Total Time"), 2048);
+		MAIN_TIME_SECTION("initialization");
+	#else
+		gb_printf_err("-watch is not supported on this platform\n");
+		return 1;
+	#endif
+	}
+
+	TIME_SECTION("init thread pool");
+	init_global_thread_pool();
+	defer (thread_pool_destroy(&global_thread_pool));
+
 	Parser * parser  = permanent_alloc_item<Parser>();
 	Checker *checker = permanent_alloc_item<Checker>();
 	bool failed_to_cache_parsing = false;
@@ -4248,18 +4534,30 @@ int main(int arg_count, char const **arg_ptr) {
 	}
 	defer (destroy_parser(parser));
 
+	if (build_context.cached_ast) {
+		init_ast_snapshot_cache(args);
+	}
+
 	// TODO(jeroen): Remove the `init_filename` param.
 	// Let's put that on `build_context.build_paths[0]` instead.
 	if (parse_packages(parser, init_filename) != ParseFile_None) {
 		GB_ASSERT_MSG(any_errors(), "parse_packages failed but no error was reported.");
 		// We depend on the next conditional block to return 1, after printing errors.
 	}
+#if defined(GB_SYSTEM_LINUX)
+	watch_report_files(parser, nullptr);
+#endif
 
 	if (any_errors()) {
 		print_all_errors();
 		return 1;
 	}
 
+#if defined(GB_SYSTEM_OSX) || defined(GB_SYSTEM_UNIX)
+	// NOTE: Within the session of `odin server` this only returns within a fork, which checks the kept packages
+	server_session_keep_parsed(parser);
+#endif
+
 	checker->parser = parser;
 	init_checker(checker);
 	defer (destroy_checker(checker)); // this is here because of a `goto`
@@ -4271,11 +4569,28 @@ int main(int arg_count, char const **arg_ptr) {
 		}
 	}
 
+	if (build_context.cached_packages) {
+		// NOTE: -show-unused requires the usage information from every procedure body
+		if (build_context.show_unused) {
+			build_context.cached_packages = false;
+		} else {
+			MAIN_TIME_SECTION("load package summaries");
+			load_package_summaries(checker, args);
+		}
+	}
+
 	MAIN_TIME_SECTION("type check");
 	check_parsed_files(checker);
+#if defined(GB_SYSTEM_LINUX)
+	watch_report_files(nullptr, &checker->info);
+#endif
 	if (!build_context.ignore_unused_defineables) {
 		check_defines(&build_context, checker);
 	}
+#if defined(GB_SYSTEM_OSX) || defined(GB_SYSTEM_UNIX)
+	// NOTE: Within the session of `odin server` this only returns within a fork, which serves a single request
+	server_session_keep_checked(checker);
+#endif
 	if (any_errors()) {
 		print_all_errors();
 		return 1;
@@ -4319,6 +4634,10 @@ int main(int arg_count, char const **arg_ptr) {
 	}
 
 	if (build_context.no_output_files) {
+		if (build_context.cached_packages && !any_warnings()) {
+			MAIN_TIME_SECTION("write package summaries");
+			write_package_summaries(checker);
+		}
 		if (build_context.show_unused) {
 			print_show_unused(checker);
 		}
@@ -4345,6 +4664,9 @@ int main(int arg_count, char const **arg_ptr) {
 		failed_to_cache_parsing = true;
 	}
 
+	// NOTE: Code generation only starts once the whole program has been checked, as the minimum dependency set
+	// (which decides what is generated) and the polymorphic instantiations are only known by then. Within the
+	// backend, each module's steps after the procedure generation are scheduled on their own, see lb_llvm_module_pipeline
 	{
 		lbGenerator *gen = permanent_alloc_item<lbGenerator>();
 		if (!lb_init_generator(gen, checker)) {
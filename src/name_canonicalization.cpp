@@ -507,14 +507,11 @@ gb_internal void write_canonical_params(TypeWriter *w, Type *params) {
 	return;
 }
 
-gb_internal u64 type_hash_canonical_type(Type *type) {
+// NOTE: For a type which may still be modified, where `type_hash_canonical_type` would keep a stale hash
+gb_internal u64 type_hash_canonical_type_uncached(Type *type) {
 	if (type == nullptr) {
 		return 0;
 	}
-	u64 prev_hash = type->canonical_hash.load(std::memory_order_relaxed);
-	if (prev_hash != 0) {
-		return prev_hash;
-	}
 
 	// NOTE(tf2spi): Unwrap type aliases similar to are_types_identical*
 	Type *type_unaliased = type;
@@ -539,7 +536,19 @@ gb_internal u64 type_hash_canonical_type(Type *type) {
 		hash &= 0x7fffffffffffffffull;
 		hash = hash ? hash : 1;
 	}
+	return hash;
+}
+
+gb_internal u64 type_hash_canonical_type(Type *type) {
+	if (type == nullptr) {
+		return 0;
+	}
+	u64 prev_hash = type->canonical_hash.load(std::memory_order_relaxed);
+	if (prev_hash != 0) {
+		return prev_hash;
+	}
 
+	u64 hash = type_hash_canonical_type_uncached(type);
 	type->canonical_hash.store(hash, std::memory_order_relaxed);
 
 	return hash;
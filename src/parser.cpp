@@ -2,6 +2,30 @@
 
 gb_global std::atomic<bool> g_parsing_done;
 
+gb_internal TokenLineColumn token_pos_line_column(TokenPos const &pos) {
+	if (!token_pos_is_valid(pos)) {
+		if (pos.offset < 0) {
+			return {-pos.offset, 1};
+		}
+		return {};
+	}
+	// NOTE: no more files are added once the parsing is done, so there is no need to lock for the backend
+	AstFile *file = g_parsing_done.load(std::memory_order_relaxed) ? thread_unsafe_get_ast_file_from_id(pos.file_id)
+	                                                               : thread_safe_get_ast_file_from_id(pos.file_id);
+	if (file == nullptr) {
+		return {};
+	}
+	return tokenizer_line_column(&file->tokenizer, pos.offset);
+}
+
+// NOTE: The line of a token of the file which is being parsed
+gb_internal i32 token_line(AstFile *f, Token const &token) {
+	if (!token_pos_is_valid(token.pos)) {
+		return 0;
+	}
+	return tokenizer_line(&f->tokenizer, token.pos.offset);
+}
+
 gb_internal bool in_vet_packages(AstFile *file) {
 	if (file == nullptr) {
 		return true;
@@ -47,10 +71,11 @@ gb_internal bool file_allow_newline(AstFile *f) {
 gb_internal Token token_end_of_line(AstFile *f, Token tok) {
 	u8 const *start = f->tokenizer.start + tok.pos.offset;
 	u8 const *s = start;
-	while (*s && *s != '\n' && s < f->tokenizer.end) {
+	// NOTE: a memory mapped file (-map-files) is not NUL terminated, so check the end first
+	while (s < f->tokenizer.end && *s && *s != '\n') {
 		s += 1;
 	}
-	tok.pos.column += cast(i32)(s - start) - 1;
+	tok.pos.offset += cast(i32)(s - start) - 1;
 	return tok;
 }
 
@@ -66,26 +91,6 @@ gb_internal gbString get_file_line_as_string(TokenPos const &pos, i32 *offset_)
 	}
 
 	isize offset = pos.offset;
-	if (pos.line != 0 && offset == 0) {
-		for (i32 i = 1; i < pos.line; i++) {
-			while (start+offset < end) {
-				u8 c = start[offset++];
-				if (c == '\n') {
-					break;
-				}
-			}
-		}
-		for (i32 i = 1; i < pos.column; i++) {
-			u8 *ptr = start+offset;
-			u8 c = *ptr;
-			if (c & 0x80) {
-				offset += utf8_decode(ptr, end-ptr, nullptr);
-			} else {
-				offset++;
-			}
-		}
-	}
-
 
 	isize len = end-start;
 	if (len < offset) {
@@ -96,9 +101,10 @@ gb_internal gbString get_file_line_as_string(TokenPos const &pos, i32 *offset_)
 	u8 *line_start = pos_offset;
 	u8 *line_end  = pos_offset;
 
-	if (offset > 0 && *line_start == '\n') {
+	if (offset > 0 && (offset == len || *line_start == '\n')) {
 		// Prevent an error token that starts at the boundary of a line that
 		// leads to an empty line from advancing off its line.
+		// NOTE: nor read past the end of a file which is not NUL terminated, e.g. when memory mapped
 		line_start -= 1;
 	}
 	while (line_start >= start) {
@@ -136,21 +142,30 @@ gb_internal isize ast_node_size(AstKind kind) {
 
 }
 
-// gb_global std::atomic<isize> global_total_node_memory_allocated;
-
 // NOTE(bill): And this below is why is I/we need a new language! Discriminated unions are a pain in C/C++
 gb_internal Ast *alloc_ast_node(AstFile *f, AstKind kind) {
-	isize size = ast_node_size(kind);
+	isize prefix = ast_node_prefix_size(kind);
+	isize size = prefix + ast_node_size(kind);
 
-	Ast *node = cast(Ast *)arena_alloc(get_arena(ThreadArena_Permanent), size, 16);
+	Ast *node = cast(Ast *)(cast(u8 *)arena_alloc(ast_arena(f), size, AST_NODE_ALIGNMENT) + prefix);
 	node->kind = kind;
 	node->file_id = f ? f->id : 0;
 
-	// global_total_node_memory_allocated.fetch_add(size);
+	// NOTE: only the parsing thread of a file allocates its nodes until the parsing is done
+	if (f != nullptr && !g_parsing_done.load(std::memory_order_relaxed)) {
+		f->node_count  += 1;
+		f->node_memory += size;
+	}
 
 	return node;
 }
 
+gb_internal GB_ALLOCATOR_PROC(ast_file_allocator_proc) {
+	AstFile *f = cast(AstFile *)allocator_data;
+	gbAllocator a = f->arena_active ? arena_allocator(f->arena) : permanent_allocator();
+	return a.proc(a.data, type, size, alignment, old_memory, old_size, flags);
+}
+
 gb_internal Ast *clone_ast(Ast *node, AstFile *f = nullptr);
 gb_internal Array<Ast *> clone_ast_array(Array<Ast *> const &array, AstFile *f) {
 	Array<Ast *> result = {};
@@ -186,6 +201,9 @@ gb_internal Ast *clone_ast(Ast *node, AstFile *f) {
 	}
 	Ast *n = alloc_ast_node(f, node->kind);
 	gb_memmove(n, node, ast_node_size(node->kind));
+	if (ast_kind_has_tav(n->kind)) {
+		n->tav_mut() = node->tav();
+	}
 
 	switch (n->kind) {
 	default: GB_PANIC("Unhandled Ast %.*s", LIT(ast_strings[n->kind])); break;
@@ -524,8 +542,6 @@ gb_internal void error(Ast *node, char const *fmt, ...) {
 
 gb_internal void error_range(TokenPos start, TokenPos end, char const *fmt, ...) {
 	GB_ASSERT(start.file_id == end.file_id);
-	GB_ASSERT(start.line == end.line);
-	GB_ASSERT(start.column <= end.column);
 	GB_ASSERT(start.offset <= end.offset);
 
 	va_list va;
@@ -793,14 +809,15 @@ gb_internal Ast *ast_uninit(AstFile *f, Token token) {
 gb_internal ExactValue exact_value_from_token(AstFile *f, Token const &token) {
 	String s = token.string;
 	string_interner_insert(s);
+	// NOTE: the value may outlive the AST (e.g. within a constant) so it is never within the arena of the file
 	switch (token.kind) {
 	case Token_Rune:
-		if (!unquote_string(ast_allocator(f), &s, 0)) {
+		if (!unquote_string(permanent_allocator(), &s, 0)) {
 			syntax_error(token, "Invalid rune literal");
 		}
 		break;
 	case Token_String:
-		if (!unquote_string(ast_allocator(f), &s, 0, s.text[0] == '`')) {
+		if (!unquote_string(permanent_allocator(), &s, 0, s.text[0] == '`')) {
 			syntax_error(token, "Invalid string literal");
 		}
 		break;
@@ -840,8 +857,8 @@ gb_internal String string_value_from_token(AstFile *f, Token const &token) {
 gb_internal Ast *ast_basic_lit(AstFile *f, Token basic_lit) {
 	Ast *result = alloc_ast_node(f, Ast_BasicLit);
 	result->BasicLit.token = basic_lit;
-	result->tav.mode = Addressing_Constant;
-	result->tav.value = exact_value_from_token(f, basic_lit);
+	result->tav_mut().mode = Addressing_Constant;
+	result->tav_mut().value = exact_value_from_token(f, basic_lit);
 	return result;
 }
 
@@ -1431,9 +1448,46 @@ gb_internal Ast *ast_attribute(AstFile *f, Token token, Token open, Token close,
 }
 
 
+// NOTE: Only true while the stream is open, see `token_stream_free`
+gb_internal gb_inline bool ast_file_streams_tokens(AstFile *f) {
+	return f->token_stream.tokenizer != nullptr;
+}
+
+// NOTE: Returns false for an index past the end of the file
+gb_internal bool ast_file_token(AstFile *f, isize index, Token *token) {
+	if (ast_file_streams_tokens(f)) {
+		return token_stream_get(&f->token_stream, index, token);
+	}
+	if (index < f->tokens.count) {
+		*token = token_list_get(&f->tokens, index);
+		return true;
+	}
+	return false;
+}
+
+// NOTE: The count and the first token of a streamed file are still known once its stream has been freed
+gb_internal isize ast_file_token_count(AstFile *f) {
+	if (f->tokens.count == 0) {
+		return token_stream_total_count(&f->token_stream);
+	}
+	return f->tokens.count;
+}
+
+gb_internal Token ast_file_first_token(AstFile *f) {
+	if (f->tokens.count == 0) {
+		return f->token_stream.first;
+	}
+	return token_list_get(&f->tokens, 0);
+}
+
 gb_internal bool next_token0(AstFile *f) {
-	if (f->curr_token_index+1 < f->tokens.count) {
-		f->curr_token = f->tokens[++f->curr_token_index];
+	Token token = {};
+	if (ast_file_token(f, f->curr_token_index+1, &token)) {
+		f->curr_token = token;
+		f->curr_token_index += 1;
+		if (ast_file_streams_tokens(f)) {
+			token_stream_release(&f->token_stream, f->curr_token_index);
+		}
 		return true;
 	}
 	syntax_error(f->curr_token, "Token is EOF");
@@ -1444,7 +1498,7 @@ gb_internal bool next_token0(AstFile *f) {
 gb_internal Token consume_comment(AstFile *f, isize *end_line_) {
 	Token tok = f->curr_token;
 	GB_ASSERT(tok.kind == Token_Comment);
-	isize end_line = tok.pos.line;
+	isize end_line = token_line(f, tok);
 	if (tok.string[1] == '*') {
 		for (isize i = 2; i < tok.string.len; i++) {
 			if (tok.string[i] == '\n') {
@@ -1463,15 +1517,15 @@ gb_internal Token consume_comment(AstFile *f, isize *end_line_) {
 gb_internal CommentGroup *consume_comment_group(AstFile *f, isize n, isize *end_line_) {
 	Array<Token> list = {};
 	list.allocator = ast_allocator(f);
-	isize end_line = f->curr_token.pos.line;
+	isize end_line = token_line(f, f->curr_token);
 	if (f->curr_token_index == 1 &&
 	    f->prev_token.kind == Token_Comment &&
-	    f->prev_token.pos.line+1 == f->curr_token.pos.line) {
+	    token_line(f, f->prev_token)+1 == token_line(f, f->curr_token)) {
 		// NOTE(bill): Special logic for the first comment in the file
 		array_add(&list, f->prev_token);
 	}
 	while (f->curr_token.kind == Token_Comment &&
-	       f->curr_token.pos.line <= end_line+n) {
+	       token_line(f, f->curr_token) <= end_line+n) {
 		array_add(&list, consume_comment(f, &end_line));
 	}
 
@@ -1493,10 +1547,10 @@ gb_internal void consume_comment_groups(AstFile *f, Token prev) {
 	CommentGroup *comment = nullptr;
 	isize end_line = 0;
 
-	if (f->curr_token.pos.line == prev.pos.line) {
+	if (token_line(f, f->curr_token) == token_line(f, prev)) {
 		comment = consume_comment_group(f, 0, &end_line);
-		if (f->curr_token.pos.line != end_line ||
-		    f->curr_token.pos.line == prev.pos.line+1 ||
+		if (token_line(f, f->curr_token) != end_line ||
+		    token_line(f, f->curr_token) == token_line(f, prev)+1 ||
 		    f->curr_token.kind == Token_EOF) {
 			f->line_comment = comment;
 		}
@@ -1506,7 +1560,7 @@ gb_internal void consume_comment_groups(AstFile *f, Token prev) {
 	while (f->curr_token.kind == Token_Comment) {
 		comment = consume_comment_group(f, 1, &end_line);
 	}
-	if (end_line+1 == f->curr_token.pos.line || end_line < 0) {
+	if (end_line+1 == token_line(f, f->curr_token) || end_line < 0) {
 		f->lead_comment = comment;
 	}
 
@@ -1545,26 +1599,24 @@ gb_internal Token advance_token(AstFile *f) {
 
 
 gb_internal Token peek_token(AstFile *f) {
-	for (isize i = f->curr_token_index+1; i < f->tokens.count; i++) {
-		Token tok = f->tokens[i];
-		if (tok.kind == Token_Comment) {
+	Token token = {};
+	for (isize i = f->curr_token_index+1; ast_file_token(f, i, &token); i++) {
+		if (token.kind == Token_Comment) {
 			continue;
 		}
-		return tok;
+		return token;
 	}
 	return {};
 }
 
 gb_internal Token peek_token_n(AstFile *f, isize n) {
-	Token found = {};
-	for (isize i = f->curr_token_index+1; i < f->tokens.count; i++) {
-		Token tok = f->tokens[i];
-		if (tok.kind == Token_Comment) {
+	Token token = {};
+	for (isize i = f->curr_token_index+1; ast_file_token(f, i, &token); i++) {
+		if (token.kind == Token_Comment) {
 			continue;
 		}
-		found = tok;
 		if (n-- == 0) {
-			return found;
+			return token;
 		}
 	}
 	return {};
@@ -1583,7 +1635,7 @@ gb_internal bool skip_possible_newline_for_literal(AstFile *f, bool ignore_stric
 	Token curr = f->curr_token;
 	if (token_is_newline(curr)) {
 		Token next = peek_token(f);
-		if (curr.pos.line+1 >= next.pos.line) {
+		if (token_line(f, curr)+1 >= token_line(f, next)) {
 			switch (next.kind) {
 			case Token_OpenBrace:
 			case Token_else:
@@ -1634,7 +1686,10 @@ gb_internal Token expect_token(AstFile *f, TokenKind kind) {
 		end_error_block();
 
 		if (prev.kind == Token_EOF) {
-			exit_with_errors();
+			if (error_value_buffer == nullptr) {
+				exit_with_errors();
+			}
+			f->unexpected_eof = true;
 		}
 	}
 
@@ -1650,7 +1705,7 @@ gb_internal Token expect_token_after(AstFile *f, TokenKind kind, char const *msg
 		Token token = f->curr_token;
 		if (token_is_newline(curr)) {
 			token = curr;
-			token.pos.column -= 1;
+			token.pos.offset -= 1;
 			skip_possible_newline(f);
 		}
 		syntax_error(token, "Expected '%.*s' after %s, got '%.*s'",
@@ -1662,7 +1717,7 @@ gb_internal Token expect_token_after(AstFile *f, TokenKind kind, char const *msg
 
 	if (ast_file_vet_style(f) &&
 	    prev.kind == Token_Comma &&
-	    prev.pos.line == curr.pos.line) {
+	    token_line(f, prev) == token_line(f, curr)) {
 		syntax_error(prev, "No need for a trailing comma followed by a %.*s on the same line", LIT(token_strings[kind]));
 	}
 	return curr;
@@ -1703,7 +1758,9 @@ gb_internal Token expect_operator(AstFile *f) {
 	}
 	if (prev.kind == Token_Ellipsis) {
 		syntax_error(prev, "'..' for ranges are not allowed, did you mean '..<' or '..='?");
-		f->tokens[f->curr_token_index].flags |= TokenFlag_Replace;
+		if (!ast_file_streams_tokens(f)) {
+			f->tokens.flags[f->curr_token_index] |= TokenFlag_Replace;
+		}
 	}
 	
 	advance_token(f);
@@ -1808,7 +1865,7 @@ gb_internal Token expect_closing(AstFile *f, TokenKind kind, String const &conte
 	    (f->curr_token.string == "\n" || f->curr_token.kind == Token_EOF)) {
 	    	if (f->allow_newline) {
 			Token tok = f->prev_token;
-			tok.pos.column += cast(i32)tok.string.len;
+			tok.pos.offset += cast(i32)tok.string.len;
 			syntax_error(tok, "Missing ',' before newline in %.*s", LIT(context));
 		}
 		advance_token(f);
@@ -1818,17 +1875,17 @@ gb_internal Token expect_closing(AstFile *f, TokenKind kind, String const &conte
 
 gb_internal void assign_removal_flag_to_semicolon(AstFile *f) {
 	// NOTE(bill): this is used for rewriting files to strip unneeded semicolons
-	Token *prev_token = &f->tokens[f->prev_token_index];
-	Token *curr_token = &f->tokens[f->curr_token_index];
-	GB_ASSERT(prev_token->kind == Token_Semicolon);
-	if (prev_token->string != ";") {
+	Token prev_token = f->prev_token;
+	Token curr_token = f->curr_token;
+	GB_ASSERT(prev_token.kind == Token_Semicolon);
+	if (prev_token.string != ";") {
 		return;
 	}
 	bool ok = false;
-	if (curr_token->pos.line > prev_token->pos.line) {
+	if (token_line(f, curr_token) > token_line(f, prev_token)) {
 		ok = true;
-	} else if (curr_token->pos.line == prev_token->pos.line) {
-		switch (curr_token->kind) {
+	} else if (token_line(f, curr_token) == token_line(f, prev_token)) {
+		switch (curr_token.kind) {
 		case Token_CloseBrace:
 		case Token_CloseParen:
 		case Token_EOF:
@@ -1841,9 +1898,11 @@ gb_internal void assign_removal_flag_to_semicolon(AstFile *f) {
 	}
 
 	if (build_context.strict_style || (ast_file_vet_flags(f) & VetFlag_Semicolon)) {
-		syntax_error(*prev_token, "Found unneeded semicolon");
+		syntax_error(prev_token, "Found unneeded semicolon");
+	}
+	if (!ast_file_streams_tokens(f)) {
+		f->tokens.flags[f->prev_token_index] |= TokenFlag_Remove;
 	}
-	prev_token->flags |= TokenFlag_Remove;
 }
 
 gb_internal void expect_semicolon(AstFile *f) {
@@ -1856,7 +1915,7 @@ gb_internal void expect_semicolon(AstFile *f) {
 	switch (f->curr_token.kind) {
 	case Token_CloseBrace:
 	case Token_CloseParen:
-		if (f->curr_token.pos.line == f->prev_token.pos.line) {
+		if (token_line(f, f->curr_token) == token_line(f, f->prev_token)) {
 			return;
 		}
 		break;
@@ -1876,7 +1935,7 @@ gb_internal void expect_semicolon(AstFile *f) {
 		return;
 	}
 
-	if (f->curr_token.pos.line == f->prev_token.pos.line) {
+	if (token_line(f, f->curr_token) == token_line(f, f->prev_token)) {
 		String p = token_to_string(f->curr_token);
 		prev_token.pos = token_pos_end(prev_token);
 		syntax_error(prev_token, "Expected ';', got %.*s", LIT(p));
@@ -1890,6 +1949,8 @@ gb_internal Ast *        parse_proc_type(AstFile *f, Token proc_token);
 gb_internal Array<Ast *> parse_stmt_list(AstFile *f);
 gb_internal Ast *        parse_stmt(AstFile *f);
 gb_internal Ast *        parse_body(AstFile *f);
+gb_internal Ast *        parse_deferred_body(AstFile *f);
+gb_internal bool         ast_file_should_defer_proc_body(AstFile *f);
 gb_internal Ast *        parse_do_body(AstFile *f, Token const &token, char const *msg);
 gb_internal Ast *        parse_block_stmt(AstFile *f, b32 is_when);
 
@@ -2119,8 +2180,8 @@ gb_internal Ast *convert_stmt_to_expr(AstFile *f, Ast *statement, String const &
 
 	syntax_error(f->curr_token, "Expected '%.*s', found a simple statement.", LIT(kind));
 	Token end = f->curr_token;
-	if (f->tokens.count < f->curr_token_index) {
-		end = f->tokens[f->curr_token_index+1];
+	if (ast_file_token_count(f) < f->curr_token_index) {
+		ast_file_token(f, f->curr_token_index+1, &end);
 	}
 	return ast_bad_expr(f, f->curr_token, end);
 }
@@ -2163,9 +2224,9 @@ gb_internal void check_polymorphic_params_for_type(AstFile *f, Ast *polymorphic_
 	}
 }
 
-gb_internal bool ast_on_same_line(Token const &x, Ast *yp) {
+gb_internal bool ast_on_same_line(AstFile *f, Token const &x, Ast *yp) {
 	Token y = ast_token(yp);
-	return x.pos.line == y.pos.line;
+	return token_line(f, x) == token_line(f, y);
 }
 
 gb_internal Ast *parse_inlining_or_tailing_operand(AstFile *f, Token token) {
@@ -2598,9 +2659,13 @@ gb_internal Ast *parse_operand(AstFile *f, bool lhs) {
 		} else if (f->curr_token.kind == Token_OpenBrace) {
 			Ast *curr_proc = f->curr_proc;
 			Ast *body = nullptr;
-			f->curr_proc = type;
-			body = parse_body(f);
-			f->curr_proc = curr_proc;
+			if (ast_file_should_defer_proc_body(f)) {
+				body = parse_deferred_body(f);
+			} else {
+				f->curr_proc = type;
+				body = parse_body(f);
+				f->curr_proc = curr_proc;
+			}
 
 			// Apply the tags directly to the body rather than the type
 			if (tags & ProcTag_no_bounds_check) {
@@ -3231,7 +3296,7 @@ gb_internal Ast *parse_call_expr(AstFile *f, Ast *operand) {
 		}
 		array_add(&args, arg);
 
-		if (ellipsis.pos.line != 0) {
+		if (token_pos_is_valid(ellipsis.pos)) {
 			seen_ellipsis = true;
 		}
 
@@ -3583,7 +3648,7 @@ gb_internal Ast *parse_binary_expr(AstFile *f, bool lhs, i32 prec_in) {
 		switch (op.kind) {
 		case Token_if:
 		case Token_when:
-			if (prev.pos.line < op.pos.line) {
+			if (token_line(f, prev) < token_line(f, op)) {
 				// NOTE(bill): Check to see if the `if` or `when` is on the same line of the `lhs` condition
 				if (f->expr_level <= 0) {
 					goto loop_end;
@@ -3812,7 +3877,7 @@ gb_internal Ast *parse_value_decl(AstFile *f, Array<Ast *> names, CommentGroup *
 
 	if (f->expr_level >= 0) {
 		if (f->curr_token.kind == Token_CloseBrace &&
-		    f->curr_token.pos.line == f->prev_token.pos.line) {
+		    token_line(f, f->curr_token) == token_line(f, f->prev_token)) {
 
 		} else {
 			expect_semicolon(f);
@@ -4703,6 +4768,46 @@ gb_internal Ast *parse_body(AstFile *f) {
 	return ast_block_stmt(f, stmts, open, close);
 }
 
+// NOTE: Only the bodies of the procedures at the file scope are deferred, as the state of the parser is then
+// known when the body is parsed on its own, see `parse_deferred_proc_body`
+gb_internal bool ast_file_should_defer_proc_body(AstFile *f) {
+	return build_context.internal_defer_proc_bodies &&
+	       !build_context.cached_ast &&                          // the snapshots hold the whole AST
+	       build_context.command_kind != Command_strip_semicolon &&
+	       build_context.command_kind != Command_doc &&
+	       f->curr_proc == nullptr &&
+	       !f->allow_range &&
+	       !f->allow_in_expr &&
+	       !f->allow_type &&
+	       f->allow_newline == file_allow_newline(f);
+}
+
+// NOTE: Skips over the tokens of the body to its matching brace, and leaves an empty block in its place
+gb_internal Ast *parse_deferred_body(AstFile *f) {
+	Token open = expect_token(f, Token_OpenBrace);
+	isize depth = 1;
+	while (f->curr_token.kind != Token_EOF) {
+		Token token = f->curr_token;
+		if (token.kind == Token_OpenBrace) {
+			depth += 1;
+		} else if (token.kind == Token_CloseBrace) {
+			depth -= 1;
+			if (depth == 0) {
+				break;
+			}
+		} else if (token.kind == Token_Ident && f->prev_token.kind == Token_Hash && string_starts_with(token.string, str_lit("load"))) {
+			// NOTE: as `ast_basic_directive` would have, as it decides whether -cached may be used
+			f->seen_load_directive_count++;
+		}
+		advance_token(f);
+	}
+	Token close = expect_token(f, Token_CloseBrace);
+
+	Ast *body = ast_block_stmt(f, {}, open, close);
+	body->state_flags |= StateFlag_DeferredBody;
+	return body;
+}
+
 gb_internal Ast *parse_do_body(AstFile *f, Token const &token, char const *msg) {
 	Token open, close;
 	isize prev_expr_level = f->expr_level;
@@ -4715,7 +4820,7 @@ gb_internal Ast *parse_do_body(AstFile *f, Token const &token, char const *msg)
 	Ast *body = convert_stmt_to_body(f, parse_stmt(f));
 	if (build_context.disallow_do) {
 		syntax_error(body, "'do' has been disallowed");
-	} else if (token.pos.file_id != 0 && !ast_on_same_line(token, body)) {
+	} else if (token.pos.file_id != 0 && !ast_on_same_line(f, token, body)) {
 		syntax_error(body, "The body of a 'do' must be on the same line as %s", msg);
 	}
 	f->expr_level = prev_expr_level;
@@ -4789,7 +4894,7 @@ if_else_chain:;
 	}
 
 	bool ignore_strict_style = false;
-	if (token.pos.line == ast_end_token(body).pos.line) {
+	if (token_line(f, token) == token_line(f, ast_end_token(body))) {
 		ignore_strict_style = true;
 	}
 	skip_possible_newline_for_literal(f, ignore_strict_style);
@@ -4818,10 +4923,12 @@ if_else_chain:;
 			expect_token(f, Token_do);
 			else_stmt = parse_do_body(f, else_token, "'else'");
 			break;
-		default:
+		default: {
 			syntax_error(f->curr_token, "Expected if statement block statement");
-			else_stmt = ast_bad_stmt(f, f->curr_token, f->tokens[f->curr_token_index+1]);
-			break;
+			Token end = f->curr_token;
+			ast_file_token(f, f->curr_token_index+1, &end);
+			else_stmt = ast_bad_stmt(f, f->curr_token, end);
+		} break;
 		}
 	}
 
@@ -4859,7 +4966,7 @@ gb_internal Ast *parse_when_stmt(AstFile *f) {
 	}
 
 	bool ignore_strict_style = false;
-	if (token.pos.line == ast_end_token(body).pos.line) {
+	if (token_line(f, token) == token_line(f, ast_end_token(body))) {
 		ignore_strict_style = true;
 	}
 	skip_possible_newline_for_literal(f, ignore_strict_style);
@@ -4876,10 +4983,12 @@ gb_internal Ast *parse_when_stmt(AstFile *f) {
 			expect_token(f, Token_do);
 			else_stmt = parse_do_body(f, else_token, "'else'");
 		} break;
-		default:
+		default: {
 			syntax_error(f->curr_token, "Expected when statement block statement");
-			else_stmt = ast_bad_stmt(f, f->curr_token, f->tokens[f->curr_token_index+1]);
-			break;
+			Token end = f->curr_token;
+			ast_file_token(f, f->curr_token_index+1, &end);
+			else_stmt = ast_bad_stmt(f, f->curr_token, end);
+		} break;
 		}
 	}
 	f->in_when_statement = was_in_when_statement;
@@ -5562,18 +5671,18 @@ gb_internal Ast *parse_stmt(AstFile *f) {
 		} else if (tag == "define") {
 			s = ast_bad_stmt(f, token, f->curr_token);
 
-			if (name.pos.line == f->curr_token.pos.line) {
+			if (token_line(f, name) == token_line(f, f->curr_token)) {
 				bool call_like = false;
 				Ast *macro_expr = nullptr;
 				Token ident = f->curr_token;
 				if (allow_token(f, Token_Ident) &&
-				    name.pos.line == f->curr_token.pos.line) {
-					if (f->curr_token.kind == Token_OpenParen && f->curr_token.pos.column == ident.pos.column+ident.string.len) {
+				    token_line(f, name) == token_line(f, f->curr_token)) {
+					if (f->curr_token.kind == Token_OpenParen && f->curr_token.pos.offset == ident.pos.offset+ident.string.len) {
 						call_like = true;
 						(void)parse_call_expr(f, nullptr);
 					}
 
-					if (name.pos.line == f->curr_token.pos.line && f->curr_token.kind != Token_Semicolon) {
+					if (token_line(f, name) == token_line(f, f->curr_token) && f->curr_token.kind != Token_Semicolon) {
 						macro_expr = parse_expr(f, false);
 					}
 				}
@@ -5657,7 +5766,7 @@ gb_internal void parse_enforce_tabs(AstFile *f) {
 
        	Token prev = f->prev_token;
 	Token curr = f->curr_token;
-	if (prev.pos.line < curr.pos.line) {
+	if (token_line(f, prev) < token_line(f, curr)) {
 		u8 *start = f->tokenizer.start+prev.pos.offset;
 		u8 *end   = f->tokenizer.start+curr.pos.offset;
 		u8 *it = end;
@@ -5705,8 +5814,31 @@ gb_internal Array<Ast *> parse_stmt_list(AstFile *f) {
 	return list;
 }
 
+#include "parser_snapshot.cpp"
+#include "parser_io.cpp"
+
+gb_internal bool ast_file_should_parse_in_parallel(isize file_size);
+
+// NOTE: The whole list of tokens of a file is only needed by the AST snapshots, `strip-semicolon`, and
+// the parsing of a large file in parallel, otherwise the parser pulls the tokens from the tokenizer as
+// it goes and only keeps its lookahead
+gb_internal bool ast_file_should_stream_tokens(isize file_size) {
+	return !build_context.internal_no_token_stream &&
+	       !build_context.cached_ast &&
+	       build_context.command_kind != Command_strip_semicolon &&
+	       !ast_file_should_parse_in_parallel(file_size);
+}
 
-gb_internal ParseFileError init_ast_file(AstFile *f, String const &fullpath, TokenPos *err_pos) {
+// NOTE: The comments are only used for the documentation of the declarations
+gb_internal bool ast_file_should_keep_comments(void) {
+	return build_context.generate_docs ||
+	       build_context.command_kind == Command_doc ||
+	       build_context.show_defineables ||
+	       build_context.export_defineables_file.len != 0;
+}
+
+// NOTE: `loaded_file` is the contents already read by the I/O stage, if any
+gb_internal ParseFileError init_ast_file(AstFile *f, String const &fullpath, TokenPos *err_pos, LoadedFile const *loaded_file = nullptr, LoadedFileError load_error = LoadedFile_None) {
 	GB_ASSERT(f != nullptr);
 	f->fullpath  = string_trim_whitespace(fullpath); // Just in case
 	f->filename  = remove_directory_from_path(f->fullpath);
@@ -5719,7 +5851,13 @@ gb_internal ParseFileError init_ast_file(AstFile *f, String const &fullpath, Tok
 	gb_zero_item(&f->tokenizer);
 	f->tokenizer.curr_file_id = f->id;
 
-	TokenizerInitError err = init_tokenizer_from_fullpath(&f->tokenizer, f->fullpath, build_context.copy_file_contents);
+	TokenizerInitError err = TokenizerInit_None;
+	if (loaded_file != nullptr) {
+		f->tokenizer.loaded_file = *loaded_file;
+		err = init_tokenizer_from_loaded_file(&f->tokenizer, f->fullpath, load_error);
+	} else {
+		err = init_tokenizer_from_fullpath(&f->tokenizer, f->fullpath, build_context.file_load_mode);
+	}
 	if (err != TokenizerInit_None) {
 		switch (err) {
 		case TokenizerInit_Empty:
@@ -5736,48 +5874,55 @@ gb_internal ParseFileError init_ast_file(AstFile *f, String const &fullpath, Tok
 
 	}
 
-	isize file_size = f->tokenizer.end - f->tokenizer.start;
-
-	// NOTE(bill): Determine allocation size required for tokens
-	isize token_cap = file_size/3ll;
-	isize pow2_cap = gb_max(cast(isize)prev_pow2(cast(i64)token_cap)/2, 16);
-	token_cap = ((token_cap + pow2_cap-1)/pow2_cap) * pow2_cap;
-
-	isize init_token_cap = gb_max(token_cap, 16);
-	array_init(&f->tokens, ast_allocator(f), 0, gb_max(init_token_cap, 16));
-
-	if (err == TokenizerInit_Empty) {
-		Token token = {Token_EOF};
-		token.pos.file_id = f->id;
-		token.pos.line    = 1;
-		token.pos.column  = 1;
-		array_add(&f->tokens, token);
+	if (build_context.cached_ast && err != TokenizerInit_Empty && ast_snapshot_load(f)) {
 		return ParseFile_None;
 	}
 
-	u64 start = time_stamp_time_now();
+	if (err != TokenizerInit_Empty && ast_file_should_stream_tokens(f->tokenizer.end - f->tokenizer.start)) {
+		// NOTE: the tokenizing is then part of the parsing time
+		token_stream_init(&f->token_stream, heap_allocator(), &f->tokenizer, ast_file_should_keep_comments());
+	} else {
+		isize file_size = f->tokenizer.end - f->tokenizer.start;
 
-	for (;;) {
-		Token *token = array_add_and_get(&f->tokens);
-		tokenizer_get_token(&f->tokenizer, token);
-		if (token->kind == Token_Invalid) {
-			err_pos->line   = token->pos.line;
-			err_pos->column = token->pos.column;
-			return ParseFile_InvalidToken;
+		// NOTE(bill): Determine allocation size required for tokens
+		isize token_cap = file_size/3ll;
+		isize pow2_cap = gb_max(cast(isize)prev_pow2(cast(i64)token_cap)/2, 16);
+		token_cap = ((token_cap + pow2_cap-1)/pow2_cap) * pow2_cap;
+
+		isize init_token_cap = gb_max(token_cap, 16);
+		token_list_init(&f->tokens, ast_allocator(f), &f->tokenizer, init_token_cap);
+
+		if (err == TokenizerInit_Empty) {
+			Token token = {Token_EOF};
+			token.pos.file_id = f->id;
+			token_list_add(&f->tokens, token);
+			return ParseFile_None;
 		}
 
-		if (token->kind == Token_EOF) {
-			break;
+		u64 start = time_stamp_time_now();
+
+		for (;;) {
+			Token token = {};
+			tokenizer_get_token(&f->tokenizer, &token);
+			if (token.kind == Token_Invalid) {
+				err_pos->offset = token.pos.offset;
+				return ParseFile_InvalidToken;
+			}
+
+			token_list_add(&f->tokens, token);
+			if (token.kind == Token_EOF) {
+				break;
+			}
 		}
-	}
 
-	u64 end = time_stamp_time_now();
-	f->time_to_tokenize = cast(f64)(end-start)/cast(f64)time_stamp__freq();
+		u64 end = time_stamp_time_now();
+		f->time_to_tokenize = cast(f64)(end-start)/cast(f64)time_stamp__freq();
+	}
 
 	f->prev_token_index = 0;
 	f->curr_token_index = 0;
-	f->prev_token = f->tokens[f->prev_token_index];
-	f->curr_token = f->tokens[f->curr_token_index];
+	ast_file_token(f, 0, &f->curr_token);
+	f->prev_token = f->curr_token;
 
 	array_init(&f->comments, ast_allocator(f), 0, 0);
 	array_init(&f->imports,  ast_allocator(f), 0, 0);
@@ -5787,9 +5932,23 @@ gb_internal ParseFileError init_ast_file(AstFile *f, String const &fullpath, Tok
 	return ParseFile_None;
 }
 
+// NOTE: Must only be called once nothing will use the AST or tokens of the file again, i.e. after the code generation
+gb_internal void ast_file_release_memory(AstFile *f) {
+	if (f->arena == nullptr) {
+		return;
+	}
+	GB_ASSERT(!f->arena_active);
+	f->tokens     = {};
+	f->comments   = {};
+	f->imports    = {};
+	f->decls      = {};
+	f->pkg_decl   = nullptr;
+	arena_free_all(f->arena);
+}
+
 gb_internal void destroy_ast_file(AstFile *f) {
 	GB_ASSERT(f != nullptr);
-	array_free(&f->tokens);
+	token_list_free(&f->tokens);
 	array_free(&f->comments);
 	array_free(&f->imports);
 }
@@ -5851,7 +6010,11 @@ gb_internal void parser_add_file_to_process(Parser *p, AstPackage *pkg, FileInfo
 	auto wd = permanent_alloc_item<ParserWorkerData>();
 	wd->parser = p;
 	wd->imported_file = f;
-	thread_pool_add_task(parser_worker_proc, wd);
+	if (parser_io_is_running()) {
+		parser_io_add_file(wd);
+	} else {
+		thread_pool_add_task(parser_worker_proc, wd);
+	}
 }
 
 gb_internal WORKER_TASK_PROC(foreign_file_worker_proc) {
@@ -5893,39 +6056,10 @@ gb_internal void parser_add_foreign_file_to_process(Parser *p, AstPackage *pkg,
 }
 
 
-// NOTE(bill): Returns true if it's added
-gb_internal AstPackage *try_add_import_path(Parser *p, String path, String const &rel_path, TokenPos pos, PackageKind kind = Package_Normal) {
+// NOTE: Lists the directory of the package, and adds the package and its files if it is valid
+gb_internal bool parser_add_package_files(Parser *p, AstPackage *pkg, String const &rel_path, TokenPos pos) {
 	String const FILE_EXT = str_lit(".odin");
-
-	MUTEX_GUARD_BLOCK(&p->imported_files_mutex) {
-		if (string_set_update(&p->imported_files, path)) {
-			return nullptr;
-		}
-	}
-
-	path = copy_string(permanent_allocator(), path);
-
-	AstPackage *pkg = permanent_alloc_item<AstPackage>();
-	pkg->kind = kind;
-	pkg->fullpath = path;
-	array_init(&pkg->files, permanent_allocator());
-	pkg->foreign_files.allocator = permanent_allocator();
-
-	// NOTE(bill): Single file initial package
-	if (kind == Package_Init && !path_is_directory(path) && string_ends_with(path, FILE_EXT)) {
-		FileInfo fi = {};
-		fi.name = filename_from_path(path);
-		fi.fullpath = path;
-		fi.size = get_file_size(path);
-		fi.is_dir = false;
-
-		array_reserve(&pkg->files, 1);
-		pkg->is_single_file = true;
-		parser_add_package(p, pkg);
-		parser_add_file_to_process(p, pkg, fi, pos);
-		return pkg;
-	}
-
+	String path = pkg->fullpath;
 
 	Array<FileInfo> list = {};
 	ReadDirectoryError rd_err = read_directory(path, &list);
@@ -5939,27 +6073,27 @@ gb_internal AstPackage *try_add_import_path(Parser *p, String path, String const
 	switch (rd_err) {
 	case ReadDirectory_InvalidPath:
 		syntax_error(pos, "Invalid path: %.*s", LIT(rel_path));
-		return nullptr;
+		return false;
 	case ReadDirectory_NotExists:
 		syntax_error(pos, "Path does not exist: %.*s", LIT(rel_path));
-		return nullptr;
+		return false;
 	case ReadDirectory_Permission:
 		syntax_error(pos, "Unknown error whilst reading path %.*s", LIT(rel_path));
-		return nullptr;
+		return false;
 	case ReadDirectory_NotDir:
 		syntax_error(pos, "Expected a directory for a package, got a file: %.*s", LIT(rel_path));
-		return nullptr;
+		return false;
 	case ReadDirectory_Empty:
 		syntax_error(pos, "Empty directory: %.*s", LIT(rel_path));
-		return nullptr;
+		return false;
 	case ReadDirectory_Unknown:
 		syntax_error(pos, "Unknown error whilst reading path %.*s", LIT(rel_path));
-		return nullptr;
+		return false;
 	}
 
 	if (string_ends_with(path, str_lit(".odin"))) {
 		error(pos, "'import' declarations cannot import directories with a .odin extension/suffix");
-		return nullptr;
+		return false;
 	}
 
 	isize files_with_ext = 0;
@@ -5984,7 +6118,7 @@ gb_internal AstPackage *try_add_import_path(Parser *p, String path, String const
 		if (build_context.command_kind == Command_test) {
 			error_line("\tSuggestion: Make an .odin file that imports packages to test and use the `-all-packages` flag.");
 		}
-		return nullptr;
+		return false;
 	}
 
 
@@ -6006,7 +6140,51 @@ gb_internal AstPackage *try_add_import_path(Parser *p, String path, String const
 	}
 
 	parser_add_package(p, pkg);
+	return true;
+}
+
+// NOTE(bill): Returns true if it's added
+// NOTE: With `list_in_io_stage`, the package is returned before its directory has been listed, and it
+// is only added later on if it is valid
+gb_internal AstPackage *try_add_import_path(Parser *p, String path, String const &rel_path, TokenPos pos, PackageKind kind = Package_Normal, bool list_in_io_stage = false) {
+	String const FILE_EXT = str_lit(".odin");
+
+	MUTEX_GUARD_BLOCK(&p->imported_files_mutex) {
+		if (string_set_update(&p->imported_files, path)) {
+			return nullptr;
+		}
+	}
+
+	path = copy_string(permanent_allocator(), path);
+
+	AstPackage *pkg = permanent_alloc_item<AstPackage>();
+	pkg->kind = kind;
+	pkg->fullpath = path;
+	array_init(&pkg->files, permanent_allocator());
+	pkg->foreign_files.allocator = permanent_allocator();
 
+	// NOTE(bill): Single file initial package
+	if (kind == Package_Init && !path_is_directory(path) && string_ends_with(path, FILE_EXT)) {
+		FileInfo fi = {};
+		fi.name = filename_from_path(path);
+		fi.fullpath = path;
+		fi.size = get_file_size(path);
+		fi.is_dir = false;
+
+		array_reserve(&pkg->files, 1);
+		pkg->is_single_file = true;
+		parser_add_package(p, pkg);
+		parser_add_file_to_process(p, pkg, fi, pos);
+		return pkg;
+	}
+
+	if (list_in_io_stage && parser_io_is_running()) {
+		parser_io_add_package(p, pkg, rel_path, pos);
+		return pkg;
+	}
+	if (!parser_add_package_files(p, pkg, rel_path, pos)) {
+		return nullptr;
+	}
 	return pkg;
 }
 
@@ -6324,7 +6502,7 @@ gb_internal void parse_setup_file_decls(Parser *p, AstFile *f, String const &bas
 			if (is_package_name_reserved(import_path)) {
 				continue;
 			}
-			try_add_import_path(p, import_path, original_string, ast_token(node).pos);
+			try_add_import_path(p, import_path, original_string, ast_token(node).pos, Package_Normal, true);
 		} else if (node->kind == Ast_ForeignImportDecl) {
 			ast_node(fl, ForeignImportDecl, node);
 
@@ -6818,15 +6996,385 @@ gb_internal bool parse_file_tag(const String &lc, const Token &tok, AstFile *f)
 	return true;
 }
 
+gb_internal void check_file_package_name(AstFile *f, Token const &package_name) {
+	if (package_name.string == "_") {
+		syntax_error(package_name, "Invalid package name '_'");
+	} else if (f->pkg->kind != Package_Runtime && package_name.string == "runtime") {
+		syntax_error(package_name, "Use of reserved package name '%.*s'", LIT(package_name.string));
+	} else if (is_package_name_reserved(package_name.string)) {
+		syntax_error(package_name, "Use of reserved package name '%.*s'", LIT(package_name.string));
+	}
+}
+
+// NOTE: The declarations were restored by `ast_snapshot_load`, so only the parts of `parse_file` which
+// depend upon the package and the build settings rather than the contents of the file are redone
+gb_internal bool parse_file_from_snapshot(Parser *p, AstFile *f) {
+	u64 start = time_stamp_time_now();
+
+	String base_dir = dir_from_path(f->tokenizer.fullpath);
+
+	for (isize i = 0; i < f->tokens.count; i++) {
+		TokenKind kind = token_list_kind(&f->tokens, i);
+		if (kind == Token_package) {
+			break;
+		}
+		if (kind == Token_FileTag) {
+			Token tok = token_list_get(&f->tokens, i);
+			String lt = string_trim_whitespace(substring(tok.string, 2, tok.string.len));
+			if (parse_file_tag(lt, tok, f) == false) {
+				return false;
+			}
+		}
+	}
+	if (f->pkg_decl != nullptr) {
+		check_file_package_name(f, f->pkg_decl->PackageDecl.name);
+	}
+
+	parse_setup_file_decls(p, f, base_dir, f->decls);
+
+	u64 end = time_stamp_time_now();
+	f->time_to_parse = cast(f64)(end-start)/cast(f64)time_stamp__freq();
+
+	for (int i = 0; i < AstDelayQueue_COUNT; i++) {
+		array_init(f->delayed_decls_queues+i, ast_allocator(f), 0, f->delayed_decl_count);
+	}
+
+	return f->error_count == 0;
+}
+
+// NOTE: Parses a body which was skipped by `parse_deferred_body`, once its procedure is checked. The body is
+// tokenized again from the source of its file into a parser of its own, as the checker may parse the bodies
+// of a file on any thread, and its statements are then filled into the empty block in place. Returns false
+// if parsing the body reported any error; those are counted on this thread alone, as other threads keep
+// reporting errors of their own meanwhile.
+gb_internal bool parse_deferred_proc_body(Ast *body) {
+	if (body == nullptr || (body->state_flags & StateFlag_DeferredBody) == 0) {
+		return true;
+	}
+	GB_ASSERT(body->kind == Ast_BlockStmt);
+	AstFile *f = body->thread_safe_file();
+	i64 error_count = current_thread_error_count();
+
+	AstFile bf = {};
+	bf.id                = f->id;
+	bf.flags             = f->flags;
+	bf.pkg               = f->pkg;
+	bf.fullpath          = f->fullpath;
+	bf.filename          = f->filename;
+	bf.directory         = f->directory;
+	bf.tokenizer         = f->tokenizer;
+	bf.package_token     = f->package_token;
+	bf.package_name      = f->package_name;
+	bf.vet_flags         = f->vet_flags;
+	bf.feature_flags     = f->feature_flags;
+	bf.vet_flags_set     = f->vet_flags_set;
+	bf.feature_flags_set = f->feature_flags_set;
+	bf.curr_proc         = body; // NOTE: only ever checked for whether the parser is within a procedure
+	bf.allow_newline     = file_allow_newline(&bf);
+	array_init(&bf.comments, heap_allocator(), 0, 0);
+
+	tokenizer_seek(&bf.tokenizer, body->BlockStmt.open.pos.offset);
+	token_stream_init(&bf.token_stream, heap_allocator(), &bf.tokenizer, ast_file_should_keep_comments());
+	ast_file_token(&bf, 0, &bf.curr_token);
+	bf.prev_token = bf.curr_token;
+
+	Ast *parsed = parse_body(&bf);
+	GB_ASSERT(parsed->BlockStmt.close.pos.offset == body->BlockStmt.close.pos.offset || current_thread_error_count() != error_count);
+
+	token_stream_free(&bf.token_stream);
+	array_free(&bf.comments);
+
+	body->BlockStmt.stmts = parsed->BlockStmt.stmts;
+	body->state_flags &= ~StateFlag_DeferredBody;
+	return current_thread_error_count() == error_count;
+}
+
+// NOTE: Parses the top level declarations until the end of the file, or until the token at `end_index` has been passed
+gb_internal void parse_file_decls(AstFile *f, Array<Ast *> *decls, isize end_index) {
+	while (f->curr_token.kind != Token_EOF && f->curr_token_index <= end_index) {
+		Ast *stmt = parse_stmt(f);
+		if (stmt && stmt->kind != Ast_EmptyStmt) {
+			array_add(decls, stmt);
+			if (stmt->kind == Ast_ExprStmt &&
+			    stmt->ExprStmt.expr != nullptr &&
+			    stmt->ExprStmt.expr->kind == Ast_ProcLit) {
+				syntax_error(stmt, "Procedure literal evaluated but not used");
+			}
+
+			f->total_file_decl_count += calc_decl_count(stmt);
+			if (stmt->kind == Ast_WhenStmt || stmt->kind == Ast_ExprStmt || stmt->kind == Ast_ImportDecl || stmt->kind == Ast_ForeignBlockDecl) {
+				f->delayed_decl_count += 1;
+			}
+		}
+	}
+}
+
+/*
+	A large file (e.g. generated bindings) is split into chunks at the boundaries of its top level declarations,
+	and the chunks are parsed concurrently. Each chunk has its own AstFile for the state of its parser, which
+	shares the tokens of the actual file, and starts at a semicolon as if the parser of the whole file had just
+	reached it, so the AST of a chunk is the same as that of the whole file. The first chunk is parsed into the
+	actual file by the thread which is parsing it.
+*/
+struct ParserChunk {
+	AstFile *         file;
+	isize             start_index; // the semicolon before its first declaration
+	isize             end_index;   // the semicolon which starts the next chunk
+	isize             first_index; // the token after the semicolon (and its comments), at which the previous chunk must stop
+	Array<Ast *>      decls;
+	Array<ErrorValue> errors;      // held back until it is known whether the chunk is kept
+	bool              discarded;
+};
+
+gb_internal bool ast_file_should_parse_in_parallel(isize file_size) {
+	return build_context.thread_count > 1 &&
+	       file_size >= PARSER_PARALLEL_FILE_MIN_SIZE &&
+	       !build_context.release_emitted_packages &&          // the arena of the file is only used by a single thread
+	       build_context.command_kind != Command_strip_semicolon; // the token flags are written whilst parsing
+}
+
+// NOTE: The boundaries are found from the kinds of the tokens alone: a semicolon outside of any braces, parentheses,
+// or brackets, which is followed by an identifier or an attribute, and which does not end a line of attributes
+// (as they apply to the declaration on the next line). Any other statement which could continue onto the next
+// line would have to continue with a keyword or an opening brace.
+gb_internal void parse_file_find_chunk_boundaries(AstFile *f, isize start_index, isize chunk_size, Array<isize> *boundaries) {
+	enum State {
+		State_Start,
+		State_At,
+		State_AttributeArgs,
+		State_Attributes,
+		State_Other,
+	};
+
+	TokenList const *tokens = &f->tokens;
+	State state = State_Start;
+	isize depth = 0;
+	i64 next_offset = cast(i64)tokens->offsets[start_index] + chunk_size;
+	for (isize i = start_index; i < tokens->count; i++) {
+		TokenKind kind = token_list_kind(tokens, i);
+		switch (kind) {
+		case Token_Comment:
+			break;
+		case Token_OpenParen:
+		case Token_OpenBrace:
+		case Token_OpenBracket:
+			if (depth == 0) {
+				state = (state == State_At && kind == Token_OpenParen) ? State_AttributeArgs : State_Other;
+			}
+			depth += 1;
+			break;
+		case Token_CloseParen:
+		case Token_CloseBrace:
+		case Token_CloseBracket:
+			depth = gb_max(depth-1, 0);
+			if (depth == 0 && state == State_AttributeArgs) {
+				state = State_Attributes;
+			}
+			break;
+		case Token_Semicolon:
+			if (depth != 0 || state == State_Attributes) {
+				break;
+			}
+			if (state != State_Start && tokens->offsets[i] >= next_offset) {
+				isize next = i+1;
+				while (next < tokens->count && token_list_kind(tokens, next) == Token_Comment) {
+					next += 1;
+				}
+				if (next < tokens->count && (token_list_kind(tokens, next) == Token_Ident || token_list_kind(tokens, next) == Token_At)) {
+					array_add(boundaries, i);
+					next_offset = cast(i64)tokens->offsets[i] + chunk_size;
+				}
+			}
+			state = State_Start;
+			break;
+		case Token_At:
+			if (depth == 0) {
+				state = (state == State_Start || state == State_Attributes) ? State_At : State_Other;
+			}
+			break;
+		case Token_Ident:
+			if (depth == 0) {
+				state = state == State_At ? State_Attributes : State_Other;
+			}
+			break;
+		default:
+			if (depth == 0) {
+				state = State_Other;
+			}
+			break;
+		}
+	}
+}
+
+gb_internal WORKER_TASK_PROC(parser_chunk_worker_proc) {
+	ParserChunk *chunk = cast(ParserChunk *)data;
+	AstFile *f = chunk->file;
+
+	// NOTE: advances past the semicolon (and any comments after it) as the parser of the whole file would
+	f->curr_token_index = chunk->start_index;
+	f->curr_token = token_list_get(&f->tokens, chunk->start_index);
+	advance_token(f);
+	chunk->first_index = f->curr_token_index;
+
+	// NOTE: the task may be run by the thread parsing the whole file whilst it waits, which may hold its errors back too
+	Array<ErrorValue> *prev_error_buffer = error_value_buffer;
+	error_value_buffer = &chunk->errors;
+	parse_file_decls(f, &chunk->decls, chunk->end_index);
+	error_value_buffer = prev_error_buffer;
+	return 0;
+}
+
+// NOTE: Drops the comments from the offset onwards, which were reached by the parser of a chunk after its end
+gb_internal void ast_file_trim_comments(Array<CommentGroup *> *comments, i32 end_offset) {
+	while (comments->count > 0) {
+		CommentGroup *group = comments->data[comments->count-1];
+		if (group->list.count > 0 && group->list[0].pos.offset < end_offset) {
+			break;
+		}
+		array_pop(comments);
+	}
+}
+
+gb_internal void parse_file_decls_in_parallel(AstFile *f, Array<Ast *> *decls) {
+	isize file_size = f->tokenizer.end - f->tokenizer.start;
+	isize chunk_size = gb_max(cast(isize)PARSER_CHUNK_MIN_SIZE, file_size/(2*build_context.thread_count));
+
+	auto boundaries = array_make<isize>(heap_allocator(), 0, file_size/chunk_size + 1);
+	defer (array_free(&boundaries));
+	parse_file_find_chunk_boundaries(f, f->curr_token_index, chunk_size, &boundaries);
+	if (boundaries.count == 0) {
+		parse_file_decls(f, decls, ISIZE_MAX);
+		return;
+	}
+
+	isize chunk_count = boundaries.count;
+	ParserChunk *chunks = gb_alloc_array(heap_allocator(), ParserChunk, chunk_count);
+	defer (gb_free(heap_allocator(), chunks));
+
+	TaskGroup group = {};
+	for (isize i = 0; i < chunk_count; i++) {
+		ParserChunk *chunk = chunks+i;
+		*chunk = {};
+
+		AstFile *cf = permanent_alloc_item<AstFile>();
+		cf->id                = f->id;
+		cf->flags             = f->flags;
+		cf->pkg               = f->pkg;
+		cf->fullpath          = f->fullpath;
+		cf->filename          = f->filename;
+		cf->directory         = f->directory;
+		cf->tokenizer         = f->tokenizer;
+		cf->tokens            = f->tokens;
+		cf->package_token     = f->package_token;
+		cf->package_name      = f->package_name;
+		cf->vet_flags         = f->vet_flags;
+		cf->feature_flags     = f->feature_flags;
+		cf->vet_flags_set     = f->vet_flags_set;
+		cf->feature_flags_set = f->feature_flags_set;
+		array_init(&cf->comments, heap_allocator(), 0, 0);
+		array_init(&cf->imports,  heap_allocator(), 0, 0);
+
+		chunk->file        = cf;
+		chunk->start_index = boundaries[i];
+		chunk->end_index   = i+1 < chunk_count ? boundaries[i+1] : ISIZE_MAX;
+		array_init(&chunk->decls,  heap_allocator(), 0, 0);
+		array_init(&chunk->errors, heap_allocator(), 0, 0);
+		thread_pool_add_task(&group, parser_chunk_worker_proc, chunk);
+	}
+
+	parse_file_decls(f, decls, boundaries[0]);
+	thread_pool_wait(&group);
+
+	// NOTE: A chunk's parser must stop exactly where the next chunk started. Otherwise a declaration spanned
+	// the boundary (which can only happen with syntax errors), so the parser of the previous chunk continues
+	// through the next one instead, and the next one is discarded along with its errors.
+	AstFile *     prev_file  = f;
+	Array<Ast *> *prev_decls = decls;
+	Array<ErrorValue> *file_error_buffer = error_value_buffer;
+	for (isize i = 0; i < chunk_count; i++) {
+		ParserChunk *chunk = chunks+i;
+		if (prev_file->curr_token_index != chunk->first_index) {
+			parse_file_decls(prev_file, prev_decls, chunk->end_index);
+			chunk->discarded = true;
+			for (ErrorValue &ev : chunk->errors) {
+				array_free(&ev.msg);
+			}
+			array_clear(&chunk->errors);
+			continue;
+		}
+		prev_file  = chunk->file;
+		prev_decls = &chunk->decls;
+		error_value_buffer = &chunk->errors;
+	}
+	error_value_buffer = file_error_buffer;
+
+	i32 end_offset = cast(i32)f->tokens.offsets[boundaries[0]];
+	for (isize i = 0; i < chunk_count; i++) {
+		if (!chunks[i].discarded) {
+			end_offset = cast(i32)f->tokens.offsets[chunks[i].start_index];
+			break;
+		}
+	}
+	ast_file_trim_comments(&f->comments, end_offset);
+
+	// NOTE: the errors are collected in the order of the chunks, and a parser which reached the end of the
+	// file unexpectedly exits once they have been, unless the errors of the whole file are being held back
+	bool unexpected_eof = false;
+	for (isize i = 0; i < chunk_count; i++) {
+		ParserChunk *chunk = chunks+i;
+		AstFile *cf = chunk->file;
+		if (!chunk->discarded) {
+			end_offset = I32_MAX;
+			for (isize j = i+1; j < chunk_count; j++) {
+				if (!chunks[j].discarded) {
+					end_offset = cast(i32)f->tokens.offsets[chunks[j].start_index];
+					break;
+				}
+			}
+			ast_file_trim_comments(&cf->comments, end_offset);
+
+			array_add_elems(decls, chunk->decls.data, chunk->decls.count);
+			array_add_elems(&f->comments, cf->comments.data, cf->comments.count);
+			array_add_elems(&f->imports,  cf->imports.data,  cf->imports.count);
+			f->total_file_decl_count     += cf->total_file_decl_count;
+			f->delayed_decl_count        += cf->delayed_decl_count;
+			f->directive_count           += cf->directive_count;
+			f->seen_load_directive_count += cf->seen_load_directive_count.load();
+			f->node_count                += cf->node_count;
+			f->node_memory               += cf->node_memory;
+			if (file_error_buffer != nullptr) {
+				array_add_elems(file_error_buffer, chunk->errors.data, chunk->errors.count);
+			} else {
+				flush_error_value_buffer(&chunk->errors);
+			}
+		}
+		array_free(&chunk->errors);
+		array_free(&chunk->decls);
+		array_free(&cf->comments);
+		array_free(&cf->imports);
+		unexpected_eof |= !chunk->discarded && cf->unexpected_eof;
+	}
+	if (unexpected_eof) {
+		if (error_value_buffer == nullptr) {
+			exit_with_errors();
+		}
+		f->unexpected_eof = true;
+	}
+}
+
 gb_internal bool parse_file(Parser *p, AstFile *f) {
-	if (f->tokens.count == 0) {
+	if (ast_file_token_count(f) == 0) {
 		return true;
 	}
-	if (f->tokens.count > 0 && f->tokens[0].kind == Token_EOF) {
+	if (ast_file_first_token(f).kind == Token_EOF) {
 		return true;
 	}
+	if (f->loaded_from_snapshot) {
+		return parse_file_from_snapshot(p, f);
+	}
 
 	u64 start = time_stamp_time_now();
+	i64 warning_count = global_error_collector.warning_count.load();
 
 	String filepath = f->tokenizer.fullpath;
 	String base_dir = dir_from_path(filepath);
@@ -6882,13 +7430,7 @@ gb_internal bool parse_file(Parser *p, AstFile *f) {
 
 	Token package_name = expect_token_after(f, Token_Ident, "package");
 	if (package_name.kind == Token_Ident) {
-		if (package_name.string == "_") {
-			syntax_error(package_name, "Invalid package name '_'");
-		} else if (f->pkg->kind != Package_Runtime && package_name.string == "runtime") {
-			syntax_error(package_name, "Use of reserved package name '%.*s'", LIT(package_name.string));
-		} else if (is_package_name_reserved(package_name.string)) {
-			syntax_error(package_name, "Use of reserved package name '%.*s'", LIT(package_name.string));
-		}
+		check_file_package_name(f, package_name);
 	}
 	f->package_name = package_name.string;
 
@@ -6908,21 +7450,11 @@ gb_internal bool parse_file(Parser *p, AstFile *f) {
 	if (f->error_count == 0) {
 		auto decls = array_make<Ast *>(ast_allocator(f));
 
-		while (f->curr_token.kind != Token_EOF) {
-			Ast *stmt = parse_stmt(f);
-			if (stmt && stmt->kind != Ast_EmptyStmt) {
-				array_add(&decls, stmt);
-				if (stmt->kind == Ast_ExprStmt &&
-				    stmt->ExprStmt.expr != nullptr &&
-				    stmt->ExprStmt.expr->kind == Ast_ProcLit) {
-					syntax_error(stmt, "Procedure literal evaluated but not used");
-				}
-
-				f->total_file_decl_count += calc_decl_count(stmt);
-				if (stmt->kind == Ast_WhenStmt || stmt->kind == Ast_ExprStmt || stmt->kind == Ast_ImportDecl || stmt->kind == Ast_ForeignBlockDecl) {
-					f->delayed_decl_count += 1;
-				}
-			}
+		isize file_size = f->tokenizer.end - f->tokenizer.start;
+		if (!ast_file_streams_tokens(f) && ast_file_should_parse_in_parallel(file_size)) {
+			parse_file_decls_in_parallel(f, &decls);
+		} else {
+			parse_file_decls(f, &decls, ISIZE_MAX);
 		}
 
 		f->decls = slice_from_array(decls);
@@ -6937,6 +7469,9 @@ gb_internal bool parse_file(Parser *p, AstFile *f) {
 		array_init(f->delayed_decls_queues+i, ast_allocator(f), 0, f->delayed_decl_count);
 	}
 
+	if (build_context.cached_ast && f->error_count == 0 && global_error_collector.warning_count.load() == warning_count) {
+		ast_snapshot_save(f);
+	}
 
 	return f->error_count == 0;
 }
@@ -6950,8 +7485,21 @@ gb_internal ParseFileError process_imported_file(Parser *p, ImportedFile importe
 	AstFile *file = permanent_alloc_item<AstFile>();
 	file->pkg = pkg;
 	file->id = cast(i32)(imported_file.index+1);
+	if (build_context.release_emitted_packages) {
+		file->arena = gb_alloc_item(heap_allocator(), Arena);
+		file->arena->minimum_block_size = AST_FILE_ARENA_MINIMUM_BLOCK_SIZE;
+		file->arena->parent_thread = get_current_thread();
+		file->arena_active = true;
+	}
+	defer (file->arena_active = false);
+
 	TokenPos err_pos = {0};
-	ParseFileError err = init_ast_file(file, fi.fullpath, &err_pos);
+	ParseFileError err = ParseFile_None;
+	if (imported_file.is_loaded) {
+		err = init_ast_file(file, fi.fullpath, &err_pos, &imported_file.loaded_file, imported_file.load_error);
+	} else {
+		err = init_ast_file(file, fi.fullpath, &err_pos);
+	}
 	err_pos.file_id = file->id;
 	file->last_error = err;
 
@@ -7006,7 +7554,15 @@ gb_internal ParseFileError process_imported_file(Parser *p, ImportedFile importe
 	}
 
 
-	if (parse_file(p, file)) {
+	bool parsed = parse_file(p, file);
+	if (ast_file_streams_tokens(file)) {
+		token_stream_free(&file->token_stream);
+		if (file->token_stream.invalid) {
+			return ParseFile_InvalidToken;
+		}
+	}
+
+	if (parsed) {
 		MUTEX_GUARD_BLOCK(&pkg->files_mutex) {
 			array_add(&pkg->files, file);
 		}
@@ -7015,24 +7571,94 @@ gb_internal ParseFileError process_imported_file(Parser *p, ImportedFile importe
 		if (pkg->name.len == 0) {
 			pkg->name = file->package_name;
 		} else if (pkg->name != file->package_name) {
-			if (file->tokens.count > 0 && file->tokens[0].kind != Token_EOF) {
+			if (ast_file_token_count(file) > 0 && ast_file_first_token(file).kind != Token_EOF) {
 				Token tok = file->package_token;
 				tok.pos.file_id = file->id;
-				tok.pos.line = gb_max(tok.pos.line, 1);
-				tok.pos.column = gb_max(tok.pos.column, 1);
 				syntax_error(tok, "Different package name, expected '%.*s', got '%.*s'", LIT(pkg->name), LIT(file->package_name));
 			}
 		}
 		mutex_unlock(&pkg->name_mutex);
 
 		p->total_line_count.fetch_add(file->tokenizer.line_count);
-		p->total_token_count.fetch_add(file->tokens.count);
+		p->total_node_count.fetch_add(file->node_count);
+		p->total_node_memory.fetch_add(file->node_memory);
+		p->total_token_count.fetch_add(ast_file_token_count(file));
 	}
 
 	return ParseFile_None;
 }
 
 
+// NOTE: Parses an edited file again, for the packages kept in memory by `odin server`. The new version keeps
+// the id of the previous one, so the positions within every other file stay valid, and it is only used in
+// place of the previous version by the caller once every edited file has been parsed without any errors.
+// Returns nullptr if the file can no longer be used in place of the previous version (e.g. it is now empty,
+// excluded by a build tag, or within a different package) or if an error was reported.
+gb_internal AstFile *parser_reparse_file(Parser *p, AstFile *prev_file) {
+	AstPackage *pkg = prev_file->pkg;
+
+	AstFile *file = permanent_alloc_item<AstFile>();
+	file->pkg = pkg;
+	file->id = prev_file->id;
+	if (build_context.release_emitted_packages) {
+		file->arena = gb_alloc_item(heap_allocator(), Arena);
+		file->arena->minimum_block_size = AST_FILE_ARENA_MINIMUM_BLOCK_SIZE;
+		file->arena->parent_thread = get_current_thread();
+		file->arena_active = true;
+	}
+	defer (file->arena_active = false);
+
+	// NOTE: the errors are shown with the lines of the new version
+	thread_safe_replace_ast_file_from_id(file->id, file);
+
+	TokenPos err_pos = {0};
+	ParseFileError err = init_ast_file(file, prev_file->fullpath, &err_pos);
+	err_pos.file_id = file->id;
+	file->last_error = err;
+	if (err == ParseFile_InvalidToken) {
+		syntax_error(err_pos, "Failed to parse file: %.*s; invalid token found in file", LIT(file->filename));
+		return nullptr;
+	} else if (err != ParseFile_None) {
+		return nullptr;
+	}
+
+	// NOTE: the errors are held back whilst parsing, so an unexpected end of the file is reported rather than exiting
+	auto errors = array_make<ErrorValue>(heap_allocator());
+	error_value_buffer = &errors;
+	bool parsed = parse_file(p, file);
+	error_value_buffer = nullptr;
+	flush_error_value_buffer(&errors);
+	array_free(&errors);
+
+	if (ast_file_streams_tokens(file)) {
+		token_stream_free(&file->token_stream);
+		if (file->token_stream.invalid) {
+			return nullptr;
+		}
+	}
+	if (!parsed || file->package_name != pkg->name) {
+		return nullptr;
+	}
+	return file;
+}
+
+// NOTE: Uses a file parsed by `parser_reparse_file` in place of its previous version
+gb_internal void parser_replace_file(Parser *p, AstFile *prev_file, AstFile *file) {
+	AstPackage *pkg = prev_file->pkg;
+	for_array(i, pkg->files) {
+		if (pkg->files[i] == prev_file) {
+			pkg->files[i] = file;
+		}
+	}
+	thread_safe_replace_ast_file_from_id(file->id, file);
+
+	p->total_line_count.fetch_add(file->tokenizer.line_count - prev_file->tokenizer.line_count);
+	p->total_node_count.fetch_add(file->node_count - prev_file->node_count);
+	p->total_node_memory.fetch_add(file->node_memory - prev_file->node_memory);
+	p->total_token_count.fetch_add(ast_file_token_count(file) - ast_file_token_count(prev_file));
+	p->total_seen_load_directive_count.fetch_add(file->seen_load_directive_count.load() - prev_file->seen_load_directive_count.load());
+}
+
 gb_internal ParseFileError parse_packages(Parser *p, String init_filename) {
 	GB_ASSERT(init_filename.text[init_filename.len] == 0);
 
@@ -7060,6 +7686,8 @@ gb_internal ParseFileError parse_packages(Parser *p, String init_filename) {
 	}
 
 
+	parser_io_init();
+
 	{ // Add these packages serially and then process them parallel
 		TokenPos init_pos = {};
 		{
@@ -7090,6 +7718,7 @@ gb_internal ParseFileError parse_packages(Parser *p, String init_filename) {
 				String const ext = str_lit(".odin");
 				if (!string_ends_with(fullpath, ext)) {
 					error({}, "Expected either a directory or a .odin file, got '%.*s'\n", LIT(fullpath));
+					parser_io_destroy();
 					return ParseFile_WrongExtension;
 				}
 			}
@@ -7100,7 +7729,11 @@ gb_internal ParseFileError parse_packages(Parser *p, String init_filename) {
 		}
 	}
 	
-	thread_pool_wait();
+	// NOTE: the files read by the I/O stage are only added to the pool once read
+	do {
+		thread_pool_wait();
+	} while (parser_io_wait());
+	parser_io_destroy();
 
 	for (ParseFileErrorNode *node = p->file_error_head; node != nullptr; node = node->next) {
 		if (node->err != ParseFile_None) {
@@ -87,6 +87,11 @@ struct ImportedFile {
 	FileInfo    fi;
 	TokenPos    pos; // import
 	isize       index;
+
+	// NOTE: set once the contents have been read ahead by the I/O stage (see parser_io.cpp)
+	bool            is_loaded;
+	LoadedFileError load_error;
+	LoadedFile      loaded_file;
 };
 
 enum AstFileFlag : u32 {
@@ -118,7 +123,8 @@ struct AstFile {
 	String       directory;
 
 	Tokenizer    tokenizer;
-	Array<Token> tokens;
+	TokenList    tokens;       // empty when the tokens are streamed, see `ast_file_streams_tokens`
+	TokenStream  token_stream;
 	isize        curr_token_index;
 	isize        prev_token_index;
 	Token        curr_token;
@@ -141,6 +147,7 @@ struct AstFile {
 	bool         in_foreign_block;
 	bool         allow_type;
 	bool         in_when_statement;
+	bool         unexpected_eof; // NOTE: set rather than exiting when parsing a chunk of the file in parallel
 
 	isize total_file_decl_count;
 	isize delayed_decl_count;
@@ -149,7 +156,7 @@ struct AstFile {
 	isize        directive_count;
 
 	Ast *          curr_proc;
-	isize          error_count;
+	std::atomic<isize> error_count; // NOTE: the chunks of a file may be parsed concurrently
 	ParseFileError last_error;
 	f64            time_to_tokenize; // seconds
 	f64            time_to_parse;    // seconds
@@ -164,6 +171,19 @@ struct AstFile {
 
 	std::atomic<isize> seen_load_directive_count;
 
+	u64  snapshot_content_hash; // -internal-cached-ast
+	bool loaded_from_snapshot;
+
+	// NOTE: the nodes allocated whilst parsing (or loaded from the snapshot), for -show-more-timings
+	isize node_count;
+	isize node_memory;
+
+	// NOTE: with -release-emitted-packages, the AST and tokens are allocated within the arena of the file
+	// so that they can be released once the code of its package has been emitted; the arena is only used
+	// whilst parsing, as the checker may allocate nodes for the file on any thread
+	Arena *arena;
+	bool   arena_active;
+
 #define PARSER_MAX_FIX_COUNT 6
 	isize    fix_count;
 	TokenPos fix_prev_pos;
@@ -191,6 +211,11 @@ struct AstPackageExportedEntity {
 	Entity *entity;
 };
 
+struct AstPackageSummaryDep {
+	String fullpath;
+	u64    interface_hash;
+};
+
 struct AstPackage {
 	PackageKind           kind;
 	isize                 id;
@@ -213,6 +238,15 @@ struct AstPackage {
 	Scope *   scope;
 	DeclInfo *decl_info;
 	bool      is_extra;
+
+	// NOTE: Used by -internal-cached-packages (see cached.cpp)
+	u64                         summary_source_hash; // 0 if the package cannot be cached
+	u64                         summary_interface_hash;
+	String                      summary_interface;
+	Array<AstPackageSummaryDep> summary_cached_deps; // from the previous check, empty if stale
+	Array<String>               summary_cached_uses; // the `uses` lines, see check_package_summary_uses
+	bool                        summary_loaded;
+	bool                        summary_valid;
 };
 
 
@@ -233,6 +267,8 @@ struct Parser {
 	std::atomic<isize>     file_to_process_count;
 	std::atomic<isize>     total_token_count;
 	std::atomic<isize>     total_line_count;
+	std::atomic<isize>     total_node_count;
+	std::atomic<isize>     total_node_memory;
 
 	std::atomic<isize>     total_seen_load_directive_count;
 
@@ -341,6 +377,7 @@ enum StateFlag : u8 {
 	StateFlag_type_assert     = 1<<2,
 	StateFlag_no_type_assert  = 1<<3,
 
+	StateFlag_DeferredBody = 1<<4, // NOTE: a procedure body which has not been parsed yet, see `parse_deferred_proc_body`
 	StateFlag_SelectorCallExpr = 1<<5,
 	StateFlag_DirectiveWasFalse = 1<<6,
 
@@ -872,15 +909,29 @@ struct AstCommonStuff {
 	u8              state_flags;
 	std::atomic<u8> viral_state_flags;
 	i32             file_id;
-	TypeAndValue    tav; // NOTE(bill): Making this a pointer is slower
 };
 
+// NOTE: Only the expressions and types are given a type and value by the checker, so only those nodes
+// store a TypeAndValue, which is allocated directly before the node (see alloc_ast_node)
+gb_internal gb_inline bool ast_kind_has_tav(AstKind kind) {
+	return kind < Ast__ExprEnd || gb_is_between(kind, Ast__TypeBegin+1, Ast__TypeEnd-1);
+}
+
+// NOTE: the nodes keep the alignment of their allocation, whether or not they are prefixed by a TypeAndValue
+enum : isize { AST_NODE_ALIGNMENT = 16 };
+
+gb_internal gb_inline isize ast_node_prefix_size(AstKind kind) {
+	return ast_kind_has_tav(kind) ? align_formula_isize(gb_size_of(TypeAndValue), AST_NODE_ALIGNMENT) : 0;
+}
+
+// NOTE: what `Ast::tav` reads for the statements, declarations and fields, which the checker never gives a type
+gb_global TypeAndValue const empty_ast_type_and_value = {};
+
 struct Ast {
 	AstKind         kind; // u16
 	u8              state_flags;
 	std::atomic<u8> viral_state_flags;
 	i32             file_id;
-	TypeAndValue    tav; // NOTE(bill): Making this a pointer is slower
 
 	// IMPORTANT NOTE(bill): This must be at the end since the AST is allocated to be size of the variant
 	union {
@@ -899,8 +950,21 @@ struct Ast {
 	gb_inline AstFile *thread_safe_file() const {
 		return thread_safe_get_ast_file_from_id(this->file_id);
 	}
+	gb_inline TypeAndValue const &tav() const {
+		if (!ast_kind_has_tav(this->kind)) {
+			return empty_ast_type_and_value;
+		}
+		return (cast(TypeAndValue const *)this)[-1];
+	}
+	gb_inline TypeAndValue &tav_mut() const {
+		GB_ASSERT_MSG(ast_kind_has_tav(this->kind), "%.*s has no type and value", LIT(ast_strings[this->kind]));
+		return (cast(TypeAndValue *)this)[-1];
+	}
 };
 
+static_assert(alignof(Ast) <= AST_NODE_ALIGNMENT, "AST_NODE_ALIGNMENT must cover the alignment of Ast");
+static_assert(alignof(TypeAndValue) <= AST_NODE_ALIGNMENT, "AST_NODE_ALIGNMENT must cover the alignment of TypeAndValue");
+
 
 #define ast_node(n_, Kind_, node_) GB_JOIN2(Ast, Kind_) *n_ = &(node_)->Kind_; gb_unused(n_); GB_ASSERT_MSG((node_)->kind == GB_JOIN2(Ast_, Kind_), \
 	"expected '%.*s' got '%.*s'", \
@@ -930,7 +994,29 @@ gb_internal gb_inline bool is_ast_when_stmt(Ast *node) {
 	return node->kind == Ast_WhenStmt;
 }
 
+// NOTE: most files are small, so the arena of a file starts smaller than that of a thread
+enum { AST_FILE_ARENA_MINIMUM_BLOCK_SIZE = 1ll*1024ll*1024ll };
+
+// NOTE: a file of at least this size is split into chunks which are parsed concurrently, see `parse_file_decls_in_parallel`
+enum {
+	PARSER_PARALLEL_FILE_MIN_SIZE = 256*1024,
+	PARSER_CHUNK_MIN_SIZE         = 64*1024,
+};
+
+gb_internal gb_inline Arena *ast_arena(AstFile *f) {
+	if (f != nullptr && f->arena_active) {
+		return f->arena;
+	}
+	return get_arena(ThreadArena_Permanent);
+}
+
+gb_internal GB_ALLOCATOR_PROC(ast_file_allocator_proc);
+
 gb_internal gb_inline gbAllocator ast_allocator(AstFile *f) {
+	if (f != nullptr && f->arena != nullptr) {
+		// NOTE: the allocator is kept by the arrays of the AST, which may still grow after the file has been parsed
+		return {ast_file_allocator_proc, f};
+	}
 	return permanent_allocator();
 }
 
@@ -0,0 +1,457 @@
+/*
+	The I/O stage of the parser
+
+	The directories of the imported packages are listed, and the contents of their files are read, by a
+	few dedicated I/O threads rather than within the tasks of the thread pool, so that the threads which
+	tokenize and parse are not blocked upon the file system; on a network file system, or with a cold
+	cache, the parsing time is otherwise mostly spent waiting upon it. The task which parses a file is
+	only added to the pool once its contents have been read.
+
+	On Linux, each I/O thread reads a batch of files through its own io_uring, opening every file of the
+	batch with a single system call and then reading them all with another. Elsewhere, or where io_uring
+	is unavailable (e.g. disabled by a seccomp filter), or when the files are memory mapped (-map-files),
+	each I/O thread reads one file at a time. The directories are always listed with blocking calls, as
+	io_uring has no equivalent of `getdents`.
+*/
+
+#if defined(GB_SYSTEM_LINUX) && defined(__has_include)
+	#if __has_include(<linux/io_uring.h>)
+		#include <linux/io_uring.h>
+		#include <sys/syscall.h>
+
+		// NOTE: IORING_OP_OPENAT and IORING_OP_READ were added along with this feature (Linux 5.6)
+		#if defined(IORING_FEAT_CUR_PERSONALITY) && defined(__NR_io_uring_setup)
+			#define PARSER_IO_URING 1
+		#endif
+	#endif
+#endif
+
+gb_internal WORKER_TASK_PROC(parser_worker_proc);
+gb_internal bool parser_add_package_files(Parser *p, AstPackage *pkg, String const &rel_path, TokenPos pos);
+
+enum : isize {
+	PARSER_IO_MAX_THREAD_COUNT = 8,  // as the I/O threads mostly wait, more than this gains little
+	PARSER_IO_BATCH_SIZE       = 32, // files read at once by a single I/O thread
+};
+
+enum ParserIORequestKind : u8 {
+	ParserIORequest_Package, // list the directory of an imported package, and then read its files
+	ParserIORequest_File,    // read the contents of a file, and then parse it
+};
+
+struct ParserIORequest {
+	ParserIORequestKind kind;
+	Parser *            parser;
+	AstPackage *        pkg;      // ParserIORequest_Package
+	String              rel_path; // ParserIORequest_Package
+	TokenPos            pos;      // ParserIORequest_Package
+	ParserWorkerData *  wd;       // ParserIORequest_File
+};
+
+struct ParserIO {
+	bool                   running;
+	Thread                 threads[PARSER_IO_MAX_THREAD_COUNT];
+	isize                  thread_count;
+
+	BlockingMutex          mutex;
+	Condition              requests_available;
+	Condition              idle;
+	Array<ParserIORequest> packages;
+	Array<ParserIORequest> files;
+	isize                  pending;        // requests which have not yet finished
+	isize                  submitted;      // requests ever made
+	isize                  last_submitted; // as of the last `parser_io_wait`
+};
+
+gb_global ParserIO parser_io;
+
+gb_internal bool parser_io_is_running(void) {
+	return parser_io.running;
+}
+
+gb_internal void parser_io_add_request(ParserIORequest const &req) {
+	MUTEX_GUARD_BLOCK(&parser_io.mutex) {
+		if (req.kind == ParserIORequest_Package) {
+			array_add(&parser_io.packages, req);
+		} else {
+			array_add(&parser_io.files, req);
+		}
+		parser_io.pending   += 1;
+		parser_io.submitted += 1;
+	}
+	condition_signal(&parser_io.requests_available);
+}
+
+gb_internal void parser_io_add_package(Parser *p, AstPackage *pkg, String const &rel_path, TokenPos pos) {
+	ParserIORequest req = {ParserIORequest_Package};
+	req.parser   = p;
+	req.pkg      = pkg;
+	req.rel_path = copy_string(permanent_allocator(), rel_path);
+	req.pos      = pos;
+	parser_io_add_request(req);
+}
+
+gb_internal void parser_io_add_file(ParserWorkerData *wd) {
+	ParserIORequest req = {ParserIORequest_File};
+	req.parser = wd->parser;
+	req.wd     = wd;
+	parser_io_add_request(req);
+}
+
+// NOTE: Waits for every request to have finished, and returns whether any were made since the previous
+// call, as the tasks of their files may have been added to the pool after it was last waited upon
+gb_internal bool parser_io_wait(void) {
+	if (!parser_io.running) {
+		return false;
+	}
+	bool any_submitted = false;
+	MUTEX_GUARD_BLOCK(&parser_io.mutex) {
+		while (parser_io.pending != 0) {
+			condition_wait(&parser_io.idle, &parser_io.mutex);
+		}
+		any_submitted = parser_io.submitted != parser_io.last_submitted;
+		parser_io.last_submitted = parser_io.submitted;
+	}
+	return any_submitted;
+}
+
+gb_internal void parser_io_load_file(ImportedFile *imp) {
+	TEMPORARY_ALLOCATOR_GUARD();
+	String fullpath = string_trim_whitespace(imp->fi.fullpath); // Just in case
+	char const *c_path = alloc_cstring(temporary_allocator(), fullpath);
+	imp->load_error = load_file(c_path, &imp->loaded_file, build_context.file_load_mode, I32_MAX);
+	imp->is_loaded  = true;
+}
+
+#if defined(PARSER_IO_URING)
+struct ParserIORing {
+	int    fd;
+	u32    entries;
+
+	u32 *  sq_tail;
+	u32 *  sq_mask;
+	u32 *  sq_array;
+	u32 *  cq_head;
+	u32 *  cq_tail;
+	u32 *  cq_mask;
+	struct io_uring_sqe *sqes;
+	struct io_uring_cqe *cqes;
+
+	void * sq_ring;
+	isize  sq_ring_size;
+	void * cq_ring;
+	isize  cq_ring_size;
+	isize  sqes_size;
+};
+
+gb_internal void parser_io_ring_destroy(ParserIORing *r) {
+	if (r->sqes != nullptr) {
+		munmap(r->sqes, r->sqes_size);
+	}
+	if (r->cq_ring != nullptr && r->cq_ring != r->sq_ring) {
+		munmap(r->cq_ring, r->cq_ring_size);
+	}
+	if (r->sq_ring != nullptr) {
+		munmap(r->sq_ring, r->sq_ring_size);
+	}
+	if (r->fd >= 0) {
+		close(r->fd);
+	}
+	gb_zero_item(r);
+	r->fd = -1;
+}
+
+gb_internal bool parser_io_ring_init(ParserIORing *r, u32 entries) {
+	gb_zero_item(r);
+	r->fd = -1;
+
+	struct io_uring_params params = {};
+	int fd = cast(int)syscall(__NR_io_uring_setup, entries, &params);
+	if (fd < 0) {
+		return false;
+	}
+	r->fd      = fd;
+	r->entries = params.sq_entries;
+
+	r->sq_ring_size = params.sq_off.array + params.sq_entries*gb_size_of(u32);
+	r->cq_ring_size = params.cq_off.cqes  + params.cq_entries*gb_size_of(struct io_uring_cqe);
+	bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (single_mmap) {
+		r->sq_ring_size = r->cq_ring_size = gb_max(r->sq_ring_size, r->cq_ring_size);
+	}
+
+	void *sq_ring = mmap(nullptr, r->sq_ring_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	if (sq_ring == MAP_FAILED) {
+		parser_io_ring_destroy(r);
+		return false;
+	}
+	r->sq_ring = sq_ring;
+
+	void *cq_ring = sq_ring;
+	if (!single_mmap) {
+		cq_ring = mmap(nullptr, r->cq_ring_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+		if (cq_ring == MAP_FAILED) {
+			parser_io_ring_destroy(r);
+			return false;
+		}
+	}
+	r->cq_ring = cq_ring;
+
+	r->sqes_size = params.sq_entries*gb_size_of(struct io_uring_sqe);
+	void *sqes = mmap(nullptr, r->sqes_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd, IORING_OFF_SQES);
+	if (sqes == MAP_FAILED) {
+		parser_io_ring_destroy(r);
+		return false;
+	}
+	r->sqes = cast(struct io_uring_sqe *)sqes;
+
+	u8 *sq = cast(u8 *)sq_ring;
+	u8 *cq = cast(u8 *)cq_ring;
+	r->sq_tail  = cast(u32 *)(sq + params.sq_off.tail);
+	r->sq_mask  = cast(u32 *)(sq + params.sq_off.ring_mask);
+	r->sq_array = cast(u32 *)(sq + params.sq_off.array);
+	r->cq_head  = cast(u32 *)(cq + params.cq_off.head);
+	r->cq_tail  = cast(u32 *)(cq + params.cq_off.tail);
+	r->cq_mask  = cast(u32 *)(cq + params.cq_off.ring_mask);
+	r->cqes     = cast(struct io_uring_cqe *)(cq + params.cq_off.cqes);
+	return true;
+}
+
+// NOTE: The `index`-th entry of the next submission, whose completion is stored in `results[index]`
+gb_internal struct io_uring_sqe *parser_io_ring_sqe(ParserIORing *r, u32 index) {
+	u32 slot = (*r->sq_tail + index) & *r->sq_mask;
+	struct io_uring_sqe *sqe = &r->sqes[slot];
+	gb_zero_item(sqe);
+	sqe->user_data = index;
+	r->sq_array[slot] = slot;
+	return sqe;
+}
+
+// NOTE: Submits the first `count` entries and waits for all of them to complete; the ring must not be
+// used again if this fails
+gb_internal bool parser_io_ring_submit_and_wait(ParserIORing *r, u32 count, i32 *results) {
+	if (count == 0) {
+		return true;
+	}
+	GB_ASSERT(count <= r->entries);
+	__atomic_store_n(r->sq_tail, *r->sq_tail + count, __ATOMIC_RELEASE);
+
+	u32 submitted = 0;
+	u32 completed = 0;
+	while (completed < count) {
+		long res = syscall(__NR_io_uring_enter, r->fd, count-submitted, count-completed, IORING_ENTER_GETEVENTS, nullptr, 0);
+		if (res < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		submitted += cast(u32)res;
+
+		u32 head = *r->cq_head;
+		u32 tail = __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE);
+		for (; head != tail; head++) {
+			struct io_uring_cqe *cqe = &r->cqes[head & *r->cq_mask];
+			results[cqe->user_data] = cqe->res;
+			completed += 1;
+		}
+		__atomic_store_n(r->cq_head, head, __ATOMIC_RELEASE);
+	}
+	return true;
+}
+
+gb_internal LoadedFileError parser_io_open_error(i32 err) {
+	switch (err) {
+	case ENOENT:
+	case ENOTDIR:
+		return LoadedFile_NotExists;
+	case EACCES:
+	case EPERM:
+		return LoadedFile_Permission;
+	}
+	return LoadedFile_Invalid;
+}
+
+// NOTE: Returns false if the ring has failed, with the files not yet loaded being left for the caller
+gb_internal bool parser_io_ring_load_files(ParserIORing *r, ImportedFile **files, u32 count) {
+	GB_ASSERT(count <= PARSER_IO_BATCH_SIZE && count <= r->entries);
+	TEMPORARY_ALLOCATOR_GUARD(); // NOTE: the paths must outlive every submission of the batch
+	i32 results[PARSER_IO_BATCH_SIZE] = {};
+	int fds    [PARSER_IO_BATCH_SIZE] = {};
+	u8 *buffers[PARSER_IO_BATCH_SIZE] = {};
+
+	for (u32 i = 0; i < count; i++) {
+		String fullpath = string_trim_whitespace(files[i]->fi.fullpath); // Just in case
+		struct io_uring_sqe *sqe = parser_io_ring_sqe(r, i);
+		sqe->opcode     = IORING_OP_OPENAT;
+		sqe->fd         = AT_FDCWD;
+		sqe->addr       = cast(u64)cast(uintptr)alloc_cstring(temporary_allocator(), fullpath);
+		sqe->open_flags = O_RDONLY|O_CLOEXEC;
+	}
+	if (!parser_io_ring_submit_and_wait(r, count, results)) {
+		return false;
+	}
+
+	// NOTE: the sizes were already found when the directory was listed, and one more byte is read so
+	// that a file which has grown since is noticed. Anything but a read of exactly that size, i.e. a file
+	// which has changed size or a short read, is left to be loaded again by parser_io_load_file
+	u32 read_count = 0;
+	u32 read_files[PARSER_IO_BATCH_SIZE] = {};
+	for (u32 i = 0; i < count; i++) {
+		ImportedFile *imp = files[i];
+		fds[i] = results[i];
+		if (results[i] == -EINVAL) {
+			continue; // NOTE: an older kernel without IORING_OP_OPENAT, so read it with a blocking call
+		} else if (results[i] < 0) {
+			imp->load_error = parser_io_open_error(-results[i]);
+			imp->is_loaded  = true;
+			continue;
+		}
+
+		i64 size = imp->fi.size;
+		if (size > I32_MAX) {
+			imp->load_error = LoadedFile_FileTooLarge;
+			imp->is_loaded  = true;
+			continue;
+		}
+		buffers[i] = cast(u8 *)gb_alloc(permanent_allocator(), size+1);
+
+		struct io_uring_sqe *sqe = parser_io_ring_sqe(r, read_count);
+		sqe->opcode = IORING_OP_READ;
+		sqe->fd     = fds[i];
+		sqe->addr   = cast(u64)cast(uintptr)buffers[i];
+		sqe->len    = cast(u32)(size+1);
+		sqe->off    = 0;
+		read_files[read_count++] = i;
+	}
+	bool ok = parser_io_ring_submit_and_wait(r, read_count, results);
+
+	for (u32 j = 0; j < read_count; j++) {
+		u32 i = read_files[j];
+		ImportedFile *imp = files[i];
+		if (ok && results[j] == imp->fi.size) {
+			isize size = results[j];
+			buffers[i][size] = 0;
+			imp->loaded_file.handle = nullptr;
+			imp->loaded_file.data   = size != 0 ? buffers[i] : nullptr;
+			imp->loaded_file.size   = size;
+			imp->load_error = size != 0 ? LoadedFile_None : LoadedFile_Empty;
+			imp->is_loaded  = true;
+		}
+	}
+	for (u32 i = 0; i < count; i++) {
+		if (fds[i] >= 0) {
+			close(fds[i]);
+		}
+	}
+	return ok;
+}
+#endif
+
+gb_internal void parser_io_finish_requests(isize count) {
+	bool is_idle = false;
+	MUTEX_GUARD_BLOCK(&parser_io.mutex) {
+		parser_io.pending -= count;
+		is_idle = parser_io.pending == 0;
+	}
+	if (is_idle) {
+		condition_broadcast(&parser_io.idle);
+	}
+}
+
+gb_internal THREAD_PROC(parser_io_thread_proc) {
+	current_thread = thread;
+
+	bool has_ring = false;
+#if defined(PARSER_IO_URING)
+	ParserIORing ring = {};
+	if (build_context.file_load_mode == FileLoad_Copy) {
+		has_ring = parser_io_ring_init(&ring, PARSER_IO_BATCH_SIZE);
+	}
+#endif
+
+	ParserIORequest batch[PARSER_IO_BATCH_SIZE] = {};
+	for (;;) {
+		isize count = 0;
+		MUTEX_GUARD_BLOCK(&parser_io.mutex) {
+			while (parser_io.running && parser_io.packages.count == 0 && parser_io.files.count == 0) {
+				condition_wait(&parser_io.requests_available, &parser_io.mutex);
+			}
+			// NOTE: the packages are listed first, as each may lead to many files to read
+			if (parser_io.packages.count != 0) {
+				batch[count++] = array_pop(&parser_io.packages);
+			} else {
+				isize max_count = has_ring ? PARSER_IO_BATCH_SIZE : 1;
+				while (count < max_count && parser_io.files.count != 0) {
+					batch[count++] = array_pop(&parser_io.files);
+				}
+			}
+		}
+		if (count == 0) {
+			break; // NOTE: no longer running
+		}
+
+		if (batch[0].kind == ParserIORequest_Package) {
+			GB_ASSERT(count == 1);
+			ParserIORequest *req = &batch[0];
+			parser_add_package_files(req->parser, req->pkg, req->rel_path, req->pos);
+			parser_io_finish_requests(count);
+			continue;
+		}
+
+		ImportedFile *files[PARSER_IO_BATCH_SIZE] = {};
+		for (isize i = 0; i < count; i++) {
+			files[i] = &batch[i].wd->imported_file;
+		}
+	#if defined(PARSER_IO_URING)
+		if (has_ring && !parser_io_ring_load_files(&ring, files, cast(u32)count)) {
+			parser_io_ring_destroy(&ring);
+			has_ring = false;
+		}
+	#endif
+		for (isize i = 0; i < count; i++) {
+			if (!files[i]->is_loaded) {
+				parser_io_load_file(files[i]);
+			}
+			thread_pool_add_task(parser_worker_proc, batch[i].wd);
+		}
+		parser_io_finish_requests(count);
+	}
+
+#if defined(PARSER_IO_URING)
+	if (has_ring) {
+		parser_io_ring_destroy(&ring);
+	}
+#endif
+	return 0;
+}
+
+gb_internal void parser_io_init(void) {
+	if (build_context.internal_no_file_prefetch) {
+		return;
+	}
+	array_init(&parser_io.packages, heap_allocator());
+	array_init(&parser_io.files,    heap_allocator());
+	parser_io.running = true;
+	// NOTE: no more I/O threads than the threads which parse the files, as set by -thread-count
+	parser_io.thread_count = gb_clamp(build_context.thread_count, 1, PARSER_IO_MAX_THREAD_COUNT);
+	for (isize i = 0; i < parser_io.thread_count; i++) {
+		// NOTE: outside of the thread pool, so that its tasks are added to the pool as external tasks
+		thread_init_and_start(nullptr, &parser_io.threads[i], -1, parser_io_thread_proc);
+	}
+}
+
+gb_internal void parser_io_destroy(void) {
+	if (!parser_io.running) {
+		return;
+	}
+	MUTEX_GUARD_BLOCK(&parser_io.mutex) {
+		parser_io.running = false;
+	}
+	condition_broadcast(&parser_io.requests_available);
+	for (isize i = 0; i < parser_io.thread_count; i++) {
+		thread_join_and_destroy(&parser_io.threads[i]);
+	}
+	array_free(&parser_io.packages);
+	array_free(&parser_io.files);
+}
@@ -123,16 +123,6 @@ gb_internal Token ast_token(Ast *node) {
 TokenPos token_pos_end(Token const &token) {
 	TokenPos pos = token.pos;
 	pos.offset += cast(i32)token.string.len;
-	for (isize i = 0; i < token.string.len; i++) {
-		// TODO(bill): This assumes ASCII
-		char c = token.string[i];
-		if (c == '\n') {
-			pos.line += 1;
-			pos.column = 1;
-		} else {
-			pos.column += 1;
-		}
-	}
 	return pos;
 }
 
@@ -0,0 +1,1091 @@
+/*
+	Binary snapshots of parsed files (-internal-cached-ast)
+
+	Once a file has parsed without any errors or warnings, its tokens, AST nodes, and comment groups
+	are written to `.odin-cache/ast/<hash>.ast` (next to the other caches), keyed by a hash of the file's contents.
+	When the same contents are seen again, the snapshot is mapped back into memory and relocated in place,
+	skipping both tokenizing and parsing.
+
+	Snapshots are relocatable: pointers to nodes and comment groups are stored as indices, slices of nodes
+	as offsets into a table of references, and strings as offsets into either the file's source or the
+	snapshot's own string table. Anything which is only set by the checker is cleared when written.
+	The layout of the nodes is that of this very build of the compiler, so the build is part of the key.
+*/
+
+gb_internal bool check_if_exists_directory_otherwise_create(String const &str);
+gb_internal String build_cache_base_dir(void);
+
+gb_global String ast_snapshot_dir;
+gb_global u64    ast_snapshot_build_hash;
+
+gb_global u64 const AST_SNAPSHOT_MAGIC = 0x35302d7473616e6full; // "onast-05"
+
+enum : u64 {
+	AstSnapshotString_Source = 1ull<<62,
+	AstSnapshotString_Table  = 2ull<<62,
+	AstSnapshotString_Mask   = 3ull<<62,
+};
+
+struct AstSnapshotHeader {
+	u64 magic;
+	u64 build_hash;
+	u64 content_hash;
+	i64 content_size;
+	u64 body_hash; // of everything after the header
+	i64 size;
+
+	i64 node_count;
+	i64 node_table_offset; // u64 offsets to each node
+	i64 ref_offset;
+	i64 ref_count;
+	i64 token_offset;      // AstFile::tokens, as its offsets, lengths, kinds, and flags
+	i64 token_count;
+	i64 comment_token_offset;
+	i64 comment_token_count;
+	i64 comment_offset;
+	i64 comment_count;
+	i64 string_offset;
+	i64 string_size;
+
+	u64   pkg_decl;
+	u64   decls_ref;
+	i64   decls_count;
+	u64   imports_ref;
+	i64   imports_count;
+	u64   comments_ref;
+	i64   comments_count;
+	Token package_token;
+	i32   seen_load_directive_count;
+	i64   total_file_decl_count;
+	i64   delayed_decl_count;
+};
+
+GB_STATIC_ASSERT(gb_size_of(Ast *) == gb_size_of(u64));
+
+// NOTE: Calls the visitor on every field of a node which refers to anything outside of the node itself
+template <typename V>
+gb_internal void ast_snapshot_visit(Ast *n, V *v) {
+	switch (n->kind) {
+	default: GB_PANIC("Unhandled Ast %.*s", LIT(ast_strings[n->kind])); break;
+
+	case Ast_Ident:
+		v->token(&n->Ident.token);
+		break;
+	case Ast_Implicit: v->token(&n->Implicit); break;
+	case Ast_Uninit:   v->token(&n->Uninit);   break;
+	case Ast_BasicLit: v->token(&n->BasicLit.token); break;
+	case Ast_BasicDirective:
+		v->token(&n->BasicDirective.token);
+		v->token(&n->BasicDirective.name);
+		break;
+	case Ast_Ellipsis:
+		v->token(&n->Ellipsis.token);
+		v->node(&n->Ellipsis.expr);
+		break;
+	case Ast_ProcGroup:
+		v->token(&n->ProcGroup.token);
+		v->token(&n->ProcGroup.open);
+		v->token(&n->ProcGroup.close);
+		v->slice(&n->ProcGroup.args);
+		break;
+	case Ast_ProcLit:
+		v->node(&n->ProcLit.type);
+		v->node(&n->ProcLit.body);
+		v->token(&n->ProcLit.where_token);
+		v->slice(&n->ProcLit.where_clauses);
+		break;
+	case Ast_CompoundLit:
+		v->node(&n->CompoundLit.type);
+		v->slice(&n->CompoundLit.elems);
+		v->token(&n->CompoundLit.open);
+		v->token(&n->CompoundLit.close);
+		v->node(&n->CompoundLit.tag);
+		break;
+
+	case Ast_BadExpr:
+		v->token(&n->BadExpr.begin);
+		v->token(&n->BadExpr.end);
+		break;
+	case Ast_TagExpr:
+		v->token(&n->TagExpr.token);
+		v->token(&n->TagExpr.name);
+		v->node(&n->TagExpr.expr);
+		break;
+	case Ast_UnaryExpr:
+		v->token(&n->UnaryExpr.op);
+		v->node(&n->UnaryExpr.expr);
+		break;
+	case Ast_BinaryExpr:
+		v->token(&n->BinaryExpr.op);
+		v->node(&n->BinaryExpr.left);
+		v->node(&n->BinaryExpr.right);
+		break;
+	case Ast_ParenExpr:
+		v->node(&n->ParenExpr.expr);
+		v->token(&n->ParenExpr.open);
+		v->token(&n->ParenExpr.close);
+		break;
+	case Ast_SelectorExpr:
+		v->token(&n->SelectorExpr.token);
+		v->node(&n->SelectorExpr.expr);
+		v->node(&n->SelectorExpr.selector);
+		break;
+	case Ast_ImplicitSelectorExpr:
+		v->token(&n->ImplicitSelectorExpr.token);
+		v->node(&n->ImplicitSelectorExpr.selector);
+		break;
+	case Ast_SelectorCallExpr:
+		v->token(&n->SelectorCallExpr.token);
+		v->node(&n->SelectorCallExpr.expr);
+		v->node(&n->SelectorCallExpr.call);
+		break;
+	case Ast_IndexExpr:
+		v->node(&n->IndexExpr.expr);
+		v->node(&n->IndexExpr.index);
+		v->token(&n->IndexExpr.open);
+		v->token(&n->IndexExpr.close);
+		break;
+	case Ast_DerefExpr:
+		v->node(&n->DerefExpr.expr);
+		v->token(&n->DerefExpr.op);
+		break;
+	case Ast_SliceExpr:
+		v->node(&n->SliceExpr.expr);
+		v->token(&n->SliceExpr.open);
+		v->token(&n->SliceExpr.close);
+		v->token(&n->SliceExpr.interval);
+		v->node(&n->SliceExpr.low);
+		v->node(&n->SliceExpr.high);
+		break;
+	case Ast_CallExpr:
+		v->node(&n->CallExpr.proc);
+		v->slice(&n->CallExpr.args);
+		v->token(&n->CallExpr.open);
+		v->token(&n->CallExpr.close);
+		v->token(&n->CallExpr.ellipsis);
+		break;
+	case Ast_FieldValue:
+		v->token(&n->FieldValue.eq);
+		v->node(&n->FieldValue.field);
+		v->node(&n->FieldValue.value);
+		break;
+	case Ast_EnumFieldValue:
+		v->node(&n->EnumFieldValue.name);
+		v->node(&n->EnumFieldValue.value);
+		v->comment(&n->EnumFieldValue.docs);
+		v->comment(&n->EnumFieldValue.comment);
+		break;
+	case Ast_TernaryIfExpr:
+		v->node(&n->TernaryIfExpr.x);
+		v->node(&n->TernaryIfExpr.cond);
+		v->node(&n->TernaryIfExpr.y);
+		break;
+	case Ast_TernaryWhenExpr:
+		v->node(&n->TernaryWhenExpr.x);
+		v->node(&n->TernaryWhenExpr.cond);
+		v->node(&n->TernaryWhenExpr.y);
+		break;
+	case Ast_OrElseExpr:
+		v->node(&n->OrElseExpr.x);
+		v->token(&n->OrElseExpr.token);
+		v->node(&n->OrElseExpr.y);
+		break;
+	case Ast_OrReturnExpr:
+		v->node(&n->OrReturnExpr.expr);
+		v->token(&n->OrReturnExpr.token);
+		break;
+	case Ast_OrBranchExpr:
+		v->node(&n->OrBranchExpr.expr);
+		v->token(&n->OrBranchExpr.token);
+		v->node(&n->OrBranchExpr.label);
+		break;
+	case Ast_TypeAssertion:
+		v->node(&n->TypeAssertion.expr);
+		v->token(&n->TypeAssertion.dot);
+		v->node(&n->TypeAssertion.type);
+		break;
+	case Ast_TypeCast:
+		v->token(&n->TypeCast.token);
+		v->node(&n->TypeCast.type);
+		v->node(&n->TypeCast.expr);
+		break;
+	case Ast_AutoCast:
+		v->token(&n->AutoCast.token);
+		v->node(&n->AutoCast.expr);
+		break;
+	case Ast_InlineAsmExpr:
+		v->token(&n->InlineAsmExpr.token);
+		v->token(&n->InlineAsmExpr.open);
+		v->token(&n->InlineAsmExpr.close);
+		v->slice(&n->InlineAsmExpr.param_types);
+		v->node(&n->InlineAsmExpr.return_type);
+		v->node(&n->InlineAsmExpr.asm_string);
+		v->node(&n->InlineAsmExpr.constraints_string);
+		break;
+	case Ast_MatrixIndexExpr:
+		v->node(&n->MatrixIndexExpr.expr);
+		v->node(&n->MatrixIndexExpr.row_index);
+		v->node(&n->MatrixIndexExpr.column_index);
+		v->token(&n->MatrixIndexExpr.open);
+		v->token(&n->MatrixIndexExpr.close);
+		break;
+
+	case Ast_BadStmt:
+		v->token(&n->BadStmt.begin);
+		v->token(&n->BadStmt.end);
+		break;
+	case Ast_EmptyStmt:
+		v->token(&n->EmptyStmt.token);
+		break;
+	case Ast_ExprStmt:
+		v->node(&n->ExprStmt.expr);
+		break;
+	case Ast_AssignStmt:
+		v->token(&n->AssignStmt.op);
+		v->slice(&n->AssignStmt.lhs);
+		v->slice(&n->AssignStmt.rhs);
+		break;
+	case Ast_BlockStmt:
+		v->slice(&n->BlockStmt.stmts);
+		v->node(&n->BlockStmt.label);
+		v->token(&n->BlockStmt.open);
+		v->token(&n->BlockStmt.close);
+		break;
+	case Ast_IfStmt:
+		v->token(&n->IfStmt.token);
+		v->node(&n->IfStmt.label);
+		v->node(&n->IfStmt.init);
+		v->node(&n->IfStmt.cond);
+		v->node(&n->IfStmt.body);
+		v->node(&n->IfStmt.else_stmt);
+		break;
+	case Ast_WhenStmt:
+		v->token(&n->WhenStmt.token);
+		v->node(&n->WhenStmt.cond);
+		v->node(&n->WhenStmt.body);
+		v->node(&n->WhenStmt.else_stmt);
+		break;
+	case Ast_ReturnStmt:
+		v->token(&n->ReturnStmt.token);
+		v->slice(&n->ReturnStmt.results);
+		break;
+	case Ast_ForStmt:
+		v->token(&n->ForStmt.token);
+		v->node(&n->ForStmt.label);
+		v->node(&n->ForStmt.init);
+		v->node(&n->ForStmt.cond);
+		v->node(&n->ForStmt.post);
+		v->node(&n->ForStmt.body);
+		break;
+	case Ast_RangeStmt:
+		v->token(&n->RangeStmt.token);
+		v->node(&n->RangeStmt.label);
+		v->node(&n->RangeStmt.init);
+		v->slice(&n->RangeStmt.vals);
+		v->token(&n->RangeStmt.in_token);
+		v->node(&n->RangeStmt.expr);
+		v->node(&n->RangeStmt.body);
+		break;
+	case Ast_UnrollRangeStmt:
+		v->token(&n->UnrollRangeStmt.unroll_token);
+		v->node(&n->UnrollRangeStmt.init);
+		v->slice(&n->UnrollRangeStmt.args);
+		v->token(&n->UnrollRangeStmt.for_token);
+		v->node(&n->UnrollRangeStmt.val0);
+		v->node(&n->UnrollRangeStmt.val1);
+		v->token(&n->UnrollRangeStmt.in_token);
+		v->node(&n->UnrollRangeStmt.expr);
+		v->node(&n->UnrollRangeStmt.body);
+		break;
+	case Ast_CaseClause:
+		v->token(&n->CaseClause.token);
+		v->slice(&n->CaseClause.list);
+		v->slice(&n->CaseClause.stmts);
+		break;
+	case Ast_SwitchStmt:
+		v->token(&n->SwitchStmt.token);
+		v->node(&n->SwitchStmt.label);
+		v->node(&n->SwitchStmt.init);
+		v->node(&n->SwitchStmt.tag);
+		v->node(&n->SwitchStmt.body);
+		break;
+	case Ast_TypeSwitchStmt:
+		v->token(&n->TypeSwitchStmt.token);
+		v->node(&n->TypeSwitchStmt.label);
+		v->node(&n->TypeSwitchStmt.tag);
+		v->node(&n->TypeSwitchStmt.body);
+		break;
+	case Ast_DeferStmt:
+		v->token(&n->DeferStmt.token);
+		v->node(&n->DeferStmt.stmt);
+		break;
+	case Ast_BranchStmt:
+		v->token(&n->BranchStmt.token);
+		v->node(&n->BranchStmt.label);
+		break;
+	case Ast_UsingStmt:
+		v->token(&n->UsingStmt.token);
+		v->slice(&n->UsingStmt.list);
+		break;
+
+	case Ast_BadDecl:
+		v->token(&n->BadDecl.begin);
+		v->token(&n->BadDecl.end);
+		break;
+	case Ast_ForeignBlockDecl:
+		v->token(&n->ForeignBlockDecl.token);
+		v->node(&n->ForeignBlockDecl.foreign_library);
+		v->node(&n->ForeignBlockDecl.body);
+		v->array(&n->ForeignBlockDecl.attributes);
+		v->comment(&n->ForeignBlockDecl.docs);
+		break;
+	case Ast_Label:
+		v->token(&n->Label.token);
+		v->node(&n->Label.name);
+		break;
+	case Ast_ValueDecl:
+		v->slice(&n->ValueDecl.names);
+		v->node(&n->ValueDecl.type);
+		v->slice(&n->ValueDecl.values);
+		v->array(&n->ValueDecl.attributes);
+		v->comment(&n->ValueDecl.docs);
+		v->comment(&n->ValueDecl.comment);
+		break;
+	case Ast_PackageDecl:
+		v->token(&n->PackageDecl.token);
+		v->token(&n->PackageDecl.name);
+		v->comment(&n->PackageDecl.docs);
+		v->comment(&n->PackageDecl.comment);
+		break;
+	case Ast_ImportDecl:
+		v->token(&n->ImportDecl.token);
+		v->token(&n->ImportDecl.relpath);
+		v->token(&n->ImportDecl.import_name);
+		v->array(&n->ImportDecl.attributes);
+		v->comment(&n->ImportDecl.docs);
+		v->comment(&n->ImportDecl.comment);
+		break;
+	case Ast_ForeignImportDecl:
+		v->token(&n->ForeignImportDecl.token);
+		v->slice(&n->ForeignImportDecl.filepaths);
+		v->token(&n->ForeignImportDecl.library_name);
+		v->string(&n->ForeignImportDecl.collection_name);
+		v->array(&n->ForeignImportDecl.attributes);
+		v->comment(&n->ForeignImportDecl.docs);
+		v->comment(&n->ForeignImportDecl.comment);
+		break;
+
+	case Ast_Attribute:
+		v->token(&n->Attribute.token);
+		v->slice(&n->Attribute.elems);
+		v->token(&n->Attribute.open);
+		v->token(&n->Attribute.close);
+		break;
+	case Ast_Field:
+		v->slice(&n->Field.names);
+		v->node(&n->Field.type);
+		v->node(&n->Field.default_value);
+		v->token(&n->Field.tag);
+		v->comment(&n->Field.docs);
+		v->comment(&n->Field.comment);
+		break;
+	case Ast_BitFieldField:
+		v->node(&n->BitFieldField.name);
+		v->node(&n->BitFieldField.type);
+		v->node(&n->BitFieldField.bit_size);
+		v->token(&n->BitFieldField.tag);
+		v->comment(&n->BitFieldField.docs);
+		v->comment(&n->BitFieldField.comment);
+		break;
+	case Ast_FieldList:
+		v->token(&n->FieldList.token);
+		v->slice(&n->FieldList.list);
+		break;
+
+	case Ast_TypeidType:
+		v->token(&n->TypeidType.token);
+		v->node(&n->TypeidType.specialization);
+		break;
+	case Ast_HelperType:
+		v->token(&n->HelperType.token);
+		v->node(&n->HelperType.type);
+		break;
+	case Ast_DistinctType:
+		v->token(&n->DistinctType.token);
+		v->node(&n->DistinctType.type);
+		break;
+	case Ast_PolyType:
+		v->token(&n->PolyType.token);
+		v->node(&n->PolyType.type);
+		v->node(&n->PolyType.specialization);
+		break;
+	case Ast_ProcType:
+		v->token(&n->ProcType.token);
+		v->node(&n->ProcType.params);
+		v->node(&n->ProcType.results);
+		break;
+	case Ast_PointerType:
+		v->token(&n->PointerType.token);
+		v->node(&n->PointerType.type);
+		v->node(&n->PointerType.tag);
+		break;
+	case Ast_RelativeType:
+		v->node(&n->RelativeType.tag);
+		v->node(&n->RelativeType.type);
+		break;
+	case Ast_MultiPointerType:
+		v->token(&n->MultiPointerType.token);
+		v->node(&n->MultiPointerType.type);
+		break;
+	case Ast_ArrayType:
+		v->token(&n->ArrayType.token);
+		v->node(&n->ArrayType.count);
+		v->node(&n->ArrayType.elem);
+		v->node(&n->ArrayType.tag);
+		break;
+	case Ast_DynamicArrayType:
+		v->token(&n->DynamicArrayType.token);
+		v->node(&n->DynamicArrayType.elem);
+		v->node(&n->DynamicArrayType.tag);
+		break;
+	case Ast_FixedCapacityDynamicArrayType:
+		v->token(&n->FixedCapacityDynamicArrayType.token);
+		v->node(&n->FixedCapacityDynamicArrayType.capacity);
+		v->node(&n->FixedCapacityDynamicArrayType.elem);
+		v->node(&n->FixedCapacityDynamicArrayType.tag);
+		break;
+	case Ast_StructType:
+		v->token(&n->StructType.token);
+		v->slice(&n->StructType.fields);
+		v->node(&n->StructType.polymorphic_params);
+		v->node(&n->StructType.align);
+		v->node(&n->StructType.min_field_align);
+		v->node(&n->StructType.max_field_align);
+		v->token(&n->StructType.where_token);
+		v->slice(&n->StructType.where_clauses);
+		break;
+	case Ast_UnionType:
+		v->token(&n->UnionType.token);
+		v->slice(&n->UnionType.variants);
+		v->node(&n->UnionType.polymorphic_params);
+		v->node(&n->UnionType.align);
+		v->token(&n->UnionType.where_token);
+		v->slice(&n->UnionType.where_clauses);
+		break;
+	case Ast_EnumType:
+		v->token(&n->EnumType.token);
+		v->node(&n->EnumType.base_type);
+		v->slice(&n->EnumType.fields);
+		break;
+	case Ast_BitSetType:
+		v->token(&n->BitSetType.token);
+		v->node(&n->BitSetType.elem);
+		v->node(&n->BitSetType.underlying);
+		break;
+	case Ast_BitFieldType:
+		v->token(&n->BitFieldType.token);
+		v->node(&n->BitFieldType.backing_type);
+		v->token(&n->BitFieldType.open);
+		v->slice(&n->BitFieldType.fields);
+		v->token(&n->BitFieldType.close);
+		break;
+	case Ast_MapType:
+		v->token(&n->MapType.token);
+		v->node(&n->MapType.count);
+		v->node(&n->MapType.key);
+		v->node(&n->MapType.value);
+		break;
+	case Ast_MatrixType:
+		v->token(&n->MatrixType.token);
+		v->node(&n->MatrixType.row_count);
+		v->node(&n->MatrixType.column_count);
+		v->node(&n->MatrixType.elem);
+		break;
+	}
+}
+
+
+// NOTE: Clears everything which is set by the checker, or which is redone when the snapshot is loaded
+gb_internal void ast_snapshot_clear(Ast *n) {
+	if (ast_kind_has_tav(n->kind)) {
+		gb_zero_item(&n->tav_mut());
+	}
+	switch (n->kind) {
+	case Ast_Ident:
+		n->Ident.entity.store(nullptr, std::memory_order_relaxed);
+		break;
+	case Ast_ProcLit:
+		n->ProcLit.decl = nullptr;
+		break;
+	case Ast_CallExpr:
+		n->CallExpr.split_args = nullptr;
+		n->CallExpr.entity_procedure_of = nullptr;
+		break;
+	case Ast_TypeAssertion:
+		n->TypeAssertion.type_hint = nullptr;
+		break;
+	case Ast_BlockStmt:
+		n->BlockStmt.scope = nullptr;
+		break;
+	case Ast_IfStmt:
+		n->IfStmt.scope = nullptr;
+		break;
+	case Ast_ForStmt:
+		n->ForStmt.scope = nullptr;
+		break;
+	case Ast_RangeStmt:
+		n->RangeStmt.scope = nullptr;
+		break;
+	case Ast_UnrollRangeStmt:
+		n->UnrollRangeStmt.scope = nullptr;
+		break;
+	case Ast_CaseClause:
+		n->CaseClause.scope = nullptr;
+		n->CaseClause.implicit_entity = nullptr;
+		break;
+	case Ast_SwitchStmt:
+		n->SwitchStmt.scope = nullptr;
+		break;
+	case Ast_TypeSwitchStmt:
+		n->TypeSwitchStmt.scope = nullptr;
+		break;
+	case Ast_ImportDecl:
+		// NOTE: the full path is determined again by parse_setup_file_decls
+		n->ImportDecl.package = nullptr;
+		n->ImportDecl.fullpath = {};
+		break;
+	case Ast_ForeignImportDecl:
+		n->ForeignImportDecl.fullpaths = {};
+		break;
+	case Ast_ProcType:
+		n->ProcType.scope = nullptr;
+		break;
+	case Ast_StructType:
+		n->StructType.scope = nullptr;
+		break;
+	case Ast_UnionType:
+		n->UnionType.scope = nullptr;
+		break;
+	case Ast_EnumType:
+		n->EnumType.scope = nullptr;
+		break;
+	case Ast_BitFieldType:
+		n->BitFieldType.scope = nullptr;
+		break;
+	}
+}
+
+gb_internal void init_ast_snapshot_cache(Array<String> const &args) {
+	String base_cache_dir = build_cache_base_dir();
+	if (base_cache_dir.len == 0) {
+		build_context.cached_ast = false;
+		return;
+	}
+	ast_snapshot_dir = concatenate_strings(permanent_allocator(), base_cache_dir, str_lit("/ast"));
+	(void)check_if_exists_directory_otherwise_create(ast_snapshot_dir);
+
+	// NOTE: the nodes are stored with the layout of this build of the compiler and the arguments
+	// decide which diagnostics the parser reports, so both are part of the key
+	TEMPORARY_ALLOCATOR_GUARD();
+	gbString s = gb_string_make(temporary_allocator(), "");
+	s = gb_string_append_fmt(s, "%.*s %s %s\n", LIT(ODIN_VERSION), __DATE__, __TIME__);
+#ifdef GIT_SHA
+	s = gb_string_append_fmt(s, "%s\n", GIT_SHA);
+#endif
+	s = gb_string_append_fmt(s, "%td %td %d\n", gb_size_of(Ast), gb_size_of(Token), cast(int)Ast_COUNT);
+	for (isize size : ast_variant_sizes) {
+		s = gb_string_append_fmt(s, "%td ", size);
+	}
+	for (String const &arg : args) {
+		s = gb_string_append_fmt(s, "%.*s\n", LIT(arg));
+	}
+	ast_snapshot_build_hash = gb_murmur64(s, gb_string_length(s));
+}
+
+gb_internal String ast_snapshot_path(u64 content_hash) {
+	char name[32] = {};
+	gb_snprintf(name, gb_size_of(name), "/%016llx.ast", cast(unsigned long long)content_hash);
+	return concatenate_strings(permanent_allocator(), ast_snapshot_dir, make_string_c(name));
+}
+
+
+struct AstSnapshotCollector {
+	PtrMap<Ast *, u64>          node_indices;    // index+1
+	PtrMap<CommentGroup *, u64> comment_indices; // index+1
+	Array<Ast *>                nodes;
+	Array<CommentGroup *>       comments;
+
+	void node(Ast **p) {
+		if (*p != nullptr && !map_set_if_not_previously_exists(&node_indices, *p, cast(u64)(nodes.count+1))) {
+			array_add(&nodes, *p);
+		}
+	}
+	void nodes_(Ast **elems, isize count) {
+		for (isize i = 0; i < count; i++) {
+			node(&elems[i]);
+		}
+	}
+	void slice(Slice<Ast *> *s) { nodes_(s->data, s->count); }
+	void array(Array<Ast *> *a) { nodes_(a->data, a->count); }
+	void token(Token *) {}
+	void string(String *) {}
+	void comment(CommentGroup **c) {
+		if (*c != nullptr && !map_set_if_not_previously_exists(&comment_indices, *c, cast(u64)(comments.count+1))) {
+			array_add(&comments, *c);
+		}
+	}
+};
+
+struct AstSnapshotEncoder {
+	AstFile *             f;
+	AstSnapshotCollector *c;
+	Array<u64>            refs;
+	Array<u8>             strings;
+
+	u64 ref(Ast *n) {
+		return n ? *map_get(&c->node_indices, n) : 0;
+	}
+	u64 add_refs(Ast **elems, isize count) {
+		if (count == 0) {
+			return 0;
+		}
+		u64 offset = cast(u64)refs.count;
+		for (isize i = 0; i < count; i++) {
+			array_add(&refs, ref(elems[i]));
+		}
+		return offset+1;
+	}
+
+	void node(Ast **p) {
+		*p = cast(Ast *)cast(uintptr)ref(*p);
+	}
+	void slice(Slice<Ast *> *s) {
+		s->data = cast(Ast **)cast(uintptr)add_refs(s->data, s->count);
+	}
+	void array(Array<Ast *> *a) {
+		a->data = cast(Ast **)cast(uintptr)add_refs(a->data, a->count);
+		a->allocator = {};
+		a->capacity = a->count;
+	}
+	void string(String *s) {
+		u8 const *start = f->tokenizer.start;
+		u8 const *end   = f->tokenizer.end;
+		u64 encoded = 0;
+		if (s->len == 0) {
+			encoded = 0;
+		} else if (start <= s->text && s->text+s->len <= end) {
+			encoded = cast(u64)(s->text - start) | AstSnapshotString_Source;
+		} else {
+			encoded = cast(u64)strings.count | AstSnapshotString_Table;
+			array_add_elems(&strings, s->text, s->len);
+		}
+		s->text = cast(u8 *)cast(uintptr)encoded;
+	}
+	void token(Token *t) {
+		string(&t->string);
+		t->pos.file_id = t->pos.file_id == f->id ? -1 : 0;
+	}
+	void comment(CommentGroup **p) {
+		*p = cast(CommentGroup *)cast(uintptr)(*p ? *map_get(&c->comment_indices, *p) : 0);
+	}
+};
+
+struct AstSnapshotDecoder {
+	AstFile *     f;
+	Ast **        nodes;
+	isize         node_count;
+	u64 *         refs;
+	CommentGroup *comments;
+	u8 *          strings;
+
+	Ast *ref(u64 index) {
+		GB_ASSERT(index <= cast(u64)node_count);
+		return index ? nodes[index-1] : nullptr;
+	}
+	Ast **decode_refs(Ast **data, isize count) {
+		if (count == 0) {
+			return nullptr;
+		}
+		u64 *elems = refs + (cast(uintptr)data - 1);
+		for (isize i = 0; i < count; i++) {
+			Ast *n = ref(elems[i]);
+			gb_memmove(&elems[i], &n, gb_size_of(n));
+		}
+		return cast(Ast **)elems;
+	}
+
+	void node(Ast **p) {
+		*p = ref(cast(u64)cast(uintptr)*p);
+	}
+	void slice(Slice<Ast *> *s) {
+		s->data = decode_refs(s->data, s->count);
+	}
+	void array(Array<Ast *> *a) {
+		a->data = decode_refs(a->data, a->count);
+		a->allocator = ast_allocator(f);
+	}
+	void string(String *s) {
+		u64 encoded = cast(u64)cast(uintptr)s->text;
+		u64 offset = encoded & ~AstSnapshotString_Mask;
+		switch (encoded & AstSnapshotString_Mask) {
+		case AstSnapshotString_Source: s->text = f->tokenizer.start + offset; break;
+		case AstSnapshotString_Table:  s->text = strings + offset;           break;
+		default:                       s->text = nullptr;                    break;
+		}
+	}
+	void token(Token *t) {
+		string(&t->string);
+		t->pos.file_id = t->pos.file_id < 0 ? f->id : 0;
+	}
+	void comment(CommentGroup **p) {
+		u64 index = cast(u64)cast(uintptr)*p;
+		*p = index ? &comments[index-1] : nullptr;
+	}
+};
+
+gb_internal isize ast_snapshot_align(isize offset) {
+	return align_formula_isize(offset, 16);
+}
+
+// NOTE: Only called once the file has been parsed without any errors or warnings
+gb_internal void ast_snapshot_save(AstFile *f) {
+	if (f->snapshot_content_hash == 0) {
+		return;
+	}
+
+	AstSnapshotCollector c = {};
+	map_init(&c.node_indices, 1024);
+	map_init(&c.comment_indices, 64);
+	c.nodes    = array_make<Ast *>(heap_allocator(), 0, 1024);
+	c.comments = array_make<CommentGroup *>(heap_allocator(), 0, f->comments.count);
+	defer (map_destroy(&c.node_indices));
+	defer (map_destroy(&c.comment_indices));
+	defer (array_free(&c.nodes));
+	defer (array_free(&c.comments));
+
+	c.node(&f->pkg_decl);
+	c.nodes_(f->decls.data, f->decls.count);
+	c.array(&f->imports);
+	for (CommentGroup *cg : f->comments) {
+		c.comment(&cg);
+	}
+	for (isize i = 0; i < c.nodes.count; i++) {
+		ast_snapshot_visit(c.nodes[i], &c);
+	}
+
+	AstSnapshotEncoder e = {};
+	e.f = f;
+	e.c = &c;
+	e.refs    = array_make<u64>(heap_allocator(), 0, c.nodes.count);
+	e.strings = array_make<u8>(heap_allocator(), 0, 256);
+	defer (array_free(&e.refs));
+	defer (array_free(&e.strings));
+
+	AstSnapshotHeader h = {};
+	h.magic        = AST_SNAPSHOT_MAGIC;
+	h.build_hash   = ast_snapshot_build_hash;
+	h.content_hash = f->snapshot_content_hash;
+	h.content_size = f->tokenizer.end - f->tokenizer.start;
+
+	isize comment_token_count = 0;
+	for (CommentGroup *cg : c.comments) {
+		comment_token_count += cg->list.count;
+	}
+
+	// NOTE: everything apart from the references and the strings has a known size up front
+	isize offset = ast_snapshot_align(gb_size_of(AstSnapshotHeader));
+	h.node_count = c.nodes.count;
+	h.node_table_offset = offset;
+	offset = ast_snapshot_align(offset + c.nodes.count*gb_size_of(u64));
+	isize nodes_offset = offset;
+	for (Ast *n : c.nodes) {
+		offset = ast_snapshot_align(offset + ast_node_prefix_size(n->kind) + ast_node_size(n->kind));
+	}
+	h.token_offset = offset;
+	h.token_count = f->tokens.count;
+	offset = ast_snapshot_align(offset + f->tokens.count*(2*gb_size_of(u32) + 2));
+	h.comment_token_offset = offset;
+	h.comment_token_count = comment_token_count;
+	offset = ast_snapshot_align(offset + comment_token_count*gb_size_of(Token));
+	h.comment_offset = offset;
+	h.comment_count = c.comments.count;
+	offset = ast_snapshot_align(offset + c.comments.count*gb_size_of(CommentGroup));
+
+	auto data = array_make<u8>(heap_allocator(), offset);
+	defer (array_free(&data));
+	gb_zero_size(data.data, data.count);
+
+	u64 *node_table = cast(u64 *)(data.data + h.node_table_offset);
+	isize node_offset = nodes_offset;
+	for_array(i, c.nodes) {
+		Ast *src = c.nodes[i];
+		// NOTE: the space for the TypeAndValue is kept so that the checker can fill it in once loaded
+		node_offset += ast_node_prefix_size(src->kind);
+		Ast *dst = cast(Ast *)(data.data + node_offset);
+		gb_memmove(dst, src, ast_node_size(src->kind));
+		dst->file_id = 0;
+		ast_snapshot_clear(dst);
+		ast_snapshot_visit(dst, &e);
+
+		node_table[i] = cast(u64)node_offset;
+		node_offset = ast_snapshot_align(node_offset + ast_node_size(src->kind));
+	}
+
+	// NOTE: the tokens only refer to the source by their offsets, so they are written as they are
+	isize token_count = f->tokens.count;
+	u8 *tokens = data.data + h.token_offset;
+	gb_memmove(tokens,                                     f->tokens.offsets, token_count*gb_size_of(u32));
+	gb_memmove(tokens + token_count*gb_size_of(u32),       f->tokens.lengths, token_count*gb_size_of(u32));
+	gb_memmove(tokens + token_count*2*gb_size_of(u32),     f->tokens.kinds,   token_count);
+	gb_memmove(tokens + token_count*(2*gb_size_of(u32)+1), f->tokens.flags,   token_count);
+
+	Token *comment_tokens = cast(Token *)(data.data + h.comment_token_offset);
+	CommentGroup *comments = cast(CommentGroup *)(data.data + h.comment_offset);
+	isize comment_token_index = 0;
+	for_array(i, c.comments) {
+		CommentGroup *cg = c.comments[i];
+		comments[i].list.data  = cast(Token *)cast(uintptr)(comment_token_index+1);
+		comments[i].list.count = cg->list.count;
+		for (Token const &tok : cg->list) {
+			comment_tokens[comment_token_index] = tok;
+			e.token(&comment_tokens[comment_token_index]);
+			comment_token_index += 1;
+		}
+	}
+
+	// NOTE: the file level information
+	h.pkg_decl      = e.ref(f->pkg_decl);
+	h.decls_ref     = e.add_refs(f->decls.data, f->decls.count);
+	h.decls_count   = f->decls.count;
+	h.imports_ref   = e.add_refs(f->imports.data, f->imports.count);
+	h.imports_count = f->imports.count;
+	h.comments_count = c.comments.count == 0 ? 0 : f->comments.count;
+	if (h.comments_count != 0) {
+		h.comments_ref = cast(u64)e.refs.count + 1;
+		for (CommentGroup *cg : f->comments) {
+			array_add(&e.refs, *map_get(&c.comment_indices, cg));
+		}
+	}
+	h.package_token = f->package_token;
+	e.token(&h.package_token);
+	h.seen_load_directive_count = cast(i32)f->seen_load_directive_count.load();
+	h.total_file_decl_count = f->total_file_decl_count;
+	h.delayed_decl_count = f->delayed_decl_count;
+
+	h.ref_offset = data.count;
+	h.ref_count = e.refs.count;
+	array_add_elems(&data, cast(u8 *)e.refs.data, e.refs.count*gb_size_of(u64));
+	h.string_offset = data.count;
+	h.string_size = e.strings.count;
+	array_add_elems(&data, e.strings.data, e.strings.count);
+
+	h.size = data.count;
+	h.body_hash = gb_murmur64(data.data + gb_size_of(h), data.count - gb_size_of(h));
+	gb_memmove(data.data, &h, gb_size_of(h));
+
+	// NOTE: written to a temporary file first as other threads or processes may be reading the same snapshot
+	String path = ast_snapshot_path(f->snapshot_content_hash);
+	gbString tmp = gb_string_make(heap_allocator(), "");
+	defer (gb_string_free(tmp));
+	tmp = gb_string_append_fmt(tmp, "%.*s.%d.tmp", LIT(path), f->id);
+
+	gbFile file = {};
+	if (gb_file_create(&file, tmp) != gbFileError_None) {
+		return;
+	}
+	bool ok = gb_file_write(&file, data.data, data.count);
+	gb_file_close(&file);
+	if (ok) {
+		ok = gb_file_move(tmp, alloc_cstring(temporary_allocator(), path));
+	}
+	if (!ok) {
+		gb_file_remove(tmp);
+	}
+}
+
+gb_internal u8 *ast_snapshot_map(String const &path, isize *size_) {
+	char const *path_c = alloc_cstring(temporary_allocator(), path);
+#if defined(GB_SYSTEM_UNIX) || defined(GB_SYSTEM_OSX)
+	int fd = open(path_c, O_RDONLY);
+	if (fd < 0) {
+		return nullptr;
+	}
+	defer (close(fd));
+	struct stat st = {};
+	if (fstat(fd, &st) != 0 || st.st_size < cast(isize)gb_size_of(AstSnapshotHeader)) {
+		return nullptr;
+	}
+	// NOTE: a private mapping so that the nodes can be relocated and later modified by the checker
+	void *ptr = mmap(nullptr, st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+	if (ptr == MAP_FAILED) {
+		return nullptr;
+	}
+	*size_ = st.st_size;
+	return cast(u8 *)ptr;
+#else
+	gbFileContents fc = gb_file_read_contents(heap_allocator(), false, path_c);
+	if (fc.data == nullptr || fc.size < gb_size_of(AstSnapshotHeader)) {
+		gb_file_free_contents(&fc);
+		return nullptr;
+	}
+	*size_ = fc.size;
+	return cast(u8 *)fc.data;
+#endif
+}
+
+gb_internal void ast_snapshot_unmap(u8 *data, isize size) {
+#if defined(GB_SYSTEM_UNIX) || defined(GB_SYSTEM_OSX)
+	munmap(data, size);
+#else
+	gb_free(heap_allocator(), data);
+#endif
+}
+
+gb_internal bool ast_snapshot_validate(AstSnapshotHeader const *h, u8 const *data, isize size) {
+	auto section_ok = [size](i64 offset, i64 count, i64 elem_size) -> bool {
+		return offset >= 0 && count >= 0 && offset <= size && count <= (size - offset)/gb_max(elem_size, 1);
+	};
+	if (h->size != size ||
+	    !section_ok(h->node_table_offset, h->node_count, gb_size_of(u64)) ||
+	    !section_ok(h->ref_offset, h->ref_count, gb_size_of(u64)) ||
+	    !section_ok(h->token_offset, h->token_count, 2*gb_size_of(u32) + 2) ||
+	    !section_ok(h->comment_token_offset, h->comment_token_count, gb_size_of(Token)) ||
+	    !section_ok(h->comment_offset, h->comment_count, gb_size_of(CommentGroup)) ||
+	    !section_ok(h->string_offset, h->string_size, 1)) {
+		return false;
+	}
+	if (h->body_hash != gb_murmur64(data + gb_size_of(*h), size - gb_size_of(*h))) {
+		return false;
+	}
+	u64 const *node_table = cast(u64 const *)(data + h->node_table_offset);
+	for (isize i = 0; i < h->node_count; i++) {
+		if (node_table[i] + gb_size_of(AstCommonStuff) > cast(u64)size) {
+			return false;
+		}
+		Ast const *n = cast(Ast const *)(data + node_table[i]);
+		if (n->kind <= Ast_Invalid || n->kind >= Ast_COUNT || node_table[i] + ast_node_size(n->kind) > cast(u64)size) {
+			return false;
+		}
+		if (node_table[i] < cast(u64)(h->node_table_offset + h->node_count*gb_size_of(u64) + ast_node_prefix_size(n->kind))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// NOTE: Expects the tokenizer to have loaded the file's contents but not to have tokenized them yet
+gb_internal bool ast_snapshot_load(AstFile *f) {
+	isize content_size = f->tokenizer.end - f->tokenizer.start;
+	f->snapshot_content_hash = gb_murmur64_seed(f->tokenizer.start, content_size, ast_snapshot_build_hash);
+	if (f->snapshot_content_hash == 0) {
+		return false;
+	}
+
+	u64 start = time_stamp_time_now();
+
+	TEMPORARY_ALLOCATOR_GUARD();
+	isize size = 0;
+	u8 *data = ast_snapshot_map(ast_snapshot_path(f->snapshot_content_hash), &size);
+	if (data == nullptr) {
+		return false;
+	}
+
+	AstSnapshotHeader *h = cast(AstSnapshotHeader *)data;
+	if (h->magic != AST_SNAPSHOT_MAGIC ||
+	    h->build_hash != ast_snapshot_build_hash ||
+	    h->content_hash != f->snapshot_content_hash ||
+	    h->content_size != content_size ||
+	    !ast_snapshot_validate(h, data, size)) {
+		ast_snapshot_unmap(data, size);
+		return false;
+	}
+
+	// NOTE: the snapshot stays mapped for the rest of the compilation, as the nodes live within it
+	AstSnapshotDecoder d = {};
+	d.f          = f;
+	d.node_count = h->node_count;
+	d.nodes      = permanent_alloc_array<Ast *>(gb_max(h->node_count, 1));
+	d.refs       = cast(u64 *)(data + h->ref_offset);
+	d.comments   = cast(CommentGroup *)(data + h->comment_offset);
+	d.strings    = data + h->string_offset;
+
+	u64 const *node_table = cast(u64 const *)(data + h->node_table_offset);
+	for (isize i = 0; i < h->node_count; i++) {
+		d.nodes[i] = cast(Ast *)(data + node_table[i]);
+	}
+
+	Token *comment_tokens = cast(Token *)(data + h->comment_token_offset);
+	for (isize i = 0; i < h->comment_token_count; i++) {
+		d.token(&comment_tokens[i]);
+	}
+	for (isize i = 0; i < h->comment_count; i++) {
+		Slice<Token> *list = &d.comments[i].list;
+		list->data = comment_tokens + (cast(uintptr)list->data - 1);
+	}
+
+	for (isize i = 0; i < h->node_count; i++) {
+		Ast *n = d.nodes[i];
+		n->file_id = f->id;
+		ast_snapshot_visit(n, &d);
+		f->node_count  += 1;
+		f->node_memory += ast_node_prefix_size(n->kind) + ast_node_size(n->kind);
+
+		switch (n->kind) {
+		case Ast_Ident:
+			n->Ident.hash     = string_hash(n->Ident.token.string);
+			n->Ident.interned = string_interner_insert(n->Ident.token.string);
+			break;
+		case Ast_BasicLit:
+			n->tav_mut().mode  = Addressing_Constant;
+			n->tav_mut().value = exact_value_from_token(f, n->BasicLit.token);
+			break;
+		case Ast_BasicDirective:
+			string_interner_insert(n->BasicDirective.name.string);
+			break;
+		}
+	}
+
+	isize token_count = h->token_count;
+	u8 *tokens = data + h->token_offset;
+	token_list_init(&f->tokens, ast_allocator(f), &f->tokenizer, 0);
+	f->tokens.offsets  = cast(u32 *)tokens;
+	f->tokens.lengths  = cast(u32 *)(tokens + token_count*gb_size_of(u32));
+	f->tokens.kinds    = tokens + token_count*2*gb_size_of(u32);
+	f->tokens.flags    = tokens + token_count*(2*gb_size_of(u32)+1);
+	f->tokens.count    = token_count;
+	f->tokens.capacity = token_count;
+
+	f->pkg_decl = d.ref(h->pkg_decl);
+	f->decls.data  = d.decode_refs(cast(Ast **)cast(uintptr)h->decls_ref, h->decls_count);
+	f->decls.count = h->decls_count;
+	f->imports.allocator = ast_allocator(f);
+	f->imports.data      = d.decode_refs(cast(Ast **)cast(uintptr)h->imports_ref, h->imports_count);
+	f->imports.count     = h->imports_count;
+	f->imports.capacity  = h->imports_count;
+
+	array_init(&f->comments, ast_allocator(f), h->comments_count);
+	for (isize i = 0; i < h->comments_count; i++) {
+		u64 index = d.refs[h->comments_ref-1 + i];
+		f->comments[i] = &d.comments[index-1];
+	}
+
+	f->package_token = h->package_token;
+	d.token(&f->package_token);
+	if (f->pkg_decl != nullptr && f->pkg_decl->kind == Ast_PackageDecl) {
+		f->package_name = f->pkg_decl->PackageDecl.name.string;
+	}
+	f->seen_load_directive_count.store(h->seen_load_directive_count);
+	f->total_file_decl_count = h->total_file_decl_count;
+	f->delayed_decl_count    = h->delayed_decl_count;
+
+	f->prev_token_index = 0;
+	f->curr_token_index = 0;
+	f->prev_token = token_list_get(&f->tokens, 0);
+	f->curr_token = token_list_get(&f->tokens, 0);
+	f->loaded_from_snapshot = true;
+
+	// NOTE: the time to load the snapshot takes the place of the time to tokenize
+	u64 end = time_stamp_time_now();
+	f->time_to_tokenize = cast(f64)(end-start)/cast(f64)time_stamp__freq();
+	return true;
+}
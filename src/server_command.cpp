@@ -0,0 +1,898 @@
+/*
+	`odin server <socket>` keeps compiler processes around and serves `check`/`build` requests from editor
+	tooling over a Unix socket, keeping the parsed and checked packages in memory between the requests.
+
+	The requests with the same working directory and arguments share a session:
+
+	* the server accepts the connections, and hands each one over to the session of its request, starting
+	  the session (with a fork of the server) when there is none yet;
+	* the session parses every package once and keeps them, along with the modification time and size of
+	  every file; for each request, only the files which have changed since are parsed again, in place of
+	  their previous versions;
+	* the checked packages are kept within a fork of the session, which is only made again once a file has
+	  changed; each request is served from a fork of that, which prints the errors or generates the code.
+
+	The parser and checker are not reentrant (the checker mutates the AST, and the global type, scope, and
+	error state) which is why the kept state is only ever used within a fork of the process which made it.
+	For `check`, the package summaries are kept by the session, so once a file has changed only the
+	procedure bodies of the packages affected by it are checked again.
+
+	A session is started again from scratch when the change cannot be made in place: a file is added to or
+	removed from a package, a file is now excluded by a build tag or within a different package, or a
+	package is no longer imported. The errors of an edited file are reported, and its previous version is
+	kept until it has been fixed.
+
+	Request:  the working directory followed by the arguments (e.g. "check", ".", "-vet"),
+	          each terminated by a NUL byte, and then an extra NUL byte.
+	Response: the combined output of the command, a NUL byte, and then the exit code in decimal.
+*/
+
+#if defined(GB_SYSTEM_OSX) || defined(GB_SYSTEM_UNIX)
+	#include <fcntl.h>
+	#include <signal.h>
+	#include <sys/socket.h>
+	#include <sys/stat.h>
+	#include <sys/un.h>
+	#include <sys/wait.h>
+	#include <time.h>
+
+gb_global isize const SERVER_MAX_SESSIONS = 4;
+gb_global i64   const SERVER_TIME_MARGIN  = 1000000000; // modification times may lag behind the clock (e.g. coarse timestamps)
+
+// NOTE: The messages between the processes of a session are a kind byte, followed by:
+//     'r' (request):       nothing, the connection of the request is passed along with it
+//     'c' (completed):     the exit code of the request, the session is kept
+//     'e' (ended):         the exit code of the request, the session has ended
+//     'x' (stale):         nothing, the request has not been served and the session has ended
+//     's' (summary):       the full path of a package, and its summary
+//     'l' (#load-ed file): the path, modification time, and size of a file read by the checker
+// A session which has replied 'c' is kept until the server closes its end of the socket pair.
+
+struct ServerSession {
+	String key; // the working directory and the arguments of the requests
+	pid_t  pid;
+	int    fd;  // the server's end of the socket pair shared with the session
+	u64    last_used;
+};
+
+struct ServerFileStamp {
+	String   path;
+	AstFile *file;       // nullptr for a file which was not parsed (e.g. excluded by a build tag) and a #load-ed file
+	bool     is_loaded;  // a #load-ed file, which only requires the packages to be checked again
+	bool     is_dir;     // a package directory, of which only the names of the .odin files are compared
+	i64      time;       // -1 if the file may have been changed whilst it was read, so its contents are compared
+	i64      size;
+	u64      names_hash; // is_dir
+};
+
+// NOTE: Set within the processes of a session
+gb_global int server_session_fd     = -1; // the socket shared with the parent process
+gb_global int server_session_conn   = -1; // the connection of the request being served
+gb_global int server_session_stdout = -1; // the standard output and error of the server, restored once a request has been served
+gb_global int server_session_stderr = -1;
+gb_global i64 server_session_read_time;   // when the process started reading the files it depends upon
+
+gb_internal bool server_read_request(int fd, Array<u8> *buf, Array<String> *fields) {
+	for (;;) {
+		u8 chunk[4096];
+		ssize_t n = read(fd, chunk, gb_size_of(chunk));
+		if (n <= 0 || buf->count+n > 1<<20) {
+			return false;
+		}
+		array_add_elems(buf, chunk, n);
+
+		// NOTE: the strings point into `buf`
+		array_clear(fields);
+		isize start = 0;
+		for (isize i = 0; i < buf->count; i++) {
+			if ((*buf)[i] != 0) {
+				continue;
+			}
+			if (i == start) {
+				return fields->count != 0;
+			}
+			array_add(fields, make_string(buf->data+start, i-start));
+			start = i+1;
+		}
+	}
+}
+
+gb_internal bool server_write_all(int fd, void const *data, isize len) {
+	u8 const *ptr = cast(u8 const *)data;
+	while (len > 0) {
+		ssize_t n = write(fd, ptr, len);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			return false;
+		}
+		ptr += n;
+		len -= n;
+	}
+	return true;
+}
+
+gb_internal bool server_read_all(int fd, void *data, isize len) {
+	u8 *ptr = cast(u8 *)data;
+	while (len > 0) {
+		ssize_t n = read(fd, ptr, len);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			return false;
+		}
+		ptr += n;
+		len -= n;
+	}
+	return true;
+}
+
+gb_internal bool server_send_fd(int sock, int fd) {
+	char kind = 'r';
+	struct iovec iov = {&kind, 1};
+	union {
+		struct cmsghdr align;
+		char buf[CMSG_SPACE(gb_size_of(int))];
+	} control = {};
+
+	struct msghdr msg = {};
+	msg.msg_iov        = &iov;
+	msg.msg_iovlen     = 1;
+	msg.msg_control    = control.buf;
+	msg.msg_controllen = gb_size_of(control.buf);
+
+	struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type  = SCM_RIGHTS;
+	cmsg->cmsg_len   = CMSG_LEN(gb_size_of(int));
+	gb_memmove(CMSG_DATA(cmsg), &fd, gb_size_of(int));
+
+	for (;;) {
+		ssize_t n = sendmsg(sock, &msg, 0);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		return n == 1;
+	}
+}
+
+// NOTE: Returns -1 once the other end of the socket has been closed
+gb_internal int server_recv_fd(int sock) {
+	char kind = 0;
+	struct iovec iov = {&kind, 1};
+	union {
+		struct cmsghdr align;
+		char buf[CMSG_SPACE(gb_size_of(int))];
+	} control = {};
+
+	struct msghdr msg = {};
+	msg.msg_iov        = &iov;
+	msg.msg_iovlen     = 1;
+	msg.msg_control    = control.buf;
+	msg.msg_controllen = gb_size_of(control.buf);
+
+	ssize_t n = 0;
+	do {
+		n = recvmsg(sock, &msg, 0);
+	} while (n < 0 && errno == EINTR);
+
+	struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+	if (n != 1 || kind != 'r' || cmsg == nullptr || cmsg->cmsg_type != SCM_RIGHTS) {
+		return -1;
+	}
+	int fd = -1;
+	gb_memmove(&fd, CMSG_DATA(cmsg), gb_size_of(int));
+	return fd;
+}
+
+gb_internal bool server_send_code(int sock, char kind, i32 code) {
+	u8 buf[5] = {cast(u8)kind};
+	gb_memmove(buf+1, &code, 4);
+	return server_write_all(sock, buf, gb_size_of(buf));
+}
+
+gb_internal void server_add_string(Array<u8> *buf, String const &s) {
+	u32 len = cast(u32)s.len;
+	array_add_elems(buf, cast(u8 *)&len, 4);
+	array_add_elems(buf, s.text, s.len);
+}
+
+gb_internal bool server_read_string(int fd, String *s) {
+	u32 len = 0;
+	if (!server_read_all(fd, &len, 4)) {
+		return false;
+	}
+	u8 *text = gb_alloc_array(heap_allocator(), u8, len+1);
+	text[len] = 0;
+	*s = make_string(text, len);
+	return server_read_all(fd, text, len);
+}
+
+gb_internal int server_wait(pid_t pid) {
+	int status = 0;
+	while (waitpid(pid, &status, 0) < 0) {
+		if (errno != EINTR) {
+			return 1;
+		}
+	}
+	return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+gb_internal i64 server_time_now(void) {
+	struct timespec ts = {};
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return cast(i64)ts.tv_sec*1000000000 + cast(i64)ts.tv_nsec;
+}
+
+gb_internal bool server_stat(String const &path, i64 *time, i64 *size) {
+	char const *path_c = alloc_cstring(heap_allocator(), path);
+	defer (gb_free(heap_allocator(), cast(void *)path_c));
+
+	struct stat st = {};
+	if (stat(path_c, &st) != 0) {
+		return false;
+	}
+#if defined(GB_SYSTEM_OSX)
+	*time = cast(i64)st.st_mtimespec.tv_sec*1000000000 + cast(i64)st.st_mtimespec.tv_nsec;
+#else
+	*time = cast(i64)st.st_mtim.tv_sec*1000000000 + cast(i64)st.st_mtim.tv_nsec;
+#endif
+	*size = cast(i64)st.st_size;
+	return true;
+}
+
+// NOTE: The names of the .odin files rather than the modification time of the directory, as the editors
+// which save by replacing the file change the latter on every save
+gb_internal bool server_hash_package_names(String const &dir, u64 *hash) {
+	Array<FileInfo> list = {};
+	ReadDirectoryError rd_err = read_directory(dir, &list);
+	defer (array_free(&list));
+
+	u64 h = 0;
+	for (FileInfo const &fi : list) {
+		if (!fi.is_dir && path_extension(fi.name) == ".odin") {
+			h += gb_murmur64(fi.name.text, fi.name.len);
+		}
+		gb_free(heap_allocator(), fi.name.text);
+		gb_free(heap_allocator(), fi.fullpath.text);
+	}
+	*hash = h;
+	return rd_err == ReadDirectory_None;
+}
+
+// NOTE: `read_time` is when the contents of the file were read, a file modified around it may have been read
+// before the modification and is always treated as changed
+gb_internal bool server_stamp_file(ServerFileStamp *s, i64 read_time) {
+	if (!server_stat(s->path, &s->time, &s->size)) {
+		return false;
+	}
+	if (s->time >= read_time - SERVER_TIME_MARGIN) {
+		s->time = -1;
+	}
+	if (s->is_dir) {
+		return server_hash_package_names(s->path, &s->names_hash);
+	}
+	return true;
+}
+
+// NOTE: Whether a file which may have been changed whilst it was read still has the contents which were parsed
+gb_internal bool server_file_contents_unchanged(AstFile *f) {
+	char const *path_c = alloc_cstring(heap_allocator(), f->fullpath);
+	defer (gb_free(heap_allocator(), cast(void *)path_c));
+
+	gbFileContents fc = gb_file_read_contents(heap_allocator(), false, path_c);
+	defer (gb_file_free_contents(&fc));
+
+	isize size = f->tokenizer.end - f->tokenizer.start;
+	return fc.data != nullptr && fc.size == size && gb_memcompare(fc.data, f->tokenizer.start, size) == 0;
+}
+
+gb_internal bool server_stamp_package(Array<ServerFileStamp> *stamps, AstPackage *pkg, i64 read_time) {
+	if (pkg->kind == Package_Builtin) {
+		return true;
+	}
+	if (pkg->is_single_file) {
+		ServerFileStamp s = {pkg->fullpath, pkg->files[0]};
+		bool ok = server_stamp_file(&s, read_time);
+		array_add(stamps, s);
+		return ok;
+	}
+
+	ServerFileStamp dir = {pkg->fullpath};
+	dir.is_dir = true;
+	if (!server_stamp_file(&dir, read_time)) {
+		return false;
+	}
+	array_add(stamps, dir);
+
+	Array<FileInfo> list = {};
+	ReadDirectoryError rd_err = read_directory(pkg->fullpath, &list);
+	defer (array_free(&list));
+
+	bool ok = rd_err == ReadDirectory_None;
+	for (FileInfo const &fi : list) {
+		if (ok && !fi.is_dir && path_extension(fi.name) == ".odin") {
+			ServerFileStamp s = {copy_string(heap_allocator(), fi.fullpath)};
+			for (AstFile *f : pkg->files) {
+				if (f->fullpath == s.path) {
+					s.file = f;
+					break;
+				}
+			}
+			ok = server_stamp_file(&s, read_time);
+			array_add(stamps, s);
+		}
+		gb_free(heap_allocator(), fi.name.text);
+		gb_free(heap_allocator(), fi.fullpath.text);
+	}
+	return ok;
+}
+
+gb_internal void server_imported_packages(Parser *p, StringSet *imported) {
+	for (AstPackage *pkg : p->packages) {
+		for (AstFile *f : pkg->files) {
+			for (Ast *node : f->imports) {
+				if (node->kind == Ast_ImportDecl && node->ImportDecl.fullpath.len != 0) {
+					string_set_add(imported, node->ImportDecl.fullpath);
+				}
+			}
+		}
+	}
+}
+
+gb_internal void server_set_close_on_exec(int fd) {
+	fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+}
+
+gb_internal void server_redirect_output(int conn) {
+	dup2(conn, STDOUT_FILENO);
+	dup2(conn, STDERR_FILENO);
+}
+
+gb_internal void server_restore_output(void) {
+	dup2(server_session_stdout, STDOUT_FILENO);
+	dup2(server_session_stderr, STDERR_FILENO);
+}
+
+gb_internal bool server_session_is_active(void) {
+	return server_session_fd >= 0;
+}
+
+enum ServerReparse {
+	ServerReparse_Done,
+	ServerReparse_Errors,      // the errors were printed and the previous versions are kept
+	ServerReparse_ErrorsEnded, // the errors were printed, and the kept packages cannot be used any more
+	ServerReparse_Stale,       // the kept packages cannot be used for the request
+};
+
+gb_internal ServerReparse server_session_reparse(Parser *p, Array<ServerFileStamp> *stamps, Array<isize> const &changed, StringSet *roots, int conn) {
+	isize package_count = p->packages.count;
+	auto files = array_make<AstFile *>(heap_allocator(), changed.count);
+	defer (array_free(&files));
+
+	// NOTE: an error which cannot be recovered from exits the process, after printing the errors to the client
+	server_redirect_output(conn);
+	defer (server_restore_output());
+	debugf("Server: parsing %td changed files\n", changed.count);
+
+	i64 read_time = server_time_now();
+	init_global_thread_pool();
+	g_parsing_done.store(false, std::memory_order_relaxed);
+	for_array(i, changed) {
+		files[i] = parser_reparse_file(p, (*stamps)[changed[i]].file);
+	}
+	// NOTE: the files of the packages which are newly imported
+	thread_pool_wait();
+	g_parsing_done.store(true, std::memory_order_relaxed);
+	thread_pool_destroy(&global_thread_pool);
+
+	if (any_errors()) {
+		print_all_errors();
+		clear_all_errors();
+		for_array(i, changed) {
+			AstFile *prev_file = (*stamps)[changed[i]].file;
+			thread_safe_replace_ast_file_from_id(prev_file->id, prev_file);
+		}
+		return p->packages.count == package_count ? ServerReparse_Errors : ServerReparse_ErrorsEnded;
+	}
+	if (any_warnings()) {
+		return ServerReparse_Stale;
+	}
+	for (AstFile *file : files) {
+		if (file == nullptr) {
+			return ServerReparse_Stale;
+		}
+	}
+
+	for_array(i, changed) {
+		ServerFileStamp *s = &(*stamps)[changed[i]];
+		parser_replace_file(p, s->file, files[i]);
+		s->file = files[i];
+		if (!server_stamp_file(s, read_time)) {
+			return ServerReparse_Stale;
+		}
+	}
+	for (isize i = package_count; i < p->packages.count; i++) {
+		if (!server_stamp_package(stamps, p->packages[i], read_time)) {
+			return ServerReparse_Stale;
+		}
+	}
+
+	// NOTE: a package which is no longer imported would still be checked
+	StringSet imported = {};
+	string_set_init(&imported);
+	defer (string_set_destroy(&imported));
+	server_imported_packages(p, &imported);
+	for (AstPackage *pkg : p->packages) {
+		if (!string_set_exists(roots, pkg->fullpath) && !string_set_exists(&imported, pkg->fullpath)) {
+			debugf("Server: %.*s is no longer imported\n", LIT(pkg->fullpath));
+			return ServerReparse_Stale;
+		}
+	}
+	return ServerReparse_Done;
+}
+
+// NOTE: Reads the messages of the checking process up to its reply to the request, returns false if it has exited
+gb_internal bool server_session_read_replies(int fd, Array<ServerFileStamp> *stamps, i32 *code) {
+	for (;;) {
+		char kind = 0;
+		if (!server_read_all(fd, &kind, 1)) {
+			return false;
+		}
+		switch (kind) {
+		case 'c':
+			return server_read_all(fd, code, 4);
+		case 's': {
+			String path = {};
+			String summary = {};
+			if (!server_read_string(fd, &path) || !server_read_string(fd, &summary)) {
+				return false;
+			}
+			String *prev = string_map_get(&package_summaries, path);
+			if (prev != nullptr) {
+				gb_free(heap_allocator(), prev->text);
+				gb_free(heap_allocator(), path.text);
+				*prev = summary;
+			} else {
+				string_map_set(&package_summaries, path, summary);
+			}
+			break;
+		}
+		case 'l': {
+			ServerFileStamp s = {};
+			s.is_loaded = true;
+			if (!server_read_all(fd, &s.time, 8) || !server_read_all(fd, &s.size, 8) || !server_read_string(fd, &s.path)) {
+				return false;
+			}
+			array_add(stamps, s);
+			break;
+		}
+		default:
+			return false;
+		}
+	}
+}
+
+// NOTE: Called once the packages have been parsed without any errors. Within a session, this only returns
+// within a fork which then checks the parsed packages and serves the request. The session itself keeps the
+// parsed packages, and serves each request by parsing the changed files again and forking once more.
+gb_internal void server_session_keep_parsed(Parser *p) {
+	if (!server_session_is_active()) {
+		return;
+	}
+	if (build_context.file_load_mode != FileLoad_Copy || any_warnings()) {
+		// NOTE: the AST refers to the memory mapped files which may change beneath it, and the warnings of
+		// the parser are only reported once; this request is served by this process alone instead
+		server_session_fd = -1;
+		return;
+	}
+
+	if (build_context.command_kind == Command_check && !build_context.show_unused) {
+		build_context.cached_packages = true;
+		package_summaries_in_memory = true;
+	}
+
+	auto stamps = array_make<ServerFileStamp>(heap_allocator(), 0, 1024);
+	StringSet roots = {};
+	string_set_init(&roots);
+	{
+		bool ok = true;
+		for (AstPackage *pkg : p->packages) {
+			ok = ok && server_stamp_package(&stamps, pkg, server_session_read_time);
+		}
+		if (!ok) {
+			server_session_fd = -1;
+			return;
+		}
+
+		StringSet imported = {};
+		string_set_init(&imported);
+		defer (string_set_destroy(&imported));
+		server_imported_packages(p, &imported);
+		for (AstPackage *pkg : p->packages) {
+			if (!string_set_exists(&imported, pkg->fullpath)) {
+				string_set_add(&roots, pkg->fullpath);
+			}
+		}
+	}
+
+	debugf("Server: keeping %td parsed packages\n", p->packages.count);
+
+	// NOTE: no threads may be running when forking
+	thread_pool_destroy(&global_thread_pool);
+	server_restore_output();
+
+	int conn = server_session_conn;
+	int check_fd = -1;
+	pid_t check_pid = -1;
+	for (isize request_count = 0; ; request_count++) {
+		if (conn < 0) {
+			conn = server_recv_fd(server_session_fd);
+			if (conn < 0) {
+				break; // NOTE: the server has ended the session
+			}
+
+			bool stale = false;
+			bool loaded_changed = false;
+			auto changed = array_make<isize>(heap_allocator(), 0, 16);
+			defer (array_free(&changed));
+			i64 read_time = server_time_now();
+			for_array(i, stamps) {
+				ServerFileStamp &s = stamps[i];
+				i64 time = 0;
+				i64 size = 0;
+				if (!server_stat(s.path, &time, &size)) {
+					loaded_changed |= s.is_loaded;
+					stale |= !s.is_loaded;
+					continue;
+				}
+				if (time == s.time && (s.is_dir || size == s.size)) {
+					continue;
+				}
+
+				ServerFileStamp prev = s;
+				if (s.is_dir) {
+					stale |= !server_stamp_file(&s, read_time) || s.names_hash != prev.names_hash;
+				} else if (s.is_loaded) {
+					loaded_changed = true;
+				} else if (s.file == nullptr) {
+					stale = true;
+				} else if (server_stamp_file(&s, read_time) && server_file_contents_unchanged(s.file)) {
+					// NOTE: saved (or touched) without a change, or stamped whilst it may have been changing
+				} else {
+					s = prev;
+					array_add(&changed, i);
+				}
+			}
+
+			if (!stale && (changed.count != 0 || loaded_changed) && check_pid > 0) {
+				close(check_fd);
+				server_wait(check_pid);
+				check_pid = -1;
+			}
+			if (!stale && changed.count != 0) {
+				ServerReparse reparse = server_session_reparse(p, &stamps, changed, &roots, conn);
+
+				if (reparse == ServerReparse_Errors || reparse == ServerReparse_ErrorsEnded) {
+					close(conn);
+					conn = -1;
+					if (reparse == ServerReparse_ErrorsEnded) {
+						server_send_code(server_session_fd, 'e', 1);
+						break;
+					}
+					server_send_code(server_session_fd, 'c', 1);
+					continue;
+				}
+				stale = reparse == ServerReparse_Stale;
+			}
+			if (stale) {
+				server_write_all(server_session_fd, "x", 1);
+				break;
+			}
+		}
+
+		if (check_pid < 0) {
+			int fds[2] = {};
+			if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+				break;
+			}
+			// NOTE: the checking process reports the #load-ed files it has read
+			for (isize i = stamps.count-1; i >= 0; i--) {
+				if (stamps[i].is_loaded) {
+					array_unordered_remove(&stamps, i);
+				}
+			}
+
+			fflush(nullptr);
+			check_pid = fork();
+			if (check_pid == 0) {
+				close(fds[0]);
+				close(server_session_fd);
+				server_session_fd   = fds[1];
+				server_session_conn = conn;
+				server_session_read_time = server_time_now();
+				server_redirect_output(conn);
+				if (request_count != 0) {
+					debugf("Server: reusing the parsed packages\n");
+				}
+				init_global_thread_pool();
+				return;
+			}
+			close(fds[1]);
+			check_fd = fds[0];
+			server_set_close_on_exec(check_fd);
+			if (check_pid < 0) {
+				close(check_fd);
+				break;
+			}
+		} else if (!server_send_fd(check_fd, conn)) {
+			break;
+		}
+		close(conn);
+		conn = -1;
+
+		i32 code = 1;
+		if (!server_session_read_replies(check_fd, &stamps, &code)) {
+			close(check_fd);
+			code = server_wait(check_pid);
+			check_pid = -1;
+		}
+		server_send_code(server_session_fd, 'c', code);
+	}
+
+	if (check_pid > 0) {
+		close(check_fd);
+		server_wait(check_pid);
+	}
+	_exit(0);
+}
+
+// NOTE: Called once the parsed packages have been checked. Within a session, this only returns within a fork
+// which then serves a single request. The checking process itself keeps the checked packages, and serves
+// each request with a fork of its own until the session parses a changed file again.
+gb_internal void server_session_keep_checked(Checker *c) {
+	if (!server_session_is_active()) {
+		return;
+	}
+
+	auto buf = array_make<u8>(heap_allocator(), 0, 4096);
+	if (package_summaries_in_memory && !any_errors() && !any_warnings()) {
+		write_package_summaries(c);
+		for (auto const &entry : package_summaries) {
+			array_add(&buf, cast(u8)'s');
+			server_add_string(&buf, entry.key);
+			server_add_string(&buf, entry.value);
+		}
+	}
+	for (auto const &entry : c->info.load_file_cache) {
+		LoadFileCache *cache = entry.value;
+		i64 time = 0;
+		i64 size = 0;
+		if (cache != nullptr && cache->exists && server_stat(cache->path, &time, &size)) {
+			if (time >= server_session_read_time - SERVER_TIME_MARGIN) {
+				time = -1;
+			}
+			array_add(&buf, cast(u8)'l');
+			array_add_elems(&buf, cast(u8 *)&time, 8);
+			array_add_elems(&buf, cast(u8 *)&size, 8);
+			server_add_string(&buf, cache->path);
+		}
+	}
+	server_write_all(server_session_fd, buf.data, buf.count);
+	array_free(&buf);
+
+	// NOTE: no threads may be running when forking
+	thread_pool_destroy(&global_thread_pool);
+	server_restore_output();
+
+	int conn = server_session_conn;
+	for (isize request_count = 0; ; request_count++) {
+		fflush(nullptr);
+		pid_t worker = fork();
+		if (worker == 0) {
+			close(server_session_fd);
+			server_session_fd = -1;
+			server_redirect_output(conn);
+			close(conn);
+			if (request_count != 0) {
+				debugf("Server: reusing the checked packages\n");
+			}
+			init_global_thread_pool();
+			// NOTE: the summaries have already been kept by the session
+			build_context.cached_packages = false;
+			return;
+		}
+
+		i32 code = worker > 0 ? server_wait(worker) : 1;
+		close(conn);
+		server_send_code(server_session_fd, 'c', code);
+
+		conn = server_recv_fd(server_session_fd);
+		if (conn < 0) {
+			break;
+		}
+	}
+	_exit(0);
+}
+
+gb_internal void server_end_session(Array<ServerSession> *sessions, isize index) {
+	ServerSession s = (*sessions)[index];
+	array_ordered_remove(sessions, index);
+	close(s.fd);
+	if (s.pid > 0) {
+		server_wait(s.pid);
+	}
+	gb_free(heap_allocator(), s.key.text);
+}
+
+// NOTE: Only returns true within a forked process, which must then serve the request given by `out_args`
+gb_internal bool server_command(int arg_count, char const **arg_ptr, Array<char const *> *out_args, int *exit_code) {
+	*exit_code = 1;
+	if (arg_count != 3) {
+		gb_printf_err("Usage: %s server <socket path>\n", arg_ptr[0]);
+		return false;
+	}
+
+	String socket_path = make_string_c(arg_ptr[2]);
+
+	struct sockaddr_un addr = {};
+	addr.sun_family = AF_UNIX;
+	if (socket_path.len >= gb_size_of(addr.sun_path)) {
+		gb_printf_err("Socket path is too long: %.*s\n", LIT(socket_path));
+		return false;
+	}
+	gb_memmove(addr.sun_path, socket_path.text, socket_path.len);
+
+	int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listen_fd < 0) {
+		gb_printf_err("Unable to create socket: %s\n", strerror(errno));
+		return false;
+	}
+	unlink(addr.sun_path); // NOTE: remove a stale socket from a previous server
+	if (bind(listen_fd, cast(struct sockaddr *)&addr, gb_size_of(addr)) != 0 || listen(listen_fd, 16) != 0) {
+		gb_printf_err("Unable to listen on %.*s: %s\n", LIT(socket_path), strerror(errno));
+		close(listen_fd);
+		return false;
+	}
+
+	signal(SIGPIPE, SIG_IGN);
+	server_set_close_on_exec(listen_fd);
+
+	gb_printf_err("Listening on %.*s\n", LIT(socket_path));
+
+	auto sessions = array_make<ServerSession>(heap_allocator(), 0, SERVER_MAX_SESSIONS);
+	auto buf      = array_make<u8>(heap_allocator(), 0, 4096);
+	auto fields   = array_make<String>(heap_allocator(), 0, 16);
+	u64 request_count = 0;
+
+	for (;;) {
+		int conn = accept(listen_fd, nullptr, nullptr);
+		if (conn < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			gb_printf_err("Unable to accept a connection: %s\n", strerror(errno));
+			break;
+		}
+		server_set_close_on_exec(conn);
+
+		// NOTE: the requests are read one at a time, so a client which never sends one must not hold up the others
+		struct timeval timeout = {10, 0};
+		setsockopt(conn, SOL_SOCKET, SO_RCVTIMEO, &timeout, gb_size_of(timeout));
+
+		array_clear(&buf);
+		if (!server_read_request(conn, &buf, &fields) || fields.count < 2) {
+			close(conn);
+			continue;
+		}
+		String key = make_string(buf.data, fields[fields.count-1].text + fields[fields.count-1].len - buf.data);
+		request_count += 1;
+
+		i32 code = 1;
+		for (;;) {
+			isize index = -1;
+			for_array(i, sessions) {
+				if (sessions[i].key == key) {
+					index = i;
+					break;
+				}
+			}
+
+			if (index < 0) {
+				if (sessions.count == SERVER_MAX_SESSIONS) {
+					isize lru = 0;
+					for_array(i, sessions) {
+						if (sessions[i].last_used < sessions[lru].last_used) {
+							lru = i;
+						}
+					}
+					server_end_session(&sessions, lru);
+				}
+
+				int fds[2] = {};
+				if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+					dprintf(conn, "Unable to start a session: %s\n", strerror(errno));
+					break;
+				}
+				i64 read_time = server_time_now();
+				pid_t pid = fork();
+				if (pid == 0) {
+					close(listen_fd);
+					close(fds[0]);
+					for (ServerSession const &s : sessions) {
+						close(s.fd);
+					}
+					char const *cwd = alloc_cstring(heap_allocator(), fields[0]);
+					if (chdir(cwd) != 0) {
+						dprintf(conn, "Unable to change the working directory to %s: %s\n", cwd, strerror(errno));
+						_exit(1);
+					}
+					server_session_fd     = fds[1];
+					server_session_conn   = conn;
+					server_session_stdout = dup(STDOUT_FILENO);
+					server_session_stderr = dup(STDERR_FILENO);
+					server_session_read_time = read_time;
+					server_set_close_on_exec(server_session_fd);
+					server_set_close_on_exec(server_session_stdout);
+					server_set_close_on_exec(server_session_stderr);
+					server_redirect_output(conn);
+
+					array_init(out_args, heap_allocator(), 0, fields.count);
+					array_add(out_args, arg_ptr[0]);
+					for (isize i = 1; i < fields.count; i++) {
+						array_add(out_args, cast(char const *)alloc_cstring(heap_allocator(), fields[i]));
+					}
+					*exit_code = 0;
+					return true;
+				}
+				close(fds[1]);
+				server_set_close_on_exec(fds[0]);
+				if (pid < 0) {
+					close(fds[0]);
+					dprintf(conn, "Unable to start a session: %s\n", strerror(errno));
+					break;
+				}
+
+				ServerSession s = {copy_string(heap_allocator(), key), pid, fds[0]};
+				array_add(&sessions, s);
+				index = sessions.count-1;
+			} else if (!server_send_fd(sessions[index].fd, conn)) {
+				server_end_session(&sessions, index);
+				continue;
+			}
+			sessions[index].last_used = request_count;
+
+			u8 kind = 0;
+			if (server_read_all(sessions[index].fd, &kind, 1) && kind == 'x') {
+				server_end_session(&sessions, index);
+				continue;
+			}
+			if ((kind != 'c' && kind != 'e') || !server_read_all(sessions[index].fd, &code, 4)) {
+				// NOTE: the request was served by the session alone (or it has failed) and it has exited
+				code = server_wait(sessions[index].pid);
+				sessions[index].pid = -1;
+				server_end_session(&sessions, index);
+			} else if (kind == 'e') {
+				server_end_session(&sessions, index);
+			}
+			break;
+		}
+
+		char trailer[32] = {}; // NUL separator followed by the exit code
+		isize digits = gb_snprintf(trailer+1, gb_size_of(trailer)-1, "%d", code) - 1; // excludes the terminator
+		isize len = 1 + digits;
+		server_write_all(conn, trailer, len);
+		close(conn);
+	}
+
+	while (sessions.count != 0) {
+		server_end_session(&sessions, sessions.count-1);
+	}
+	close(listen_fd);
+	unlink(addr.sun_path);
+	return false;
+}
+
+#endif
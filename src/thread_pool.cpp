@@ -12,6 +12,8 @@
 
 struct WorkerTask;
 struct ThreadPool;
+struct TaskGroup;
+struct TaskNode;
 
 gb_global gb_thread_local Thread *current_thread;
 gb_internal Thread *get_current_thread(void) {
@@ -22,6 +24,9 @@ gb_internal void thread_pool_init(ThreadPool *pool, isize worker_count, char con
 gb_internal void thread_pool_destroy(ThreadPool *pool);
 gb_internal bool thread_pool_add_task(ThreadPool *pool, WorkerTaskProc *proc, void *data);
 gb_internal void thread_pool_wait(ThreadPool *pool);
+gb_internal bool thread_pool_add_task(ThreadPool *pool, TaskGroup *group, WorkerTaskProc *proc, void *data);
+gb_internal void thread_pool_wait(ThreadPool *pool, TaskGroup *group);
+gb_internal void thread_pool_start_task_node(ThreadPool *pool, TaskNode *node);
 
 enum GrabState {
 	Grab_Success = 0,
@@ -38,9 +43,31 @@ struct ThreadPool {
 	gbAllocator       threads_allocator;
 	Slice<Thread>     threads;
 	std::atomic<bool> running;
+	bool              show_stats; // printed once the threads have been joined
 
 	Futex tasks_available;
 	Futex tasks_left;
+
+	// NOTE: tasks added by threads outside of the pool, which cannot push onto a queue of their own
+	BlockingMutex      external_mutex;
+	Array<WorkerTask>  external_tasks;
+	std::atomic<isize> external_count;
+};
+
+// NOTE: A set of tasks which can be waited upon without waiting for every other task in the pool,
+// allowing independent stages to run at the same time. Tasks may add further tasks to their own group.
+struct TaskGroup {
+	Futex tasks_left;
+};
+
+// NOTE: A task within a dependency graph, which is only added to the pool (within its group) once every
+// task it depends upon has finished. Every dependency must be added before any node of the graph is started.
+struct TaskNode {
+	WorkerTaskProc *   proc;
+	void *             data;
+	TaskGroup *        group;
+	std::atomic<isize> dependencies_left;
+	Array<TaskNode *>  dependents;
 };
 
 gb_internal isize current_thread_index(void) {
@@ -50,6 +77,7 @@ gb_internal isize current_thread_index(void) {
 gb_internal void thread_pool_init(ThreadPool *pool, isize worker_count, char const *worker_name) {
 	pool->threads_allocator = permanent_allocator();
 	slice_init(&pool->threads, pool->threads_allocator, worker_count + 1);
+	array_init(&pool->external_tasks, heap_allocator(), 0, 64);
 
 	// NOTE: this needs to be initialized before any thread starts
 	pool->running.store(true, std::memory_order_seq_cst);
@@ -64,6 +92,26 @@ gb_internal void thread_pool_init(ThreadPool *pool, isize worker_count, char con
 	}
 }
 
+gb_internal void thread_pool_print_stats(ThreadPool *pool) {
+	ThreadPoolWorkerStats total = {};
+	gb_printf("\nThread Pool Statistics\n");
+	gb_printf("%8s %12s %12s %12s %10s %14s\n", "Thread", "Tasks", "Steals", "Attempts", "Parks", "Parked (ms)");
+	for_array(i, pool->threads) {
+		ThreadPoolWorkerStats const &s = pool->threads[i].stats;
+		gb_printf("%8td %12llu %12llu %12llu %10llu %14.3f\n", i,
+		          cast(unsigned long long)s.tasks_executed, cast(unsigned long long)s.steals_succeeded,
+		          cast(unsigned long long)s.steals_attempted, cast(unsigned long long)s.park_count, s.time_parked*1000.0);
+		total.tasks_executed   += s.tasks_executed;
+		total.steals_succeeded += s.steals_succeeded;
+		total.steals_attempted += s.steals_attempted;
+		total.park_count       += s.park_count;
+		total.time_parked      += s.time_parked;
+	}
+	gb_printf("%8s %12llu %12llu %12llu %10llu %14.3f\n", "total",
+	          cast(unsigned long long)total.tasks_executed, cast(unsigned long long)total.steals_succeeded,
+	          cast(unsigned long long)total.steals_attempted, cast(unsigned long long)total.park_count, total.time_parked*1000.0);
+}
+
 gb_internal void thread_pool_destroy(ThreadPool *pool) {
 	pool->running.store(false, std::memory_order_seq_cst);
 
@@ -74,7 +122,12 @@ gb_internal void thread_pool_destroy(ThreadPool *pool) {
 		thread_join_and_destroy(t);
 	}
 
+	if (pool->show_stats) {
+		thread_pool_print_stats(pool);
+	}
+
 	gb_free(pool->threads_allocator, pool->threads.data);
+	array_free(&pool->external_tasks);
 }
 
 TaskRingBuffer *task_ring_grow(TaskRingBuffer *ring, isize bottom, isize top) {
@@ -97,12 +150,17 @@ void thread_pool_queue_push(Thread *thread, WorkerTask task) {
 		cur_ring = thread->queue.ring.load(std::memory_order_relaxed);
 	}
 
+	// NOTE: counted before it can be taken (or stolen), so that the count cannot reach zero early
+	if (task.group != nullptr) {
+		task.group->tasks_left.fetch_add(1, std::memory_order_release);
+	}
+	thread->pool->tasks_left.fetch_add(1, std::memory_order_release);
+
 	cur_ring->buffer[bot % cur_ring->size] = task;
 	TSAN_RELEASE(cur_ring->buffer[bot % cur_ring->size]);
 	std::atomic_thread_fence(std::memory_order_release);
 	thread->queue.bottom.store(bot + 1, std::memory_order_relaxed);
 
-	thread->pool->tasks_left.fetch_add(1, std::memory_order_release);
 	i32 state = Someone_Waiting;
 	if (thread->pool->tasks_available.compare_exchange_strong(state, Nobody_Waiting)) {
 		futex_broadcast(&thread->pool->tasks_available);
@@ -165,23 +223,180 @@ GrabState thread_pool_queue_steal(Thread *thread, WorkerTask *task) {
 	return ret;
 }
 
+gb_internal void thread_pool_do_task(ThreadPool *pool, WorkerTask *task) {
+	current_thread->stats.tasks_executed += 1;
+	task->do_work(task->data);
+	if (task->group != nullptr) {
+		// NOTE: the group may be released by its waiter as soon as the count reaches zero, so its
+		// address is taken before the decrement rather than read back through the group after it
+		Futex *group_tasks_left = &task->group->tasks_left;
+		if (group_tasks_left->fetch_sub(1, std::memory_order_release) == 1) {
+			futex_broadcast(group_tasks_left);
+		}
+	}
+	if (pool->tasks_left.fetch_sub(1, std::memory_order_release) == 1) {
+		futex_signal(&pool->tasks_left);
+	}
+}
+
+gb_internal void thread_pool_external_push(ThreadPool *pool, WorkerTask task) {
+	MUTEX_GUARD_BLOCK(&pool->external_mutex) {
+		// NOTE: counted before it can be taken, so that the count cannot reach zero early
+		if (task.group != nullptr) {
+			task.group->tasks_left.fetch_add(1, std::memory_order_release);
+		}
+		pool->tasks_left.fetch_add(1, std::memory_order_release);
+		array_add(&pool->external_tasks, task);
+		pool->external_count.fetch_add(1, std::memory_order_release);
+	}
+
+	i32 state = Someone_Waiting;
+	if (pool->tasks_available.compare_exchange_strong(state, Nobody_Waiting)) {
+		futex_broadcast(&pool->tasks_available);
+	}
+	// NOTE: a thread within `thread_pool_wait` may be the only one left to run it
+	futex_broadcast(&pool->tasks_left);
+}
+
+gb_internal bool thread_pool_external_take(ThreadPool *pool, WorkerTask *task) {
+	bool ok = false;
+	MUTEX_GUARD_BLOCK(&pool->external_mutex) {
+		if (pool->external_tasks.count != 0) {
+			*task = array_pop(&pool->external_tasks);
+			pool->external_count.fetch_sub(1, std::memory_order_release);
+			ok = true;
+		}
+	}
+	return ok;
+}
+
+gb_internal void thread_pool_push(ThreadPool *pool, WorkerTask task) {
+	if (current_thread == nullptr || current_thread->pool != pool) {
+		thread_pool_external_push(pool, task);
+	} else {
+		thread_pool_queue_push(current_thread, task);
+	}
+}
+
 gb_internal bool thread_pool_add_task(ThreadPool *pool, WorkerTaskProc *proc, void *data) {
 	WorkerTask task = {};
 	task.do_work = proc;
 	task.data = data;
 		
-	thread_pool_queue_push(current_thread, task);
+	thread_pool_push(pool, task);
 	return true;
 }	
 
+gb_internal bool thread_pool_add_task(ThreadPool *pool, TaskGroup *group, WorkerTaskProc *proc, void *data) {
+	WorkerTask task = {};
+	task.do_work = proc;
+	task.data = data;
+	task.group = group;
+
+	thread_pool_push(pool, task);
+	return true;
+}
+
+// NOTE: Victims are chosen at random so that idle threads do not all contend upon the same queues
+gb_internal usize thread_pool_random_victim(ThreadPool *pool) {
+	u64 x = current_thread->rng_state;
+	if (x == 0) {
+		x = cast(u64)(current_thread->idx+1) * 0x9e3779b97f4a7c15ull;
+	}
+	// xorshift64
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	current_thread->rng_state = x;
+	return cast(usize)(x % cast(u64)pool->threads.count);
+}
+
+gb_internal bool thread_pool_any_queued_task(ThreadPool *pool) {
+	if (pool->external_count.load(std::memory_order_relaxed) != 0) {
+		return true;
+	}
+	for_array(i, pool->threads) {
+		TaskQueue *q = &pool->threads.data[i].queue;
+		if (q->top.load(std::memory_order_relaxed) < q->bottom.load(std::memory_order_relaxed)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+enum : isize {
+	THREAD_POOL_SPIN_LIMIT_MIN = 16,
+	THREAD_POOL_SPIN_LIMIT_MAX = 1<<12,
+};
+
+// NOTE: Tasks are usually added in bursts, so spinning for a while before parking avoids the cost of
+// a futex wake for each of them. The limit grows while spinning finds tasks and shrinks while it does not.
+gb_internal bool thread_pool_spin_for_tasks(ThreadPool *pool) {
+	Thread *t = current_thread;
+	if (t->spin_limit == 0) {
+		t->spin_limit = THREAD_POOL_SPIN_LIMIT_MIN;
+	}
+	for (isize i = 0; i < t->spin_limit; i++) {
+		if (!pool->running.load(std::memory_order_relaxed)) {
+			return false;
+		}
+		if (thread_pool_any_queued_task(pool)) {
+			t->spin_limit = gb_min(t->spin_limit*2, THREAD_POOL_SPIN_LIMIT_MAX);
+			return true;
+		}
+		yield_thread();
+	}
+	t->spin_limit = gb_max(t->spin_limit/2, THREAD_POOL_SPIN_LIMIT_MIN);
+	return false;
+}
+
+// NOTE: Waits for only the tasks of `group`, running (and stealing) any other tasks in the meantime,
+// so it may be called from within a task too
+gb_internal void thread_pool_wait(ThreadPool *pool, TaskGroup *group) {
+	WorkerTask task;
+
+	while (group->tasks_left.load(std::memory_order_acquire)) {
+		if (!thread_pool_queue_take(current_thread, &task)) {
+			thread_pool_do_task(pool, &task);
+			continue;
+		}
+
+		bool stole = false;
+		usize idx = thread_pool_random_victim(pool);
+		for_array(i, pool->threads) {
+			idx = (idx + 1) % cast(usize)pool->threads.count;
+			if (idx == cast(usize)current_thread->idx) {
+				continue;
+			}
+			current_thread->stats.steals_attempted += 1;
+			if (thread_pool_queue_steal(&pool->threads.data[idx], &task) == Grab_Success) {
+				current_thread->stats.steals_succeeded += 1;
+				thread_pool_do_task(pool, &task);
+				stole = true;
+				break;
+			}
+		}
+		if (stole) {
+			continue;
+		}
+
+		// NOTE: the remaining tasks of the group are being run by other threads; the last one to
+		// finish wakes every waiter of the group
+		Footex rem_tasks = group->tasks_left.load(std::memory_order_acquire);
+		if (rem_tasks == 0) {
+			return;
+		}
+		futex_wait(&group->tasks_left, rem_tasks);
+	}
+}
+
 gb_internal void thread_pool_wait(ThreadPool *pool) {
 	WorkerTask task;
 
 	while (pool->tasks_left.load(std::memory_order_acquire)) {
 		// if we've got tasks on our queue, run them
 		while (!thread_pool_queue_take(current_thread, &task)) {
-			task.do_work(task.data);
-			pool->tasks_left.fetch_sub(1, std::memory_order_release);
+			thread_pool_do_task(pool, &task);
 		}
 
 		// is this mem-barriered enough?
@@ -193,10 +408,54 @@ gb_internal void thread_pool_wait(ThreadPool *pool) {
 			return;
 		}
 
+		// NOTE: taken under the lock, after loading `rem_tasks`, so that an external task being added
+		// either is taken here or has changed `rem_tasks` already
+		if (thread_pool_external_take(pool, &task)) {
+			thread_pool_do_task(pool, &task);
+			continue;
+		}
+
 		futex_wait(&pool->tasks_left, rem_tasks);
 	}
 }
 
+gb_internal void task_node_init(TaskNode *node, TaskGroup *group, WorkerTaskProc *proc, void *data) {
+	node->proc  = proc;
+	node->data  = data;
+	node->group = group;
+	node->dependencies_left.store(1, std::memory_order_relaxed); // NOTE: released by thread_pool_start_task_node
+	array_init(&node->dependents, permanent_allocator(), 0, 0);
+}
+
+gb_internal void task_node_add_dependency(TaskNode *node, TaskNode *dependency) {
+	node->dependencies_left.fetch_add(1, std::memory_order_relaxed);
+	array_add(&dependency->dependents, node);
+}
+
+gb_internal WORKER_TASK_PROC(task_node_worker_proc);
+
+gb_internal void task_node_release(ThreadPool *pool, TaskNode *node) {
+	if (node->dependencies_left.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		thread_pool_add_task(pool, node->group, task_node_worker_proc, node);
+	}
+}
+
+gb_internal WORKER_TASK_PROC(task_node_worker_proc) {
+	TaskNode *node = cast(TaskNode *)data;
+	node->proc(node->data);
+
+	// NOTE: thread_pool_queue_push counts a dependent within the group before it can be stolen, and this
+	// task is only counted as finished once it returns, so the group cannot reach zero in between
+	for (TaskNode *dependent : node->dependents) {
+		task_node_release(current_thread->pool, dependent);
+	}
+	return 0;
+}
+
+gb_internal void thread_pool_start_task_node(ThreadPool *pool, TaskNode *node) {
+	task_node_release(pool, node);
+}
+
 gb_internal THREAD_PROC(thread_pool_thread_proc) {
 	WorkerTask task;
 	current_thread = thread;
@@ -209,8 +468,7 @@ gb_internal THREAD_PROC(thread_pool_thread_proc) {
 		i32 state;
 
 		while (!thread_pool_queue_take(current_thread, &task)) {
-			task.do_work(task.data);
-			pool->tasks_left.fetch_sub(1, std::memory_order_release);
+			thread_pool_do_task(pool, &task);
 
 			finished_tasks += 1;
 		}
@@ -218,26 +476,38 @@ gb_internal THREAD_PROC(thread_pool_thread_proc) {
 			futex_signal(&pool->tasks_left);
 		}
 
+		if (pool->external_count.load(std::memory_order_acquire) != 0 && thread_pool_external_take(pool, &task)) {
+			thread_pool_do_task(pool, &task);
+			if (pool->tasks_left.load(std::memory_order_acquire) == 0) {
+				futex_signal(&pool->tasks_left);
+			}
+			continue;
+		}
+
 		// If there's still work somewhere and we don't have it, steal it
 		if (pool->tasks_left.load(std::memory_order_acquire)) {
-			usize idx = cast(usize)current_thread->idx;
+			usize idx = thread_pool_random_victim(pool);
 			for_array(i, pool->threads) {
 				if (pool->tasks_left.load(std::memory_order_acquire) == 0) {
 					break;
 				}
 
 				idx = (idx + 1) % cast(usize)pool->threads.count;
+				if (idx == cast(usize)current_thread->idx) {
+					continue;
+				}
 
 				Thread *thread = &pool->threads.data[idx];
 				WorkerTask task;
 
+				current_thread->stats.steals_attempted += 1;
 				GrabState ret = thread_pool_queue_steal(thread, &task);
 				switch (ret) {
 				case Grab_Empty:
 					continue;
 				case Grab_Success:
-					task.do_work(task.data);
-					pool->tasks_left.fetch_sub(1, std::memory_order_release);
+					current_thread->stats.steals_succeeded += 1;
+					thread_pool_do_task(pool, &task);
 
 					if (pool->tasks_left.load(std::memory_order_acquire) == 0) {
 						futex_signal(&pool->tasks_left);
@@ -250,10 +520,19 @@ gb_internal THREAD_PROC(thread_pool_thread_proc) {
 			}
 		}
 
+		if (thread_pool_spin_for_tasks(pool)) {
+			continue;
+		}
+
 		// if we've done all our work, and there's nothing to steal, go to sleep
 		pool->tasks_available.store(Someone_Waiting);
 		if (!pool->running) { break; }
-		futex_wait(&pool->tasks_available, Someone_Waiting);
+		{
+			f64 park_start = gb_time_now();
+			futex_wait(&pool->tasks_available, Someone_Waiting);
+			current_thread->stats.time_parked += gb_time_now() - park_start;
+			current_thread->stats.park_count  += 1;
+		}
 
 		main_loop_continue:;
 	}
@@ -36,14 +36,16 @@ struct ThreadPool;
 struct Parker;
 
 #define THREAD_PROC(name) isize name(struct Thread *thread)
+typedef THREAD_PROC(ThreadProc);
 gb_internal THREAD_PROC(thread_pool_thread_proc);
 
 #define WORKER_TASK_PROC(name) isize name(void *data)
 typedef WORKER_TASK_PROC(WorkerTaskProc);
 
 typedef struct WorkerTask {
-	WorkerTaskProc *do_work;
-	void           *data;
+	WorkerTaskProc   *do_work;
+	void             *data;
+	struct TaskGroup *group;
 } WorkerTask;
 
 typedef struct TaskRingBuffer {
@@ -58,6 +60,14 @@ typedef struct TaskQueue {
 	std::atomic<TaskRingBuffer *> ring;
 } TaskQueue;
 
+struct ThreadPoolWorkerStats {
+	u64 tasks_executed;
+	u64 steals_attempted;
+	u64 steals_succeeded;
+	u64 park_count;
+	f64 time_parked; // seconds
+};
+
 struct Thread {
 #if defined(GB_SYSTEM_WINDOWS)
 	void *win32_handle;
@@ -69,7 +79,13 @@ struct Thread {
 	isize stack_size;
 
 	struct TaskQueue   queue;
-	struct ThreadPool *pool;
+	struct ThreadPool *pool; // nullptr for the threads outside of any pool (e.g. the parser's I/O threads)
+	ThreadProc *       proc;
+
+	// NOTE: only ever written by the thread itself
+	u64                   rng_state;  // victim selection
+	isize                 spin_limit; // adaptive spinning before parking
+	ThreadPoolWorkerStats stats;
 
 	struct Arena *permanent_arena;
 	struct Arena *temporary_arena;
@@ -112,7 +128,7 @@ gb_internal void unpark_all(Parker *p);
 gb_internal u32  thread_current_id(void);
 
 gb_internal void thread_init                     (ThreadPool *pool, Thread *t, isize idx);
-gb_internal void thread_init_and_start           (ThreadPool *pool, Thread *t, isize idx);
+gb_internal void thread_init_and_start           (ThreadPool *pool, Thread *t, isize idx, ThreadProc *proc = thread_pool_thread_proc);
 gb_internal void thread_join_and_destroy(Thread *t);
 gb_internal void thread_set_name        (Thread *t, char const *name);
 
@@ -593,7 +609,7 @@ gb_internal gb_inline void yield(void) {
 #if defined(GB_SYSTEM_WINDOWS)
 gb_internal DWORD __stdcall internal_thread_proc(void *arg) {
 	Thread *t = cast(Thread *)arg;
-	thread_pool_thread_proc(t);
+	t->proc(t);
 	return 0;
 }
 #else
@@ -606,7 +622,7 @@ gb_internal void *internal_thread_proc(void *arg) {
 #endif
 
 	Thread *t = cast(Thread *)arg;
-	thread_pool_thread_proc(t);
+	t->proc(t);
 	return NULL;
 }
 #endif
@@ -641,8 +657,9 @@ gb_internal void thread_init(ThreadPool *pool, Thread *t, isize idx) {
 	thread_init_arenas(t);
 }
 
-gb_internal void thread_init_and_start(ThreadPool *pool, Thread *t, isize idx) {
+gb_internal void thread_init_and_start(ThreadPool *pool, Thread *t, isize idx, ThreadProc *proc) {
 	thread_init(pool, t, idx);
+	t->proc = proc;
 	isize stack_size = 1 * 1024 * 1024; // 1 MiB (LLVM takes a lot of stack space)
 
 #if defined(GB_SYSTEM_WINDOWS)
@@ -1,7 +1,18 @@
+// NOTE: A snapshot of the memory usage of the process, where -1 means it is unknown on this platform
+struct MemoryUsage {
+	isize arena_committed[ThreadArena_COUNT];
+	isize static_arena_committed;
+	isize heap_allocated;
+	isize other_malloc; // malloc-ed outside of `heap_allocator`, mostly by LLVM
+	isize peak_rss;
+	isize huge_pages; // backed by huge pages, only known with ODIN_HUGE_PAGES
+};
+
 struct TimeStamp {
-	u64    start;
-	u64    finish;
-	String label;
+	u64         start;
+	u64         finish;
+	String      label;
+	MemoryUsage memory; // at `finish`, when `Timings.record_memory` is set
 };
 
 struct Timings {
@@ -9,6 +20,7 @@ struct Timings {
 	Array<TimeStamp> sections;
 	u64              freq;
 	f64              total_time_seconds;
+	bool             record_memory;
 };
 
 
@@ -55,6 +67,10 @@ gb_internal u64 osx_time_stamp__freq(void) {
 #elif defined(GB_SYSTEM_UNIX)
 
 #include <time.h>
+#include <sys/resource.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 gb_internal u64 unix_time_stamp_time_now(void) {
 	struct timespec ts;
@@ -105,6 +121,66 @@ gb_internal u64 time_stamp__freq(void) {
 #endif
 }
 
+gb_internal MemoryUsage memory_usage_now(void) {
+	MemoryUsage m = {};
+	for (isize i = 0; i < cast(isize)ThreadArena_COUNT; i++) {
+		m.arena_committed[i] = thread_arena_memory_committed[i].load(std::memory_order_relaxed);
+	}
+	m.static_arena_committed = static_arena_memory_committed.load(std::memory_order_relaxed);
+	m.other_malloc = -1;
+	m.peak_rss     = -1;
+	m.huge_pages   = -1;
+
+#if defined(GB_SYSTEM_LINUX)
+	m.heap_allocated = total_heap_memory_allocated.load(std::memory_order_relaxed);
+#else
+	m.heap_allocated = -1; // NOTE: only tracked by the Linux `heap_allocator_proc`
+#endif
+
+#if defined(GB_SYSTEM_WINDOWS)
+	PROCESS_MEMORY_COUNTERS p = {sizeof(p)};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &p, sizeof(p))) {
+		m.peak_rss = cast(isize)p.PeakWorkingSetSize;
+	}
+#elif defined(GB_SYSTEM_UNIX) || defined(GB_SYSTEM_OSX)
+	struct rusage usage = {};
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+	#if defined(GB_SYSTEM_OSX)
+		m.peak_rss = cast(isize)usage.ru_maxrss; // NOTE: in bytes on Darwin
+	#else
+		m.peak_rss = cast(isize)usage.ru_maxrss * 1024;
+	#endif
+	}
+#endif
+
+#if defined(GB_SYSTEM_LINUX) && defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	// NOTE: LLVM does not report its memory usage, but it allocates through malloc
+	struct mallinfo2 info = mallinfo2();
+	m.other_malloc = gb_max(cast(isize)(info.uordblks + info.hblkhd) - m.heap_allocated, 0);
+#endif
+
+#if defined(GB_SYSTEM_LINUX)
+	if (virtual_memory_huge_pages != VirtualMemoryHugePages_None) {
+		// NOTE: whether the kernel actually backed the memory with huge pages is only known from the mappings
+		FILE *f = fopen("/proc/self/smaps_rollup", "r");
+		if (f != nullptr) {
+			m.huge_pages = 0;
+			char line[256];
+			while (fgets(line, gb_size_of(line), f) != nullptr) {
+				long long kib = 0;
+				if (sscanf(line, "AnonHugePages: %lld kB", &kib) == 1 ||
+				    sscanf(line, "Private_Hugetlb: %lld kB", &kib) == 1 ||
+				    sscanf(line, "Shared_Hugetlb: %lld kB", &kib) == 1) {
+					m.huge_pages += cast(isize)kib * 1024;
+				}
+			}
+			fclose(f);
+		}
+	}
+#endif
+	return m;
+}
+
 gb_internal TimeStamp make_time_stamp(String const &label) {
 	TimeStamp ts = {0};
 	ts.start = time_stamp_time_now();
@@ -124,7 +200,19 @@ gb_internal void timings_destroy(Timings *t) {
 
 gb_internal void timings__stop_current_section(Timings *t) {
 	if (t->sections.count > 0) {
-		t->sections[t->sections.count-1].finish = time_stamp_time_now();
+		TimeStamp *ts = &t->sections[t->sections.count-1];
+		ts->finish = time_stamp_time_now();
+		if (t->record_memory) {
+			ts->memory = memory_usage_now();
+		}
+	}
+}
+
+gb_internal void timings__stop_total(Timings *t) {
+	timings__stop_current_section(t);
+	t->total.finish = time_stamp_time_now();
+	if (t->record_memory) {
+		t->total.memory = memory_usage_now();
 	}
 }
 
@@ -148,8 +236,8 @@ gb_internal f64 time_stamp_as_us(TimeStamp const &ts, u64 freq) {
 
 #define MAIN_TIME_SECTION(str)               do { debugf("[Section] %s\n", str);                                      timings_start_section(&global_timings, str_lit(str));                } while (0)
 #define MAIN_TIME_SECTION_WITH_LEN(str, len) do { debugf("[Section] %s\n", str);                                      timings_start_section(&global_timings, make_string((u8 *)str, len)); } while (0)
-#define TIME_SECTION(str)                    do { debugf("[Section] %s\n", str); if (build_context.show_more_timings) timings_start_section(&global_timings, str_lit(str));                } while (0)
-#define TIME_SECTION_WITH_LEN(str, len)      do { debugf("[Section] %s\n", str); if (build_context.show_more_timings) timings_start_section(&global_timings, make_string((u8 *)str, len)); } while (0)
+#define TIME_SECTION(str)                    do { debugf("[Section] %s\n", str); if (build_context.show_more_timings || build_context.show_memory) timings_start_section(&global_timings, str_lit(str));                } while (0)
+#define TIME_SECTION_WITH_LEN(str, len)      do { debugf("[Section] %s\n", str); if (build_context.show_more_timings || build_context.show_memory) timings_start_section(&global_timings, make_string((u8 *)str, len)); } while (0)
 
 
 enum TimingUnit {
@@ -171,6 +259,66 @@ gb_internal f64 time_stamp(TimeStamp const &ts, u64 freq, TimingUnit unit) {
 	}
 }
 
+gb_internal void timings_print_memory_line(String const &label, isize max_len, char const *spaces, MemoryUsage const &m) {
+	isize values[ThreadArena_COUNT+5] = {};
+	isize n = 0;
+	for (isize i = 0; i < cast(isize)ThreadArena_COUNT; i++) {
+		values[n++] = m.arena_committed[i];
+	}
+	values[n++] = m.static_arena_committed;
+	values[n++] = m.heap_allocated;
+	values[n++] = m.other_malloc;
+	values[n++] = m.peak_rss;
+	values[n++] = m.huge_pages;
+
+	gb_printf_err("%.*s%.*s -", LIT(label), cast(int)(max_len-label.len), spaces);
+	for (isize i = 0; i < n; i++) {
+		if (values[i] < 0) {
+			gb_printf_err(" %11s", "-");
+		} else if (values[i] == 0) {
+			gb_printf_err(" %11s", "0.00"); // NOTE: gb_printf prints a zero float as "0"
+		} else {
+			gb_printf_err(" %11.2f", cast(f64)values[i] / cast(f64)(1024ll*1024ll));
+		}
+	}
+	gb_printf_err("\n");
+}
+
+// NOTE: The memory usage at the end of each section, in MiB
+gb_internal void timings_print_memory(Timings *t, isize max_len) {
+	isize const SPACES_LEN = 256;
+	char SPACES[SPACES_LEN+1] = {0};
+	gb_memset(SPACES, ' ', SPACES_LEN);
+
+	String title = str_lit("Memory (MiB)");
+	max_len = gb_max(max_len, title.len);
+	GB_ASSERT(max_len <= SPACES_LEN);
+
+	gb_printf_err("\n%.*s%.*s -", LIT(title), cast(int)(max_len-title.len), SPACES);
+	for (isize i = 0; i < cast(isize)ThreadArena_COUNT; i++) {
+		gb_printf_err(" %11s", thread_arena_kind_strings[i]);
+	}
+	gb_printf_err(" %11s %11s %11s %11s %11s\n", "Interned", "Heap", "Malloc", "Peak RSS", "Huge Pages");
+
+	timings_print_memory_line(t->total.label, max_len, SPACES, t->total.memory);
+	for (TimeStamp const &ts : t->sections) {
+		timings_print_memory_line(ts.label, max_len, SPACES, ts.memory);
+	}
+
+	if (virtual_memory_huge_pages != VirtualMemoryHugePages_None) {
+		isize hugetlb = virtual_memory_huge_page_reservations_hugetlb.load();
+		gb_printf_err("\nHuge pages (%s, %td KiB): %td of %td arena reservations were advised or mapped",
+		              virtual_memory_huge_pages_strings[virtual_memory_huge_pages],
+		              virtual_memory_huge_page_size/1024,
+		              virtual_memory_huge_page_reservations_obtained.load(),
+		              virtual_memory_huge_page_reservations.load());
+		if (virtual_memory_huge_pages == VirtualMemoryHugePages_HugeTLB) {
+			gb_printf_err(", %td of them from the pool of explicit huge pages", hugetlb);
+		}
+		gb_printf_err("\n");
+	}
+}
+
 gb_internal void timings_print_all(Timings *t, TimingUnit unit = TimingUnit_Millisecond, bool timings_are_finalized = false) {
 	isize const SPACES_LEN = 256;
 	char SPACES[SPACES_LEN+1] = {0};
@@ -181,8 +329,7 @@ gb_internal void timings_print_all(Timings *t, TimingUnit unit = TimingUnit_Mill
 		or just one of them, we only need to stop the clock once.
 	*/
 	if (!timings_are_finalized) {
-		timings__stop_current_section(t);
-		t->total.finish = time_stamp_time_now();
+		timings__stop_total(t);
 	}
 
 	isize max_len = gb_min(36, t->total.label.len);
@@ -214,4 +361,8 @@ gb_internal void timings_print_all(Timings *t, TimingUnit unit = TimingUnit_Mill
 		          timing_unit_strings[unit],
 		          100.0*section_time/total_time);
 	}
+
+	if (t->record_memory) {
+		timings_print_memory(t, max_len);
+	}
 }
\ No newline at end of file
@@ -200,22 +200,43 @@ gb_global BlockingMutex           global_files_mutex;
 gb_internal String   get_file_path_string(i32 index);
 gb_internal struct AstFile *thread_safe_get_ast_file_from_id(i32 index);
 
+// NOTE: The line and column of a position are only found when they are needed (e.g. for an error or the
+// debug information) with `token_pos_line_column`, from the table of the start of each line of the file
 struct TokenPos {
-	i32 file_id;
-	i32 offset; // starting at 0
-	i32 line;   // starting at 1
+	i32 file_id; // 0 when there is no position, or when only the line is known (see `token_pos_line_only`)
+	i32 offset;  // starting at 0
+};
+
+struct TokenLineColumn {
+	i32 line;   // starting at 1, 0 when there is no position
 	i32 column; // starting at 1
 };
 
+gb_internal TokenLineColumn token_pos_line_column(TokenPos const &pos); // NOTE: defined in parser.cpp
+
+gb_internal gb_inline bool token_pos_is_valid(TokenPos const &pos) {
+	return pos.file_id != 0;
+}
+
+// NOTE: A position within an unknown file, which only has a line (e.g. an error about a package without any files).
+// The line is stored negated in the offset, so that it cannot be mistaken for an offset within a file.
+gb_internal gb_inline TokenPos token_pos_line_only(i32 line) {
+	TokenPos pos = {};
+	pos.offset = -line;
+	return pos;
+}
+
+// NOTE: Whether an error at `pos` is printed with a position
+gb_internal gb_inline bool token_pos_has_line(TokenPos const &pos) {
+	return pos.file_id != 0 || pos.offset < 0;
+}
+
 gb_internal i32 token_pos_cmp(TokenPos const &a, TokenPos const &b) {
 	if (a.offset != b.offset) {
 		return (a.offset < b.offset) ? -1 : +1;
 	}
-	if (a.line != b.line) {
-		return (a.line < b.line) ? -1 : +1;
-	}
-	if (a.column != b.column) {
-		return (a.column < b.column) ? -1 : +1;
+	if (a.file_id == b.file_id) {
+		return 0;
 	}
 	return string_compare(get_file_path_string(a.file_id), get_file_path_string(b.file_id));
 }
@@ -229,7 +250,6 @@ gb_internal gb_inline bool operator>=(TokenPos const &a, TokenPos const &b) { re
 
 
 TokenPos token_pos_add_column(TokenPos pos) {
-	pos.column += 1;
 	pos.offset += 1;
 	return pos;
 }
@@ -304,7 +324,8 @@ struct Tokenizer {
 	Rune  curr_rune;   // current character
 	u8 *  curr;        // character pos
 	u8 *  read_curr;   // pos from start
-	i32   column_minus_one;
+
+	u32 * line_offsets; // the offset of the start of each line, see `tokenizer_init_lines`
 	i32   line_count;
 
 	i32 error_count;
@@ -317,15 +338,9 @@ struct Tokenizer {
 
 gb_internal void tokenizer_err(Tokenizer *t, char const *msg, ...) {
 	va_list va;
-	i32 column = t->column_minus_one+1;
-	if (column < 1) {
-		column = 1;
-	}
 	TokenPos pos = {};
 	pos.file_id = t->curr_file_id;
-	pos.line = t->line_count;
-	pos.column = cast(i32)column;
-	pos.offset = cast(i32)(t->read_curr - t->start);
+	pos.offset = cast(i32)(t->curr - t->start);
 
 	va_start(va, msg);
 	syntax_error_va(pos, {}, msg, va);
@@ -336,11 +351,6 @@ gb_internal void tokenizer_err(Tokenizer *t, char const *msg, ...) {
 
 gb_internal void tokenizer_err(Tokenizer *t, TokenPos const &pos, char const *msg, ...) {
 	va_list va;
-	i32 column = t->column_minus_one+1;
-	if (column < 1) {
-		column = 1;
-	}
-
 	va_start(va, msg);
 	syntax_error_va(pos, {}, msg, va);
 	va_end(va);
@@ -349,10 +359,6 @@ gb_internal void tokenizer_err(Tokenizer *t, TokenPos const &pos, char const *ms
 }
 
 gb_internal void advance_to_next_rune(Tokenizer *t) {
-	if (t->curr_rune == '\n') {
-		t->column_minus_one = -1;
-		t->line_count++;
-	}
 	if (t->read_curr < t->end) {
 		t->curr = t->read_curr;
 		Rune rune = *t->read_curr;
@@ -371,21 +377,267 @@ gb_internal void advance_to_next_rune(Tokenizer *t) {
 			t->read_curr++;
 		}
 		t->curr_rune = rune;
-		t->column_minus_one++;
 	} else {
 		t->curr = t->end;
 		t->curr_rune = GB_RUNE_EOF;
 	}
 }
 
+// NOTE: The runs of ASCII bytes which the tokenizer skips over: identifiers, whitespace, and the bodies of
+// comments and strings. NUL and non-ASCII bytes always end a run, so that `advance_to_next_rune` reports
+// the illegal characters and decodes the UTF-8 as before.
+enum TokenizerScan {
+	TokenizerScan_Ident,             // [A-Za-z0-9_]
+	TokenizerScan_Whitespace,        // ' ', '\t', '\r'
+	TokenizerScan_WhitespaceNewline, // ' ', '\t', '\r', '\n'
+	TokenizerScan_Line,              // anything but '\n'
+	TokenizerScan_String,            // anything but '"', '\\', '\n'
+	TokenizerScan_RawString,         // anything but '`'
+	TokenizerScan_BlockComment,      // anything but '/', '*'
+};
+
+gb_internal gb_inline bool tokenizer__scan_match(u8 c, TokenizerScan scan) {
+	switch (scan) {
+	case TokenizerScan_Ident:
+		return gb_char_is_alphanumeric(cast(char)c) || c == '_';
+	case TokenizerScan_Whitespace:
+		return c == ' ' || c == '\t' || c == '\r';
+	case TokenizerScan_WhitespaceNewline:
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+	}
+	if (c == 0 || c >= 0x80) {
+		return false;
+	}
+	switch (scan) {
+	case TokenizerScan_Line:         return c != '\n';
+	case TokenizerScan_String:       return c != '"' && c != '\\' && c != '\n';
+	case TokenizerScan_RawString:    return c != '`';
+	case TokenizerScan_BlockComment: return c != '/' && c != '*';
+	}
+	return false;
+}
+
+#if defined(GB_CPU_X86)
+// NOTE: SSE2 only has signed byte compares, which conveniently treat the non-ASCII bytes as negative
+gb_internal gb_inline __m128i tokenizer__scan_match_sse2(__m128i c, TokenizerScan scan) {
+	switch (scan) {
+	case TokenizerScan_Ident: {
+		__m128i lower  = _mm_or_si128(c, _mm_set1_epi8(0x20));
+		__m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a'-1)), _mm_cmpgt_epi8(_mm_set1_epi8('z'+1), lower));
+		__m128i digit  = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0'-1)), _mm_cmpgt_epi8(_mm_set1_epi8('9'+1), c));
+		return _mm_or_si128(_mm_or_si128(letter, digit), _mm_cmpeq_epi8(c, _mm_set1_epi8('_')));
+	}
+	case TokenizerScan_Whitespace:
+	case TokenizerScan_WhitespaceNewline: {
+		__m128i m = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(c, _mm_set1_epi8('\t')));
+		m = _mm_or_si128(m, _mm_cmpeq_epi8(c, _mm_set1_epi8('\r')));
+		if (scan == TokenizerScan_WhitespaceNewline) {
+			m = _mm_or_si128(m, _mm_cmpeq_epi8(c, _mm_set1_epi8('\n')));
+		}
+		return m;
+	}
+	}
+
+	__m128i stop = _mm_setzero_si128();
+	switch (scan) {
+	case TokenizerScan_Line:
+		stop = _mm_cmpeq_epi8(c, _mm_set1_epi8('\n'));
+		break;
+	case TokenizerScan_String:
+		stop = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('"')), _mm_cmpeq_epi8(c, _mm_set1_epi8('\\')));
+		stop = _mm_or_si128(stop, _mm_cmpeq_epi8(c, _mm_set1_epi8('\n')));
+		break;
+	case TokenizerScan_RawString:
+		stop = _mm_cmpeq_epi8(c, _mm_set1_epi8('`'));
+		break;
+	case TokenizerScan_BlockComment:
+		stop = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('/')), _mm_cmpeq_epi8(c, _mm_set1_epi8('*')));
+		break;
+	}
+	__m128i ascii = _mm_cmpgt_epi8(c, _mm_setzero_si128()); // NOTE: neither NUL nor non-ASCII
+	return _mm_andnot_si128(stop, ascii);
+}
+#elif defined(GB_CPU_ARM) && defined(__ARM_NEON)
+gb_internal gb_inline uint8x16_t tokenizer__scan_match_neon(uint8x16_t c, TokenizerScan scan) {
+	switch (scan) {
+	case TokenizerScan_Ident: {
+		uint8x16_t lower  = vorrq_u8(c, vdupq_n_u8(0x20));
+		uint8x16_t letter = vandq_u8(vcgeq_u8(lower, vdupq_n_u8('a')), vcleq_u8(lower, vdupq_n_u8('z')));
+		uint8x16_t digit  = vandq_u8(vcgeq_u8(c, vdupq_n_u8('0')), vcleq_u8(c, vdupq_n_u8('9')));
+		return vorrq_u8(vorrq_u8(letter, digit), vceqq_u8(c, vdupq_n_u8('_')));
+	}
+	case TokenizerScan_Whitespace:
+	case TokenizerScan_WhitespaceNewline: {
+		uint8x16_t m = vorrq_u8(vceqq_u8(c, vdupq_n_u8(' ')), vceqq_u8(c, vdupq_n_u8('\t')));
+		m = vorrq_u8(m, vceqq_u8(c, vdupq_n_u8('\r')));
+		if (scan == TokenizerScan_WhitespaceNewline) {
+			m = vorrq_u8(m, vceqq_u8(c, vdupq_n_u8('\n')));
+		}
+		return m;
+	}
+	}
+
+	uint8x16_t stop = vdupq_n_u8(0);
+	switch (scan) {
+	case TokenizerScan_Line:
+		stop = vceqq_u8(c, vdupq_n_u8('\n'));
+		break;
+	case TokenizerScan_String:
+		stop = vorrq_u8(vceqq_u8(c, vdupq_n_u8('"')), vceqq_u8(c, vdupq_n_u8('\\')));
+		stop = vorrq_u8(stop, vceqq_u8(c, vdupq_n_u8('\n')));
+		break;
+	case TokenizerScan_RawString:
+		stop = vceqq_u8(c, vdupq_n_u8('`'));
+		break;
+	case TokenizerScan_BlockComment:
+		stop = vorrq_u8(vceqq_u8(c, vdupq_n_u8('/')), vceqq_u8(c, vdupq_n_u8('*')));
+		break;
+	}
+	uint8x16_t ascii = vandq_u8(vtstq_u8(c, c), vcltq_u8(c, vdupq_n_u8(0x80))); // NOTE: neither NUL nor non-ASCII
+	return vbicq_u8(ascii, stop);
+}
+#endif
+
+// NOTE: Returns the first byte from `p` which does not match `scan`, 16 bytes at a time where SSE2 or NEON
+// is available
+gb_internal u8 *tokenizer__scan(u8 *p, u8 *end, TokenizerScan scan) {
+#if defined(GB_CPU_X86)
+	for (; end-p >= 16; p += 16) {
+		__m128i chunk = _mm_loadu_si128(cast(__m128i const *)p);
+		u32 mask = ~cast(u32)_mm_movemask_epi8(tokenizer__scan_match_sse2(chunk, scan)) & 0xffff;
+		if (mask != 0) {
+			return p + count_trailing_zeros(mask);
+		}
+	}
+#elif defined(GB_CPU_ARM) && defined(__ARM_NEON)
+	for (; end-p >= 16; p += 16) {
+		uint8x16_t stop = vmvnq_u8(tokenizer__scan_match_neon(vld1q_u8(p), scan));
+		// NOTE: narrows each byte of the mask to a nibble, as NEON has no movemask
+		u64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(stop), 4)), 0);
+		if (mask != 0) {
+			return p + (count_trailing_zeros(mask) >> 2);
+		}
+	}
+#endif
+	for (; p < end; p++) {
+		if (!tokenizer__scan_match(*p, scan)) {
+			break;
+		}
+	}
+	return p;
+}
+
+// NOTE: Skips the run of runes from the current one which match `scan`, which may be empty
+gb_internal gb_inline void tokenizer_skip_run(Tokenizer *t, TokenizerScan scan) {
+	u8 *p = tokenizer__scan(t->curr, t->end, scan);
+	if (p != t->curr) {
+		t->read_curr = p;
+		advance_to_next_rune(t);
+	}
+}
+
+// NOTE: Finds the start of every line up front, 16 bytes at a time where SSE2 is available, so that the
+// tokenizer does not need to track the line and column of every rune
+gb_internal isize tokenizer__find_newlines(u8 const *data, isize len, u32 *line_offsets) {
+	isize count = 0;
+	isize i = 0;
+#if defined(GB_CPU_X86)
+	__m128i const newline = _mm_set1_epi8('\n');
+	for (; i+16 <= len; i += 16) {
+		__m128i chunk = _mm_loadu_si128(cast(__m128i const *)(data+i));
+		u32 mask = cast(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+		if (line_offsets == nullptr) {
+			count += bit_set_count(mask);
+			continue;
+		}
+		while (mask != 0) {
+			i32 bit = count_trailing_zeros(mask);
+			line_offsets[count++] = cast(u32)(i + bit + 1);
+			mask &= mask-1;
+		}
+	}
+#endif
+	for (; i < len; i++) {
+		if (data[i] == '\n') {
+			if (line_offsets != nullptr) {
+				line_offsets[count] = cast(u32)(i+1);
+			}
+			count += 1;
+		}
+	}
+	return count;
+}
+
+gb_internal void tokenizer_init_lines(Tokenizer *t) {
+	isize len = t->end - t->start;
+	isize newline_count = tokenizer__find_newlines(t->start, len, nullptr);
+	// NOTE: kept for the whole compilation, even once the AST of the file has been released
+	t->line_offsets = permanent_alloc_array<u32>(newline_count+1);
+	t->line_offsets[0] = 0;
+	tokenizer__find_newlines(t->start, len, t->line_offsets+1);
+	t->line_count = cast(i32)(newline_count+1);
+}
+
+gb_internal i32 tokenizer_line(Tokenizer const *t, isize offset) {
+	if (t->line_count <= 0) {
+		return 0;
+	}
+	isize lo = 0;
+	isize hi = t->line_count;
+	while (hi - lo > 1) {
+		isize mid = lo + (hi-lo)/2;
+		if (t->line_offsets[mid] <= offset) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+	return cast(i32)(lo+1);
+}
+
+gb_internal TokenLineColumn tokenizer_line_column(Tokenizer const *t, isize offset) {
+	TokenLineColumn lc = {};
+	lc.line = tokenizer_line(t, offset);
+	if (lc.line == 0) {
+		return lc;
+	}
+
+	// NOTE: the columns are counted in runes, and the start of each rune is any byte which is not a continuation byte
+	isize len = t->end - t->start;
+	u8 const *end = t->start + gb_clamp(offset, 0, len);
+	lc.column = 1;
+	for (u8 const *ptr = t->start + t->line_offsets[lc.line-1]; ptr < end; ptr++) {
+		lc.column += (*ptr & 0xc0) != 0x80;
+	}
+	if (offset >= len && len > 0) {
+		// NOTE: the end of the file is at the column of the last rune
+		lc.column -= 1;
+	}
+	return lc;
+}
+
+// NOTE: The inverse of `tokenizer_line_column`, for positions which only have a line and a column
+gb_internal i32 tokenizer_offset_from_line_column(Tokenizer const *t, i32 line, i32 column) {
+	if (line <= 0 || line > t->line_count) {
+		return 0;
+	}
+	u8 const *ptr = t->start + t->line_offsets[line-1];
+	for (i32 i = 1; i < column && ptr < t->end && *ptr != '\n'; i++) {
+		ptr += 1;
+		while (ptr < t->end && (*ptr & 0xc0) == 0x80) {
+			ptr += 1;
+		}
+	}
+	return cast(i32)(ptr - t->start);
+}
+
 gb_internal void init_tokenizer_with_data(Tokenizer *t, String const &fullpath, void const *data, isize size) {
 	t->fullpath = fullpath;
-	t->column_minus_one = -1;
-	t->line_count = 1;
 
 	t->start = cast(u8 *)data;
 	t->read_curr = t->curr = t->start;
 	t->end = t->start + size;
+	tokenizer_init_lines(t);
 
 	advance_to_next_rune(t);
 	if (t->curr_rune == GB_RUNE_BOM) {
@@ -393,6 +645,13 @@ gb_internal void init_tokenizer_with_data(Tokenizer *t, String const &fullpath,
 	}
 }
 
+// NOTE: Continues from the start of a token at `offset`, e.g. to tokenize a part of the file again
+gb_internal void tokenizer_seek(Tokenizer *t, i32 offset) {
+	t->read_curr = t->start + offset;
+	t->insert_semicolon = false;
+	advance_to_next_rune(t);
+}
+
 gb_global TokenizerInitError loaded_file_error_map_to_tokenizer[LoadedFile_COUNT] = {
 	TokenizerInit_None,         /*LoadedFile_None*/
 	TokenizerInit_Empty,        /*LoadedFile_Empty*/
@@ -402,27 +661,33 @@ gb_global TokenizerInitError loaded_file_error_map_to_tokenizer[LoadedFile_COUNT
 	TokenizerInit_Permission,   /*LoadedFile_Permission*/
 };
 
-gb_internal TokenizerInitError init_tokenizer_from_fullpath(Tokenizer *t, String const &fullpath, bool copy_file_contents) {
-	LoadedFileError file_err = load_file_32(
-		alloc_cstring(temporary_allocator(), fullpath), 
-		&t->loaded_file,
-		copy_file_contents
-	);
-	
+// NOTE: `t->loaded_file` must have already been loaded, with the result of `file_err`
+gb_internal TokenizerInitError init_tokenizer_from_loaded_file(Tokenizer *t, String const &fullpath, LoadedFileError file_err) {
 	TokenizerInitError err = loaded_file_error_map_to_tokenizer[file_err];
 	switch (file_err) {
 	case LoadedFile_None:
-		init_tokenizer_with_data(t, fullpath, t->loaded_file.data, cast(isize)t->loaded_file.size);
+		init_tokenizer_with_data(t, fullpath, t->loaded_file.data, t->loaded_file.size);
 		break;
 	case LoadedFile_FileTooLarge:
 	case LoadedFile_Empty:
 		t->fullpath = fullpath;
-		t->line_count = 1;
+		tokenizer_init_lines(t);
 		break;
 	}	
 	return err;
 }
 
+gb_internal TokenizerInitError init_tokenizer_from_fullpath(Tokenizer *t, String const &fullpath, FileLoadMode load_mode) {
+	// NOTE: the sources are limited to 2 GiB, as the token positions are 32-bit offsets
+	LoadedFileError file_err = load_file(
+		alloc_cstring(temporary_allocator(), fullpath), 
+		&t->loaded_file,
+		load_mode,
+		I32_MAX
+	);
+	return init_tokenizer_from_loaded_file(t, fullpath, file_err);
+}
+
 gb_internal gb_inline i32 digit_value(Rune r) {
 	switch (r) {
 	case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
@@ -455,13 +720,10 @@ gb_internal void scan_number_to_token(Tokenizer *t, Token *token, bool seen_deci
 	token->kind = Token_Integer;
 	token->string = {t->curr, 1};
 	token->pos.file_id = t->curr_file_id;
-	token->pos.line = t->line_count;
-	token->pos.column = t->column_minus_one+1;
 
 	if (seen_decimal_point) {
 		token->string.text -= 1;
 		token->string.len  += 1;
-		token->pos.column -= 1;
 		token->kind = Token_Float;
 		scan_mantissa(t, 10, true);
 		goto exponent;
@@ -650,36 +912,18 @@ gb_internal bool scan_escape(Tokenizer *t) {
 
 
 gb_internal gb_inline void tokenizer_skip_line(Tokenizer *t) {
-	while (t->curr_rune != '\n' && t->curr_rune != GB_RUNE_EOF) {
+	for (;;) {
+		tokenizer_skip_run(t, TokenizerScan_Line);
+		if (t->curr_rune == '\n' || t->curr_rune == GB_RUNE_EOF) {
+			break;
+		}
 		advance_to_next_rune(t);
 	}
 }
 
 gb_internal gb_inline void tokenizer_skip_whitespace(Tokenizer *t, bool on_newline) {
-	if (on_newline) {
-		for (;;) {
-			switch (t->curr_rune) {
-			case ' ':
-			case '\t':
-			case '\r':
-				advance_to_next_rune(t);
-				continue;
-			}
-			break;
-		}
-	} else {
-		for (;;) {
-			switch (t->curr_rune) {
-			case '\n':
-			case ' ':
-			case '\t':
-			case '\r':
-				advance_to_next_rune(t);
-				continue;
-			}
-			break;
-		}
-	}
+	// NOTE: all of the whitespace is ASCII
+	tokenizer_skip_run(t, on_newline ? TokenizerScan_Whitespace : TokenizerScan_WhitespaceNewline);
 }
 
 gb_internal void tokenizer_get_token(Tokenizer *t, Token *token, int repeat=0) {
@@ -689,17 +933,19 @@ gb_internal void tokenizer_get_token(Tokenizer *t, Token *token, int repeat=0) {
 	token->string.text = t->curr;
 	token->string.len  = 1;
 	token->pos.file_id = t->curr_file_id;
-	token->pos.line = t->line_count;
 	token->pos.offset = cast(i32)(t->curr - t->start);
-	token->pos.column = t->column_minus_one+1;
 
 	TokenPos current_pos = token->pos;
 
 	Rune curr_rune = t->curr_rune;
 	if (rune_is_letter(curr_rune)) {
 		token->kind = Token_Ident;
-		while (rune_is_letter_or_digit(t->curr_rune)) {
-			advance_to_next_rune(t);
+		for (;;) {
+			tokenizer_skip_run(t, TokenizerScan_Ident);
+			if (!rune_is_letter_or_digit(t->curr_rune)) {
+				break;
+			}
+			advance_to_next_rune(t); // NOTE: a non-ASCII letter or digit
 		}
 
 		token->string.len = t->curr - token->string.text;
@@ -749,7 +995,7 @@ gb_internal void tokenizer_get_token(Tokenizer *t, Token *token, int repeat=0) {
 		case '\\':
 			t->insert_semicolon = false;
 			tokenizer_get_token(t, token);
-			if (token->pos.line == current_pos.line) {
+			if (gb_memchr(t->start + current_pos.offset, '\n', token->pos.offset - current_pos.offset) == nullptr) {
 				tokenizer_err(t, token_pos_add_column(current_pos), "Expected a newline after \\");
 			}
 			// NOTE(bill): tokenizer_get_token has been called already, return early
@@ -794,6 +1040,7 @@ gb_internal void tokenizer_get_token(Tokenizer *t, Token *token, int repeat=0) {
 			token->kind = Token_String;
 			if (curr_rune == '"') {
 				for (;;) {
+					tokenizer_skip_run(t, TokenizerScan_String);
 					Rune r = t->curr_rune;
 					if (r == '\n' || r < 0) {
 						tokenizer_err(t, "String literal not terminated");
@@ -809,6 +1056,7 @@ gb_internal void tokenizer_get_token(Tokenizer *t, Token *token, int repeat=0) {
 				}
 			} else {
 				for (;;) {
+					tokenizer_skip_run(t, TokenizerScan_RawString);
 					Rune r = t->curr_rune;
 					if (r < 0) {
 						tokenizer_err(t, "String literal not terminated");
@@ -972,6 +1220,7 @@ gb_internal void tokenizer_get_token(Tokenizer *t, Token *token, int repeat=0) {
 				token->kind = Token_Comment;
 				advance_to_next_rune(t);
 				for (isize comment_scope = 1; comment_scope > 0; /**/) {
+					tokenizer_skip_run(t, TokenizerScan_BlockComment);
 					if (t->curr_rune == GB_RUNE_EOF) {
 						tokenizer_err(t, "Multi-line comment not terminated");
 						break;
@@ -1130,3 +1379,213 @@ semicolon_check:;
 
 	return;
 }
+
+
+// NOTE: The tokens of a whole file, kept for the whole compilation, stored as a structure of arrays.
+// A token's string is always a slice of the file's source, so only the kind, the flags, the offset,
+// and the length are stored (10 bytes rather than 32). The tokens are rebuilt on demand with `token_list_get`.
+struct TokenList {
+	gbAllocator allocator;
+	isize       count;
+	isize       capacity;
+
+	u32 *offsets;
+	u32 *lengths; // 0 for a semicolon which was inserted at the end of the file, with a string of "\n"
+	u8 * kinds;
+	u8 * flags;
+
+	u8 const *source;
+	isize     source_len;
+	i32       file_id;
+};
+
+gb_internal void token_list__set_capacity(TokenList *l, isize capacity) {
+	// NOTE: a single allocation, with the 32-bit arrays first to keep them aligned
+	u8 *data = cast(u8 *)gb_alloc(l->allocator, capacity*(2*gb_size_of(u32) + 2));
+	u32 *offsets = cast(u32 *)data;
+	u32 *lengths = offsets + capacity;
+	u8 *kinds    = cast(u8 *)(lengths + capacity);
+	u8 *flags    = kinds + capacity;
+	if (l->count > 0) {
+		gb_memmove(offsets, l->offsets, l->count*gb_size_of(u32));
+		gb_memmove(lengths, l->lengths, l->count*gb_size_of(u32));
+		gb_memmove(kinds,   l->kinds,   l->count);
+		gb_memmove(flags,   l->flags,   l->count);
+	}
+	if (l->capacity > 0) {
+		gb_free(l->allocator, l->offsets);
+	}
+	l->offsets  = offsets;
+	l->lengths  = lengths;
+	l->kinds    = kinds;
+	l->flags    = flags;
+	l->capacity = capacity;
+}
+
+gb_internal void token_list_init(TokenList *l, gbAllocator allocator, Tokenizer const *t, isize capacity) {
+	*l = {};
+	l->allocator  = allocator;
+	l->source     = t->start;
+	l->source_len = t->end - t->start;
+	l->file_id    = t->curr_file_id;
+	if (capacity > 0) {
+		token_list__set_capacity(l, capacity);
+	}
+}
+
+gb_internal void token_list_add(TokenList *l, Token const &token) {
+	GB_STATIC_ASSERT(Token_Count <= 256);
+	if (l->count >= l->capacity) {
+		token_list__set_capacity(l, 2*l->capacity + 16);
+	}
+	isize i = l->count++;
+	l->offsets[i] = cast(u32)token.pos.offset;
+	l->kinds[i]   = cast(u8)token.kind;
+	l->flags[i]   = token.flags;
+	if (token.string.len == 0 || token.string.text == l->source + token.pos.offset) {
+		l->lengths[i] = cast(u32)token.string.len;
+	} else {
+		GB_ASSERT_MSG(token.kind == Token_Semicolon && token.string == "\n", "the strings of the tokens must be slices of the source");
+		if (token.pos.offset < l->source_len) {
+			GB_ASSERT(l->source[token.pos.offset] == '\n');
+			l->lengths[i] = 1;
+		} else {
+			l->lengths[i] = 0;
+		}
+	}
+}
+
+gb_internal gb_inline TokenKind token_list_kind(TokenList const *l, isize index) {
+	return cast(TokenKind)l->kinds[index];
+}
+
+gb_internal Token token_list_get(TokenList const *l, isize index) {
+	GB_ASSERT(0 <= index && index < l->count);
+	Token token = {};
+	token.kind  = cast(TokenKind)l->kinds[index];
+	token.flags = l->flags[index];
+	token.pos.file_id = l->file_id;
+	token.pos.offset  = cast(i32)l->offsets[index];
+	if (l->lengths[index] == 0 && token.kind == Token_Semicolon) {
+		token.string = str_lit("\n");
+	} else {
+		token.string = {cast(u8 *)l->source + l->offsets[index], cast(isize)l->lengths[index]};
+	}
+	return token;
+}
+
+gb_internal void token_list_free(TokenList *l) {
+	if (l->capacity > 0) {
+		gb_free(l->allocator, l->offsets);
+	}
+	*l = {};
+}
+
+
+// NOTE: The tokens of a file which is tokenized as it is parsed, rather than all at once into a `TokenList`.
+// Only the tokens from the current one to the furthest lookahead are kept, within a ring which only grows
+// beyond its initial size for a long run of comments within the lookahead.
+struct TokenStream {
+	Tokenizer * tokenizer;
+	gbAllocator allocator;
+	Token *     ring;
+	isize       capacity; // a power of two
+	isize       base;     // the index within the file of the oldest token in the ring
+	isize       count;
+
+	Token first;          // the first token of the file, even if it was a comment which was not kept
+	bool  keep_comments;
+	bool  done;           // the EOF token has been reached
+	bool  invalid;        // an invalid token was reached, which ends the stream as if it were the end of the file
+};
+
+gb_internal void token_stream__add(TokenStream *s, Token const &token) {
+	if (s->count == s->capacity) {
+		isize capacity = gb_max(2*s->capacity, 16);
+		Token *ring = gb_alloc_array(s->allocator, Token, capacity);
+		for (isize i = 0; i < s->count; i++) {
+			isize index = s->base + i;
+			ring[index & (capacity-1)] = s->ring[index & (s->capacity-1)];
+		}
+		if (s->ring != nullptr) {
+			gb_free(s->allocator, s->ring);
+		}
+		s->ring     = ring;
+		s->capacity = capacity;
+	}
+	s->ring[(s->base + s->count) & (s->capacity-1)] = token;
+	s->count += 1;
+}
+
+gb_internal bool token_stream__pull(TokenStream *s) {
+	if (s->done) {
+		return false;
+	}
+	Token token = {};
+	for (;;) {
+		tokenizer_get_token(s->tokenizer, &token);
+		if (s->base+s->count == 0 && s->first.kind == Token_Invalid) {
+			s->first = token;
+		}
+		if (token.kind != Token_Comment || s->keep_comments) {
+			break;
+		}
+	}
+	if (token.kind == Token_Invalid) {
+		// NOTE: reported as soon as it is reached, as when the whole file is tokenized before it is parsed,
+		// so that any error of the parser at the same position is merged into it
+		String filename = remove_directory_from_path(s->tokenizer->fullpath);
+		syntax_error(token.pos, "Failed to parse file: %.*s; invalid token found in file", LIT(filename));
+		s->invalid   = true;
+		token.kind   = Token_EOF;
+		token.string = {};
+	}
+	s->done = token.kind == Token_EOF;
+	token_stream__add(s, token);
+	return true;
+}
+
+gb_internal void token_stream_init(TokenStream *s, gbAllocator allocator, Tokenizer *t, bool keep_comments) {
+	*s = {};
+	s->tokenizer     = t;
+	s->allocator     = allocator;
+	s->keep_comments = keep_comments;
+	token_stream__pull(s);
+}
+
+// NOTE: Returns false for an index past the end of the file, the index must not be before one which was released
+gb_internal bool token_stream_get(TokenStream *s, isize index, Token *token) {
+	GB_ASSERT(index >= s->base);
+	while (index >= s->base + s->count) {
+		if (!token_stream__pull(s)) {
+			return false;
+		}
+	}
+	*token = s->ring[index & (s->capacity-1)];
+	return true;
+}
+
+// NOTE: Drops the tokens before `index`, which will never be asked for again
+gb_internal void token_stream_release(TokenStream *s, isize index) {
+	isize n = gb_min(index - s->base, s->count);
+	if (n > 0) {
+		s->base  += n;
+		s->count -= n;
+	}
+}
+
+gb_internal isize token_stream_total_count(TokenStream const *s) {
+	return s->base + s->count;
+}
+
+// NOTE: Ends the stream; only its total count of tokens and its first token are kept
+gb_internal void token_stream_free(TokenStream *s) {
+	if (s->ring != nullptr) {
+		gb_free(s->allocator, s->ring);
+	}
+	s->tokenizer = nullptr;
+	s->ring      = nullptr;
+	s->capacity  = 0;
+	s->base     += s->count;
+	s->count     = 0;
+}
@@ -1033,22 +1033,123 @@ gb_internal Type *alloc_type_generic(Scope *scope, i64 id, InternedString intern
 	return t;
 }
 
-gb_internal Type *alloc_type_pointer(Type *elem) {
-	Type *t = alloc_type(Type_Pointer);
-	t->Pointer.elem = elem;
+
+// NOTE: The unnamed pointer, slice, and array types are hash-consed, so that structurally identical types
+// share one `Type *`: identity checks mostly become pointer compares, and the cached size, alignment, and
+// canonical hash are computed once per distinct type. The table is never resized; lookups are lock-free
+// and insertions lock a stripe of the cells.
+enum {
+	TYPE_INTERN_CELL_WIDTH         = 7,
+	TYPE_INTERN_CELL_COUNT         = 1<<14,
+	TYPE_INTERN_MUTEX_STRIPE_COUNT = 64,
+};
+
+struct alignas(GB_CACHE_LINE_SIZE) TypeInternCell {
+	std::atomic<Type *>           types[TYPE_INTERN_CELL_WIDTH];
+	std::atomic<TypeInternCell *> next;
+};
+
+struct alignas(GB_CACHE_LINE_SIZE) TypeInternMutex {
+	BlockingMutex m;
+};
+
+gb_global TypeInternCell  type_intern_cells  [TYPE_INTERN_CELL_COUNT];
+gb_global TypeInternMutex type_intern_mutexes[TYPE_INTERN_MUTEX_STRIPE_COUNT];
+
+gb_internal bool type_intern_is_match(Type *t, TypeKind kind, Type *elem, i64 count) {
+	if (t->kind != kind) {
+		return false;
+	}
+	switch (kind) {
+	case Type_Pointer:      return t->Pointer.elem      == elem;
+	case Type_MultiPointer: return t->MultiPointer.elem == elem;
+	case Type_SoaPointer:   return t->SoaPointer.elem   == elem;
+	case Type_Slice:        return t->Slice.elem        == elem;
+	case Type_DynamicArray: return t->DynamicArray.elem == elem;
+	case Type_Array:        return t->Array.elem        == elem && t->Array.count == count;
+	}
+	GB_PANIC("Unhandled interned type kind %d", kind);
+	return false;
+}
+
+gb_internal Type *alloc_type_interned_internal(TypeKind kind, Type *elem, i64 count) {
+	Type *t = alloc_type(kind);
+	switch (kind) {
+	case Type_Pointer:      t->Pointer.elem      = elem; break;
+	case Type_MultiPointer: t->MultiPointer.elem = elem; break;
+	case Type_SoaPointer:   t->SoaPointer.elem   = elem; break;
+	case Type_Slice:        t->Slice.elem        = elem; break;
+	case Type_DynamicArray: t->DynamicArray.elem = elem; break;
+	case Type_Array:
+		t->Array.elem  = elem;
+		t->Array.count = count;
+		break;
+	default:
+		GB_PANIC("Unhandled interned type kind %d", kind);
+	}
 	return t;
 }
 
-gb_internal Type *alloc_type_multi_pointer(Type *elem) {
-	Type *t = alloc_type(Type_MultiPointer);
-	t->MultiPointer.elem = elem;
+gb_internal Type *alloc_type_interned(TypeKind kind, Type *elem, i64 count=0) {
+	// NOTE: the polymorphic types are modified in place whilst being specialized, so anything directly
+	// containing one stays unique (as does everything containing that in turn)
+	if (elem == nullptr || elem->kind == Type_Generic) {
+		return alloc_type_interned_internal(kind, elem, count);
+	}
+
+	u32 hash = ptr_map_hash_key(elem) ^ ptr_map_hash_key(cast(uintptr)(count*Type_Count + kind));
+	u32 cell_index = hash & (TYPE_INTERN_CELL_COUNT-1);
+	TypeInternCell *cell = &type_intern_cells[cell_index];
+
+	for (TypeInternCell *c = cell; c != nullptr; c = c->next.load(std::memory_order_acquire)) {
+		for (isize i = 0; i < TYPE_INTERN_CELL_WIDTH; i++) {
+			Type *t = c->types[i].load(std::memory_order_acquire);
+			if (t == nullptr) {
+				break;
+			}
+			if (type_intern_is_match(t, kind, elem, count)) {
+				return t;
+			}
+		}
+	}
+
+	MUTEX_GUARD(&type_intern_mutexes[cell_index & (TYPE_INTERN_MUTEX_STRIPE_COUNT-1)].m);
+
+	// NOTE: another thread may have inserted it since the lookup above
+	TypeInternCell *last = cell;
+	for (TypeInternCell *c = cell; c != nullptr; c = c->next.load(std::memory_order_relaxed)) {
+		for (isize i = 0; i < TYPE_INTERN_CELL_WIDTH; i++) {
+			Type *t = c->types[i].load(std::memory_order_relaxed);
+			if (t == nullptr) {
+				t = alloc_type_interned_internal(kind, elem, count);
+				c->types[i].store(t, std::memory_order_release);
+				return t;
+			}
+			if (type_intern_is_match(t, kind, elem, count)) {
+				return t;
+			}
+		}
+		last = c;
+	}
+
+	Type *t = alloc_type_interned_internal(kind, elem, count);
+	TypeInternCell *new_cell = permanent_alloc_item<TypeInternCell>();
+	new_cell->types[0].store(t, std::memory_order_relaxed);
+	last->next.store(new_cell, std::memory_order_release);
 	return t;
 }
 
+
+gb_internal Type *alloc_type_pointer(Type *elem) {
+	return alloc_type_interned(Type_Pointer, elem);
+}
+
+gb_internal Type *alloc_type_multi_pointer(Type *elem) {
+	return alloc_type_interned(Type_MultiPointer, elem);
+}
+
 gb_internal Type *alloc_type_soa_pointer(Type *elem) {
-	Type *t = alloc_type(Type_SoaPointer);
-	t->SoaPointer.elem = elem;
-	return t;
+	return alloc_type_interned(Type_SoaPointer, elem);
 }
 
 gb_internal Type *alloc_type_pointer_to_multi_pointer(Type *ptr) {
@@ -1081,10 +1182,14 @@ gb_internal Type *alloc_type_array(Type *elem, i64 count, Type *generic_count =
 		t->Array.generic_count = generic_count;
 		return t;
 	}
-	Type *t = alloc_type(Type_Array);
-	t->Array.elem = elem;
-	t->Array.count = count;
-	return t;
+	if (count < 0) {
+		// NOTE: the count of `[?]T` is set once the compound literal has been checked
+		Type *t = alloc_type(Type_Array);
+		t->Array.elem = elem;
+		t->Array.count = count;
+		return t;
+	}
+	return alloc_type_interned(Type_Array, elem, count);
 }
 
 gb_internal Type *alloc_type_matrix(Type *elem, i64 row_count, i64 column_count, Type *generic_row_count, Type *generic_column_count, bool is_row_major) {
@@ -1127,15 +1232,11 @@ gb_internal Type *alloc_type_enumerated_array(Type *elem, Type *index, ExactValu
 
 
 gb_internal Type *alloc_type_slice(Type *elem) {
-	Type *t = alloc_type(Type_Slice);
-	t->Slice.elem = elem;
-	return t;
+	return alloc_type_interned(Type_Slice, elem);
 }
 
 gb_internal Type *alloc_type_dynamic_array(Type *elem) {
-	Type *t = alloc_type(Type_DynamicArray);
-	t->DynamicArray.elem = elem;
-	return t;
+	return alloc_type_interned(Type_DynamicArray, elem);
 }
 
 gb_internal Type *alloc_type_fixed_capacity_dynamic_array(Type *elem, i64 capacity, Type *generic_capacity = nullptr) {
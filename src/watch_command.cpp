@@ -0,0 +1,234 @@
+/*
+	`odin build <dir> -watch` and `odin check <dir> -watch` rebuild whenever a file of the program changes.
+
+	The process start up and the universal initialization are only done once by the watcher, and each
+	rebuild is done within a fork of it, as the parser and checker are not reentrant. The rebuild reports
+	the files it read back through a pipe, and the directories containing them are watched with inotify;
+	watching the directories rather than the files also notices new files and editors which save by
+	replacing the file. The work which does not depend upon the changed packages is reused through the
+	caches: the AST snapshots, the package summaries (check), and the per-module objects (build).
+*/
+
+#if defined(GB_SYSTEM_LINUX)
+	#include <poll.h>
+	#include <sys/inotify.h>
+	#include <sys/wait.h>
+
+gb_global int watch_report_fd = -1;
+
+struct WatchDirectory {
+	int    wd;
+	String path;
+	bool   any_odin_file; // a package directory rather than the directory of a #load-ed file
+};
+
+// NOTE: Called within the rebuild to report the files it depends upon to the watcher
+gb_internal void watch_report_files(Parser *p, CheckerInfo *info) {
+	if (watch_report_fd < 0) {
+		return;
+	}
+
+	// NOTE: each path is prefixed by whether it is a package file ('p') or a #load-ed file ('l')
+	auto buf = array_make<u8>(heap_allocator(), 0, 4096);
+	defer (array_free(&buf));
+	auto add = [&buf](char kind, String const &path) {
+		array_add(&buf, cast(u8)kind);
+		array_add_elems(&buf, path.text, path.len);
+		array_add(&buf, cast(u8)0);
+	};
+
+	if (p != nullptr) {
+		for (AstPackage *pkg : p->packages) {
+			for (AstFile *f : pkg->files) {
+				add('p', f->fullpath);
+			}
+		}
+	}
+	if (info != nullptr) {
+		for (auto const &entry : info->load_file_cache) {
+			LoadFileCache *cache = entry.value;
+			if (cache != nullptr && cache->exists) {
+				add('l', cache->path);
+			}
+		}
+	}
+
+	u8 const *ptr = buf.data;
+	isize len = buf.count;
+	while (len > 0) {
+		ssize_t n = write(watch_report_fd, ptr, len);
+		if (n <= 0) {
+			break;
+		}
+		ptr += n;
+		len -= n;
+	}
+}
+
+gb_internal void watch_add_directory(Array<WatchDirectory> *dirs, int inotify_fd, String const &dir, bool any_odin_file) {
+	for (WatchDirectory &wdir : *dirs) {
+		if (wdir.path == dir) {
+			wdir.any_odin_file |= any_odin_file;
+			return;
+		}
+	}
+	char const *dir_c = alloc_cstring(temporary_allocator(), dir);
+	u32 mask = IN_CLOSE_WRITE|IN_MOVED_TO|IN_MOVED_FROM|IN_CREATE|IN_DELETE;
+	int wd = inotify_add_watch(inotify_fd, dir_c, mask);
+	if (wd < 0) {
+		gb_printf_err("Unable to watch %.*s: %s\n", LIT(dir), strerror(errno));
+		return;
+	}
+	array_add(dirs, WatchDirectory{wd, dir, any_odin_file});
+}
+
+// NOTE: Blocks until a relevant file has changed, and then waits for the changes to settle
+gb_internal void watch_wait_for_changes(int inotify_fd, Array<WatchDirectory> const &dirs, StringSet *load_files) {
+	alignas(struct inotify_event) char buf[16*1024];
+	bool changed = false;
+	for (;;) {
+		struct pollfd pfd = {inotify_fd, POLLIN, 0};
+		// NOTE: editors usually write several files, or a single file several times, on a save
+		int timeout_ms = changed ? 100 : -1;
+		int res = poll(&pfd, 1, timeout_ms);
+		if (res < 0 && errno == EINTR) {
+			continue;
+		}
+		if (res <= 0) {
+			return;
+		}
+
+		ssize_t n = read(inotify_fd, buf, gb_size_of(buf));
+		if (n <= 0) {
+			return;
+		}
+		for (char *ptr = buf; ptr < buf+n; ) {
+			struct inotify_event const *event = cast(struct inotify_event const *)ptr;
+			ptr += gb_size_of(struct inotify_event) + event->len;
+
+			if (event->len == 0) {
+				continue;
+			}
+			String name = make_string_c(event->name);
+			for (WatchDirectory const &dir : dirs) {
+				if (dir.wd != event->wd) {
+					continue;
+				}
+				if (dir.any_odin_file && string_ends_with(name, str_lit(".odin"))) {
+					changed = true;
+				} else {
+					TEMPORARY_ALLOCATOR_GUARD();
+					String path = concatenate3_strings(temporary_allocator(), dir.path, str_lit("/"), name);
+					changed |= string_set_exists(load_files, path);
+				}
+				break;
+			}
+		}
+	}
+}
+
+// NOTE: Only returns true within a forked process, which must then do the rebuild
+gb_internal bool watch_command(String const &init_filename, int *exit_code) {
+	*exit_code = 1;
+
+	int inotify_fd = -1;
+	auto dirs = array_make<WatchDirectory>(heap_allocator(), 0, 64);
+	StringSet load_files = {};
+	string_set_init(&load_files);
+
+	String init_dir = path_to_full_path(heap_allocator(), init_filename);
+	if (!path_is_directory(init_dir)) {
+		init_dir = directory_from_path(init_dir);
+	}
+
+	// NOTE: the watched paths point into the report of the rebuild which gave them, so it is kept until
+	// a later rebuild gives a new one, and the two buffers are then swapped rather than allocated again
+	auto report         = array_make<u8>(heap_allocator(), 0, 4096);
+	auto watched_report = array_make<u8>(heap_allocator(), 0, 4096);
+
+	for (;;) {
+		int fds[2] = {};
+		if (pipe2(fds, O_CLOEXEC) != 0) {
+			gb_printf_err("Unable to create a pipe: %s\n", strerror(errno));
+			return false;
+		}
+
+		pid_t pid = fork();
+		if (pid < 0) {
+			gb_printf_err("Unable to fork: %s\n", strerror(errno));
+			return false;
+		}
+		if (pid == 0) {
+			close(fds[0]);
+			if (inotify_fd >= 0) {
+				close(inotify_fd);
+			}
+			watch_report_fd = fds[1];
+			*exit_code = 0;
+			return true;
+		}
+		close(fds[1]);
+
+		array_clear(&report);
+		for (;;) {
+			u8 chunk[4096];
+			ssize_t n = read(fds[0], chunk, gb_size_of(chunk));
+			if (n < 0 && errno == EINTR) {
+				continue;
+			}
+			if (n <= 0) {
+				break;
+			}
+			array_add_elems(&report, chunk, n);
+		}
+		close(fds[0]);
+
+		int status = 0;
+		while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+		}
+		int code = WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+
+		// NOTE: a rebuild which failed before reporting anything (e.g. on a syntax error) keeps the previous watches
+		if (report.count != 0 || inotify_fd < 0) {
+			if (inotify_fd >= 0) {
+				close(inotify_fd);
+			}
+			inotify_fd = inotify_init1(IN_CLOEXEC);
+			if (inotify_fd < 0) {
+				gb_printf_err("Unable to initialize inotify: %s\n", strerror(errno));
+				return false;
+			}
+			array_clear(&dirs);
+			string_set_clear(&load_files);
+
+			Array<u8> previous_report = watched_report;
+			watched_report = report;
+			report = previous_report;
+
+			watch_add_directory(&dirs, inotify_fd, init_dir, true);
+
+			isize start = 0;
+			for (isize i = 0; i < watched_report.count; i++) {
+				if (watched_report[i] != 0) {
+					continue;
+				}
+				if (i-start > 1) {
+					String path = make_string(watched_report.data+start+1, i-start-1);
+					bool is_load_file = watched_report[start] == 'l';
+					if (is_load_file) {
+						string_set_add(&load_files, path);
+					}
+					watch_add_directory(&dirs, inotify_fd, directory_from_path(path), !is_load_file);
+				}
+				start = i+1;
+			}
+		}
+
+		gb_printf_err("%s with exit code %d, watching %td director%s for changes...\n",
+		              code == 0 ? "Finished" : "Failed", code, dirs.count, dirs.count == 1 ? "y" : "ies");
+		watch_wait_for_changes(inotify_fd, dirs, &load_files);
+		gb_printf_err("Changes detected, rebuilding...\n");
+	}
+}
+
+#endif
@@ -0,0 +1,113 @@
+#!/usr/bin/env bash
+set -eu
+
+# Tests that the build caches are invalidated when a source file or a flag changes,
+# and that they are reused when neither has.
+
+mkdir -p build
+pushd build
+ODIN=../../../odin
+COMMON="-show-debug-messages"
+
+FAILED=0
+expect() {
+	if [[ "$1" == "$2" ]] ; then
+		echo "SUCCESSFUL $3"
+	else
+		echo "FAILED $3: expected '$2', got '$1'"
+		FAILED=1
+	fi
+}
+
+write_sources() {
+	mkdir -p src/value
+	printf 'package cache_test\n\nimport "core:fmt"\nimport "value"\n\nSCALE :: #config(SCALE, 1)\n\nmain :: proc() {\n\tfmt.println(value.get() * SCALE)\n}\n' > src/main.odin
+	set_value 1
+}
+
+set_value() {
+	printf 'package value\n\nget :: proc() -> int {\n\treturn %d\n}\n' "$1" > src/value/value.odin
+}
+
+# -internal-cached-content-hash: the executable is reused when no file has changed in content
+rm -rf src .odin-cache
+write_sources
+build() {
+	if ! $ODIN build src $COMMON -o:none -out:prog -internal-cached-content-hash "$@" > build.log 2>&1 ; then
+		cat build.log >&2
+		echo "build failed"
+		return
+	fi
+	grep -c "Cache: try_copy_executable_from_cache" build.log || true
+}
+
+expect "$(build)" 0 "content hash: first build"
+expect "$(./prog)" 1 "content hash: first build output"
+expect "$(build)" 1 "content hash: unchanged rebuild is cached"
+touch src/main.odin src/value/value.odin
+expect "$(build)" 1 "content hash: touched rebuild is cached"
+set_value 2
+expect "$(build)" 0 "content hash: edited file rebuilds"
+expect "$(./prog)" 2 "content hash: edited file output"
+expect "$(build -define:SCALE=10)" 0 "content hash: added flag rebuilds"
+expect "$(./prog)" 20 "content hash: added flag output"
+expect "$(build -define:SCALE=5)" 0 "content hash: changed flag rebuilds"
+expect "$(./prog)" 10 "content hash: changed flag output"
+expect "$(build)" 0 "content hash: removed flag rebuilds"
+expect "$(./prog)" 2 "content hash: removed flag output"
+printf 'package value\n\nOTHER :: 3\n' > src/value/other.odin
+expect "$(build)" 0 "content hash: added file rebuilds"
+
+# -internal-cached-objects: a module is reused when its own code and the code generation options are unchanged
+rm -rf src .odin-cache
+write_sources
+build_objects() {
+	if ! $ODIN build src $COMMON -o:none -out:prog -internal-cached-objects "$@" > build.log 2>&1 ; then
+		cat build.log >&2
+		echo "build failed"
+		return
+	fi
+	# NOTE: only the packages of the test are listed, as the others do not change between the builds
+	grep -E "Object Cache: miss prog-(cache_test|value) " build.log | sed -E 's/.*miss prog-([a-z_]+) .*/\1/' | sort | tr '\n' ' ' || true
+}
+
+expect "$(build_objects)" "cache_test value " "objects: first build"
+expect "$(./prog)" 1 "objects: first build output"
+expect "$(build_objects)" "" "objects: unchanged rebuild is cached"
+expect "$(grep -c "Object Cache: miss" build.log || true)" 0 "objects: unchanged rebuild reuses every module"
+set_value 2
+expect "$(build_objects)" "value " "objects: edited package rebuilds alone"
+expect "$(./prog)" 2 "objects: edited package output"
+expect "$(build_objects -define:SCALE=10)" "cache_test " "objects: changed flag rebuilds the affected package"
+expect "$(./prog)" 20 "objects: changed flag output"
+expect "$(build_objects -define:SCALE=10 -internal-fast-isel)" "cache_test value " "objects: changed code generation option rebuilds"
+expect "$(./prog)" 20 "objects: changed code generation option output"
+
+# -internal-cached-packages: the procedure bodies of a package are not checked again when neither it nor
+# the interface of anything it imports has changed, and the entities that they use are still used
+rm -rf src .odin-cache
+write_sources
+check_packages() {
+	if ! $ODIN check src $COMMON -internal-cached-packages -vet-unused-procedures -vet-packages:value "$@" > check.log 2>&1 ; then
+		grep -E "Error:" check.log | sed -E -e 's/^.*Error: //' -e 's/ +$//'
+		echo "check failed"
+		return
+	fi
+	grep -E "Package Summary: [0-9]+ of " check.log | sed -E 's/.*: ([0-9]+) of ([0-9]+) .*/\2 \1/'
+}
+
+r=$(check_packages)
+PACKAGES=${r% *}
+expect "$r" "$PACKAGES 0" "packages: first check"
+expect "$(check_packages)" "$PACKAGES $PACKAGES" "packages: unchanged check is cached"
+set_value 3
+expect "$(check_packages)" "$PACKAGES $((PACKAGES-1))" "packages: edited body checks its own package again, using what the cached bodies use"
+printf 'package value\n\nget :: proc() -> i32 {\n\treturn 4\n}\n' > src/value/value.odin
+expect "$(check_packages)" "$PACKAGES $((PACKAGES-2))" "packages: edited interface checks the importing package again"
+printf 'package value\n\nget :: proc() -> i32 {\n\treturn 4\n}\n\nunused :: proc() {}\n' > src/value/value.odin
+expect "$(check_packages)" "$(printf '%s\n' "'unused' declared but not used" "check failed")" "packages: unused procedures are still reported"
+
+popd
+rm -rf build
+
+exit $FAILED
@@ -0,0 +1,85 @@
+package test_internal
+
+import "core:testing"
+
+// NOTE: Each instantiation of a polymorphic procedure has a `@(static)` variable of its own, so the
+// number of calls made through it tells whether two call sites share the same instantiation.
+
+@(private="file")
+Distinct_Int :: distinct int
+
+@(private="file")
+Int_Alias :: int
+
+@(private="file")
+count_type_calls :: proc($T: typeid) -> int {
+	@(static) calls: int
+	calls += 1
+	return calls
+}
+
+@(private="file")
+count_value_calls :: proc(v: $T) -> int {
+	@(static) calls: int
+	calls += 1
+	return calls
+}
+
+@(private="file")
+count_constant_calls :: proc($N: int, v: $T) -> int {
+	@(static) calls: int
+	calls += 1
+	return calls
+}
+
+@test
+test_polymorphic_procedure_type_parameters :: proc(t: ^testing.T) {
+	testing.expect_value(t, count_type_calls(int),          1)
+	testing.expect_value(t, count_type_calls(int),          2)
+	testing.expect_value(t, count_type_calls(Int_Alias),    3) // an alias is the same type
+	testing.expect_value(t, count_type_calls(i32),          1)
+	testing.expect_value(t, count_type_calls(Distinct_Int), 1)
+	testing.expect_value(t, count_type_calls(uint),         1)
+
+	testing.expect_value(t, count_type_calls([4]int),    1)
+	testing.expect_value(t, count_type_calls([4]int),    2)
+	testing.expect_value(t, count_type_calls([5]int),    1)
+	testing.expect_value(t, count_type_calls([4]i32),    1)
+
+	testing.expect_value(t, count_type_calls(proc(int)),        1)
+	testing.expect_value(t, count_type_calls(proc(int)),        2)
+	testing.expect_value(t, count_type_calls(proc(int) -> int), 1)
+	testing.expect_value(t, count_type_calls(proc(i32)),        1)
+
+	testing.expect_value(t, count_type_calls(struct{x: int}), 1)
+	testing.expect_value(t, count_type_calls(struct{x: int}), 2)
+	testing.expect_value(t, count_type_calls(struct{y: int}), 1)
+}
+
+@test
+test_polymorphic_procedure_inferred_parameters :: proc(t: ^testing.T) {
+	testing.expect_value(t, count_value_calls(1),            1) // untyped integers become `int`
+	testing.expect_value(t, count_value_calls(int(2)),       2)
+	testing.expect_value(t, count_value_calls(Int_Alias(3)), 3)
+	testing.expect_value(t, count_value_calls(i32(1)),       1)
+	testing.expect_value(t, count_value_calls(1.0),          1)
+	testing.expect_value(t, count_value_calls(f64(2)),       2)
+	testing.expect_value(t, count_value_calls("str"),        1)
+	testing.expect_value(t, count_value_calls([]int{}),      1)
+	testing.expect_value(t, count_value_calls([]i32{}),      1)
+}
+
+@test
+test_polymorphic_procedure_constant_parameters :: proc(t: ^testing.T) {
+	THREE :: 3
+
+	testing.expect_value(t, count_constant_calls(3, 1),     1)
+	testing.expect_value(t, count_constant_calls(3, 2),     2) // the value of a run-time parameter does not matter
+	testing.expect_value(t, count_constant_calls(1+2, 3),   3)
+	testing.expect_value(t, count_constant_calls(THREE, 4), 4)
+	testing.expect_value(t, count_constant_calls(4, 1),     1)
+	testing.expect_value(t, count_constant_calls(-3, 1),    1)
+	testing.expect_value(t, count_constant_calls(3, 1.0),   1)
+	testing.expect_value(t, count_constant_calls(4, 1.0),   1)
+	testing.expect_value(t, count_constant_calls(4, 2.0),   2)
+}
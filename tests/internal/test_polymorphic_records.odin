@@ -0,0 +1,73 @@
+package test_internal
+
+import "core:testing"
+
+@(private="file")
+Distinct_Int :: distinct int
+
+@(private="file")
+Int_Alias :: int
+
+@(private="file")
+Box :: struct($T: typeid) {
+	value: T,
+}
+
+@(private="file")
+Fixed :: struct($N: int, $T: typeid) {
+	items: [N]T,
+}
+
+@(private="file")
+Either :: union($L, $R: typeid) {
+	L,
+	R,
+}
+
+@(private="file")
+Tagged :: struct($Tag: string) {
+	x: int,
+}
+
+@test
+test_polymorphic_record_type_parameters :: proc(t: ^testing.T) {
+	testing.expect(t, typeid_of(Box(int)) == typeid_of(Box(int)))
+	testing.expect(t, typeid_of(Box(int)) == typeid_of(Box(Int_Alias))) // an alias is the same type
+	testing.expect(t, typeid_of(Box(int)) != typeid_of(Box(i32)))
+	testing.expect(t, typeid_of(Box(int)) != typeid_of(Box(Distinct_Int)))
+	testing.expect(t, typeid_of(Box(int)) != typeid_of(Box(uint)))
+
+	testing.expect(t, typeid_of(Box([4]int)) == typeid_of(Box([4]int)))
+	testing.expect(t, typeid_of(Box([4]int)) != typeid_of(Box([5]int)))
+	testing.expect(t, typeid_of(Box(proc(int))) == typeid_of(Box(proc(int))))
+	testing.expect(t, typeid_of(Box(proc(int))) != typeid_of(Box(proc(int) -> int)))
+	testing.expect(t, typeid_of(Box(Box(int))) == typeid_of(Box(Box(int))))
+	testing.expect(t, typeid_of(Box(Box(int))) != typeid_of(Box(Box(i32))))
+
+	testing.expect(t, typeid_of(Either(int, f32)) == typeid_of(Either(int, f32)))
+	testing.expect(t, typeid_of(Either(int, f32)) != typeid_of(Either(f32, int)))
+
+	a: Box(int) = {1}
+	b: Box(Int_Alias) = a
+	testing.expect_value(t, b.value, 1)
+	testing.expect_value(t, size_of(Box(u8)),  1)
+	testing.expect_value(t, size_of(Box(u64)), 8)
+}
+
+@test
+test_polymorphic_record_constant_parameters :: proc(t: ^testing.T) {
+	THREE :: 3
+
+	testing.expect(t, typeid_of(Fixed(3, int)) == typeid_of(Fixed(3, int)))
+	testing.expect(t, typeid_of(Fixed(3, int)) == typeid_of(Fixed(1+2, int)))
+	testing.expect(t, typeid_of(Fixed(3, int)) == typeid_of(Fixed(THREE, int)))
+	testing.expect(t, typeid_of(Fixed(3, int)) != typeid_of(Fixed(4, int)))
+	testing.expect(t, typeid_of(Fixed(3, int)) != typeid_of(Fixed(0, int)))
+	testing.expect(t, typeid_of(Fixed(3, int)) != typeid_of(Fixed(3, i32)))
+	testing.expect_value(t, len(Fixed(3, int){}.items), 3)
+	testing.expect_value(t, len(Fixed(4, int){}.items), 4)
+
+	testing.expect(t, typeid_of(Tagged("a")) == typeid_of(Tagged("a")))
+	testing.expect(t, typeid_of(Tagged("a")) != typeid_of(Tagged("b")))
+	testing.expect(t, typeid_of(Tagged("a")) != typeid_of(Tagged("ab")))
+}
@@ -0,0 +1,73 @@
+#!/usr/bin/env bash
+set -eu
+
+# Tests that a large file, which is split into chunks parsed in parallel, reports the same
+# errors as it does when it is parsed by a single thread.
+
+mkdir -p build
+pushd build
+ODIN=../../../odin
+
+FAILED=0
+expect() {
+	if [[ "$1" == "$2" ]] ; then
+		echo "SUCCESSFUL $3"
+	else
+		echo "FAILED $3: expected '$2', got '$1'"
+		FAILED=1
+	fi
+}
+
+# NOTE: well over the size at which a file is parsed in parallel, with `$1` in place of the
+# declaration in the middle and `$2` appended at the end
+write_source() {
+	rm -rf src
+	mkdir -p src
+	{
+		printf 'package parser_test\n\n'
+		for i in $(seq 1 6000); do
+			if [[ $i -eq 3000 ]] ; then
+				printf '%s\n\n' "$1"
+			else
+				printf 'value_%d :: proc(x: int) -> int {\n\treturn x + %d\n}\n\n' "$i" "$i"
+			fi
+		done
+		printf 'main :: proc() {\n\t_ = value_1(1)\n}\n%s' "$2"
+	} > src/main.odin
+}
+
+# NOTE: the exit code followed by the errors
+check() {
+	local code=0
+	$ODIN check src -thread-count:"$1" > check.log 2>&1 || code=$?
+	echo "$code"
+	grep -E "Error:|Syntax Error:" check.log || true
+}
+
+compare() {
+	local single parallel
+	single=$(check 1)
+	parallel=$(check 8)
+	expect "$(head -n 1 <<< "$parallel")" "$2" "$1: exit code"
+	expect "$parallel" "$single" "$1: same errors as a single thread"
+}
+
+write_source 'value_3000 :: proc(x: int) -> int { return x }' ''
+compare "no errors" 0
+
+write_source 'value_3000 :: proc(x: int) -> int { y := ; return x }' ''
+compare "error within a chunk" 1
+
+write_source 'value_3000 :: proc(x: int) -> int { return (x }' ''
+compare "declaration spanning a chunk boundary" 1
+
+write_source 'value_3000 :: proc(x: int) -> int { return x }' 'unfinished :: proc() {'
+compare "unexpected end of file" 1
+
+write_source 'value_3000 :: proc(x: int) -> int { y := ; return x }' 'unfinished :: proc() {'
+compare "error within a chunk and an unexpected end of file" 1
+
+popd
+rm -rf build
+
+exit $FAILED
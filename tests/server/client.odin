@@ -0,0 +1,70 @@
+// Sends a single request to `odin server` and prints its output, exiting with the exit code of the request
+package test_server_client
+
+import "core:fmt"
+import "core:os"
+import "core:strconv"
+import "core:strings"
+import "core:sys/posix"
+
+main :: proc() {
+	if len(os.args) < 4 {
+		fmt.eprintln("Usage: client <socket path> <working directory> <arguments>...")
+		os.exit(2)
+	}
+
+	fd := posix.socket(.UNIX, .STREAM)
+	if fd == -1 {
+		fmt.eprintln("Unable to create socket:", posix.strerror())
+		os.exit(2)
+	}
+
+	addr: posix.sockaddr_un
+	addr.sun_family = .UNIX
+	copy(addr.sun_path[:len(addr.sun_path)-1], os.args[1])
+	if posix.connect(fd, (^posix.sockaddr)(&addr), size_of(addr)) != .OK {
+		fmt.eprintln("Unable to connect:", posix.strerror())
+		os.exit(2)
+	}
+
+	// NOTE: the working directory followed by the arguments, each terminated by a NUL byte, and then an extra NUL byte
+	request: strings.Builder
+	for arg in os.args[2:] {
+		strings.write_string(&request, arg)
+		strings.write_byte(&request, 0)
+	}
+	strings.write_byte(&request, 0)
+	for data := request.buf[:]; len(data) > 0; {
+		n := posix.write(fd, raw_data(data), uint(len(data)))
+		if n <= 0 {
+			fmt.eprintln("Unable to send the request:", posix.strerror())
+			os.exit(2)
+		}
+		data = data[n:]
+	}
+
+	response: [dynamic]byte
+	for {
+		chunk: [4096]byte
+		n := posix.read(fd, raw_data(chunk[:]), len(chunk))
+		if n <= 0 {
+			break
+		}
+		append(&response, ..chunk[:n])
+	}
+	posix.close(fd)
+
+	// NOTE: the output of the command, a NUL byte, and then the exit code in decimal
+	sep := strings.last_index_byte(string(response[:]), 0)
+	if sep < 0 {
+		fmt.eprintln("No response")
+		os.exit(2)
+	}
+	code, ok := strconv.parse_int(string(response[sep+1:]))
+	if !ok {
+		fmt.eprintln("Invalid exit code:", string(response[sep+1:]))
+		os.exit(2)
+	}
+	os.write(os.stdout, response[:sep])
+	os.exit(code)
+}
@@ -0,0 +1,152 @@
+#!/usr/bin/env bash
+set -eu
+
+# Tests the requests served by `odin server`, and that its sessions reuse the parsed and checked
+# packages: nothing is parsed or checked again for an unchanged program, and an edited file is
+# parsed again alone, with only the packages it affects being checked again.
+
+mkdir -p build
+pushd build
+ODIN=../../../odin
+SOCKET="$PWD/odin.sock"
+
+FAILED=0
+expect() {
+	if [[ "$1" == "$2" ]] ; then
+		echo "SUCCESSFUL $3"
+	else
+		echo "FAILED $3: expected '$2', got '$1'"
+		FAILED=1
+	fi
+}
+
+rm -rf src client
+$ODIN build ../client.odin -file -o:none -out:client
+
+write_sources() {
+	mkdir -p src/value
+	printf 'package server_test\n\nimport "core:fmt"\nimport "value"\n\nmain :: proc() {\n\tfmt.println(value.get())\n}\n' > src/main.odin
+	set_value 'int' 1
+}
+
+set_value() {
+	printf 'package value\n\nget :: proc() -> %s {\n\treturn %s\n}\n' "$1" "$2" > src/value/value.odin
+}
+
+# NOTE: prints the exit code of the request followed by its output
+request() {
+	local code=0
+	./client "$SOCKET" "$PWD" "$@" > request.log 2>&1 || code=$?
+	echo "$code"
+	cat request.log
+}
+
+# NOTE: the messages of the server and the package summaries, without the full paths and the summaries kept
+messages() {
+	grep -E "^\[DEBUG\] (Server|Package Summary): " | grep -v "Package Summary: keeping" | sed -E -e 's/^\[DEBUG\] //' -e "s#$PWD/##g" || true
+}
+
+write_sources
+$ODIN server "$SOCKET" > server.log 2>&1 &
+SERVER=$!
+trap 'kill $SERVER 2>/dev/null || true' EXIT
+for _ in $(seq 1 100); do
+	[[ -S "$SOCKET" ]] && break
+	sleep 0.1
+done
+
+# The protocol: the output, a NUL byte, and the exit code
+expect "$(request run src -o:none -out:prog)" "$(printf '0\n1')" "protocol: output and exit code of a request"
+expect "$(request check src -no-such-flag | head -n 1)" 1 "protocol: exit code of a failed request"
+expect "$(request "" | head -n 1)" 2 "protocol: a malformed request is closed without a response"
+expect "$(request check missing | head -n 1)" 1 "protocol: exit code of a missing package"
+expect "$(request run src -o:none -out:prog)" "$(printf '0\n1')" "protocol: the server still serves requests"
+
+# The sessions: the first request of a session parses and checks everything, the next ones reuse it
+CHECK="check src -show-debug-messages"
+r=$(request $CHECK)
+expect "$(head -n 1 <<< "$r")" 0 "session: first check"
+PACKAGES=$(messages <<< "$r" | sed -n -E 's/^Server: keeping ([0-9]+) parsed packages$/\1/p')
+expect "$(messages <<< "$r")" "$(printf '%s\n' \
+	"Server: keeping $PACKAGES parsed packages" \
+	"Package Summary: 0 of $PACKAGES packages unchanged")" "session: first check keeps the parsed packages"
+
+r=$(request $CHECK)
+expect "$(head -n 1 <<< "$r")" 0 "session: unchanged check"
+expect "$(messages <<< "$r")" "Server: reusing the checked packages" "session: unchanged check reuses the checked packages"
+
+touch src/main.odin src/value/value.odin
+expect "$(request $CHECK | messages)" "Server: reusing the checked packages" "session: touched files are not parsed again"
+
+set_value 'int' 2
+r=$(request $CHECK)
+expect "$(head -n 1 <<< "$r")" 0 "session: edited body"
+expect "$(messages <<< "$r")" "$(printf '%s\n' \
+	"Server: parsing 1 changed files" \
+	"Server: reusing the parsed packages" \
+	"Package Summary: source changed for src/value" \
+	"Package Summary: $((PACKAGES-1)) of $PACKAGES packages unchanged")" "session: an edited body only checks its own package again"
+
+expect "$(request $CHECK | messages)" "Server: reusing the checked packages" "session: checked packages are kept again after an edit"
+
+set_value 'i32' 3
+r=$(request $CHECK)
+expect "$(head -n 1 <<< "$r")" 0 "session: edited interface"
+expect "$(messages <<< "$r")" "$(printf '%s\n' \
+	"Server: parsing 1 changed files" \
+	"Server: reusing the parsed packages" \
+	"Package Summary: source changed for src/value" \
+	"Package Summary: src is stale" \
+	"Package Summary: $((PACKAGES-2)) of $PACKAGES packages unchanged")" "session: an edited interface also checks the packages importing it again"
+
+printf 'package value\n\nget :: proc() -> int {\n\treturn 4\n' > src/value/value.odin
+r=$(request $CHECK)
+expect "$(head -n 1 <<< "$r")" 1 "session: syntax error"
+expect "$(grep -c "Syntax Error:" <<< "$r")" 1 "session: syntax error is reported"
+expect "$(messages <<< "$r")" "Server: parsing 1 changed files" "session: syntax error keeps the session"
+
+# NOTE: large enough to be parsed in chunks, which hold their errors back for the session too
+{
+	printf 'package value\n\nget :: proc() -> int {\n\treturn 4\n}\n\n'
+	for i in $(seq 1 6000); do
+		printf 'value_%d :: proc(x: int) -> int {\n\treturn x + %d\n}\n\n' "$i" "$i"
+	done
+	printf 'unfinished :: proc() {\n'
+} > src/value/value.odin
+r=$(request $CHECK)
+expect "$(head -n 1 <<< "$r")" 1 "session: syntax error in a large file"
+expect "$(grep -c "Syntax Error:" <<< "$r")" 1 "session: syntax error in a large file is reported"
+expect "$(messages <<< "$r")" "Server: parsing 1 changed files" "session: syntax error in a large file keeps the session"
+
+set_value 'int' 5
+r=$(request $CHECK)
+expect "$(head -n 1 <<< "$r")" 0 "session: fixed syntax error"
+expect "$(messages <<< "$r" | head -n 2)" "$(printf '%s\n' \
+	"Server: parsing 1 changed files" \
+	"Server: reusing the parsed packages")" "session: fixed syntax error reuses the parsed packages"
+
+printf 'package value\n\nOTHER :: 6\n' > src/value/other.odin
+r=$(request $CHECK)
+expect "$(head -n 1 <<< "$r")" 0 "session: added file"
+expect "$(messages <<< "$r" | head -n 1)" "Server: keeping $PACKAGES parsed packages" "session: an added file starts the session again"
+rm src/value/other.odin
+
+# A session runs the program built from the edited files
+expect "$(request run src -o:none -out:prog)" "$(printf '0\n5')" "session: run after an edit"
+set_value 'int' 7
+expect "$(request run src -o:none -out:prog)" "$(printf '0\n7')" "session: run of an edited file"
+
+kill $SERVER
+wait $SERVER 2>/dev/null || true
+trap - EXIT
+# NOTE: the sessions exit once the server has closed their sockets
+for _ in $(seq 1 50); do
+	pgrep -f "server $SOCKET" > /dev/null || break
+	sleep 0.1
+done
+expect "$(pgrep -f "server $SOCKET" | wc -l | tr -d ' ')" 0 "server: no processes are left once it has exited"
+
+popd
+rm -rf build
+
+exit $FAILED